@@ -15,26 +15,36 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <nike/batch.hpp>
+#include <nike/compositional.hpp>
 #include <nike/core.hpp>
 #include <nike/core_base.hpp>
 #include <nike/multithreaded.hpp>
 #include <nike/parser/driver.hpp>
+#include <nike/supervisor.hpp>
 #include <sstream>
 
 #include <CLI/CLI.hpp>
 #include <string>
+#include <thread>
 
 int main(int argc, char **argv) {
   CLI::App app{"A tool for DPLL-based forward LTLf synthesis."};
 
   bool no_empty = false;
-  app.add_flag("-n,--no-empty", no_empty, "Enforce non-empty semantics.");
+  CLI::Option *no_empty_opt =
+      app.add_flag("-n,--no-empty", no_empty, "Enforce non-empty semantics.");
   bool version = false;
   app.add_flag("-V,--version", version, "Print the version and exit.");
   bool verbose = false;
   app.add_flag("-v,--verbose", verbose, "Set verbose mode.");
   bool multithreaded = false;
-  app.add_flag("-t,--multithreaded", multithreaded, "Multithreaded mode.");
+  CLI::Option *multithreaded_opt = app.add_flag(
+      "-t,--multithreaded", multithreaded, "Multithreaded mode.");
+  bool compositional = false;
+  CLI::Option *compositional_opt = app.add_flag(
+      "-c,--compositional", compositional,
+      "Decompose top-level conjunctions into independent sub-games.");
   bool disable_one_step_realizability = false;
   app.add_flag("--disable-one-step-realizability",
                disable_one_step_realizability,
@@ -43,6 +53,10 @@ int main(int argc, char **argv) {
   app.add_flag("--disable-one-step-unrealizability",
                disable_one_step_unrealizability,
                "Disable one-step unrealizability.");
+  bool simplify = false;
+  app.add_flag("--simplify", simplify,
+               "Rewrite the formulas with the simplification rules as they "
+               "are built.");
 
   std::map<std::string, nike::core::StateEquivalenceMode> map{
       {nike::core::mode_to_string(nike::core::StateEquivalenceMode::BDD),
@@ -79,12 +93,81 @@ int main(int argc, char **argv) {
   CLI::Option *file_opt =
       app.add_option("-f,--file", filename, "File to formula.")
           ->check(CLI::ExistingFile);
+  std::string manifest_file;
+  CLI::Option *batch_opt =
+      app.add_option("-b,--batch", manifest_file,
+                     "Manifest of (formula file, partition file) pairs. "
+                     "Results are printed as JSON lines.")
+          ->check(CLI::ExistingFile);
+  std::string preprocessed_file;
+  CLI::Option *preprocessed_opt =
+      app.add_option("--preprocessed", preprocessed_file,
+                     "Formula preprocessed by --save-preprocessed, used as "
+                     "saved, without parsing nor preprocessing it again.")
+          ->check(CLI::ExistingFile);
   formula_opt->excludes(file_opt);
   file_opt->excludes(formula_opt);
   format->add_option(formula_opt);
   format->add_option(file_opt);
+  format->add_option(batch_opt);
+  format->add_option(preprocessed_opt);
   format->require_option(1, 1);
 
+  size_t nb_workers = std::max(1u, std::thread::hardware_concurrency());
+  app.add_option("-w,--workers", nb_workers,
+                 "Number of worker threads in batch mode.")
+      ->check(CLI::PositiveNumber);
+  bool supervisor = false;
+  app.add_flag("--supervisor", supervisor,
+               "In batch mode, solve every instance in a forked worker "
+               "process rather than a thread.");
+  size_t memory_limit_mb = 0;
+  app.add_option("--memory-limit", memory_limit_mb,
+                 "In supervisor mode, the resident memory limit of each "
+                 "worker process, in MB (0 for no limit).");
+
+  size_t nb_prefetch_threads = 0;
+  app.add_option("--prefetch-threads", nb_prefetch_threads,
+                 "Number of helper threads that check successor states ahead "
+                 "of the search (0 to disable).");
+
+  size_t nb_preprocessing_threads = 1;
+  app.add_option("--preprocessing-threads", nb_preprocessing_threads,
+                 "Number of threads for the preprocessing of the top-level "
+                 "conjuncts.")
+      ->check(CLI::PositiveNumber);
+
+  size_t gc_threshold = nike::core::ForwardSynthesis::default_gc_threshold;
+  app.add_option("--gc-threshold", gc_threshold,
+                 "Number of formulas in memory above which the unreferenced "
+                 "ones are freed during the search (0 to disable).");
+
+  bool aig_branching = false;
+  app.add_flag("--aig", aig_branching,
+               "Branch on the variables of the states in and-inverter "
+               "graphs instead of PL formulas.");
+
+  bool flat_passes = false;
+  app.add_flag("--flat", flat_passes,
+               "Compute the size of the states and check whether they are "
+               "accepting on flat post-order layouts of their formulas.");
+
+  std::string save_preprocessed_file;
+  CLI::Option *save_preprocessed_opt = app.add_option(
+      "--save-preprocessed", save_preprocessed_file,
+      "Save the formula and its preprocessing (NNF, XNF and closure) to a "
+      "binary file, to be reused with --preprocessed. With --no-empty, the "
+      "saved formula has non-empty semantics.");
+
+  // every instance of a batch is solved by a single search
+  multithreaded_opt->excludes(batch_opt);
+  compositional_opt->excludes(batch_opt);
+  save_preprocessed_opt->excludes(batch_opt);
+  // a preprocessed formula is solved as saved, by a single search
+  no_empty_opt->excludes(preprocessed_opt);
+  multithreaded_opt->excludes(preprocessed_opt);
+  compositional_opt->excludes(preprocessed_opt);
+
   std::string part_file;
   CLI::Option *part_opt = app.add_option("--part", part_file, "Partition file.")
                               ->check(CLI::ExistingFile);
@@ -107,23 +190,74 @@ int main(int argc, char **argv) {
   //    nike::utils::Logger::level(nike::utils::LogLevel::debug);
   //  }
 
-  auto driver = nike::parser::ltlf::LTLfDriver();
-  if (!file_opt->empty()) {
-    logger.info("Parsing {}", filename);
-    driver.parse(filename.c_str());
-  } else {
-    std::stringstream formula_stream(formula);
-    logger.info("Parsing {}", formula);
-    driver.parse(formula_stream);
+  if (!batch_opt->empty()) {
+    nike::core::BatchOptions options;
+    options.nb_workers = nb_workers;
+    options.bs = branching_strategy_id;
+    options.mode = mode;
+    options.no_empty = no_empty;
+    options.disable_one_step_realizability = disable_one_step_realizability;
+    options.disable_one_step_unrealizability = disable_one_step_unrealizability;
+    options.simplify = simplify;
+    options.nb_preprocessing_threads = nb_preprocessing_threads;
+    options.nb_prefetch_threads = nb_prefetch_threads;
+    options.gc_threshold = gc_threshold;
+    options.aig_branching = aig_branching;
+    options.flat_passes = flat_passes;
+    logger.info("Reading manifest file {}", manifest_file);
+    auto instances = nike::core::read_manifest_from_file(manifest_file);
+    if (supervisor) {
+      nike::core::SupervisorOptions supervisor_options;
+      supervisor_options.batch = options;
+      supervisor_options.memory_limit_mb = memory_limit_mb;
+      nike::core::Supervisor(instances, supervisor_options).run(std::cout);
+      return 0;
+    }
+    auto batch = nike::core::BatchSynthesis(instances, options);
+    batch.run(std::cout);
+    return 0;
   }
 
-  auto parsed_formula = driver.get_result();
-  if (no_empty) {
-    logger.info("Apply no-empty semantics.");
-    auto context = driver.context;
-    auto end = context->make_end();
-    auto not_end = context->make_not(end);
-    parsed_formula = context->make_and({parsed_formula, not_end});
+  auto driver = nike::parser::ltlf::LTLfDriver();
+  driver.context->set_simplification(simplify);
+  nike::logic::ltlf_ptr parsed_formula;
+  std::shared_ptr<const nike::core::FrozenFormula> frozen_formula;
+  try {
+    if (!preprocessed_opt->empty()) {
+      logger.info("Reading preprocessed formula {}", preprocessed_file);
+      frozen_formula = nike::core::read_frozen_formula(*driver.context,
+                                                       preprocessed_file);
+      parsed_formula = frozen_formula->formula;
+    } else {
+      if (!file_opt->empty()) {
+        logger.info("Parsing {}", filename);
+        driver.parse(filename.c_str());
+      } else {
+        std::stringstream formula_stream(formula);
+        logger.info("Parsing {}", formula);
+        driver.parse(formula_stream);
+      }
+      parsed_formula = driver.get_result();
+      if (no_empty) {
+        logger.info("Apply no-empty semantics.");
+        auto context = driver.context;
+        auto end = context->make_end();
+        auto not_end = context->make_not(end);
+        parsed_formula = context->make_and({parsed_formula, not_end});
+      }
+    }
+    if (!save_preprocessed_file.empty()) {
+      if (frozen_formula == nullptr) {
+        frozen_formula = std::make_shared<const nike::core::FrozenFormula>(
+            parsed_formula, nb_preprocessing_threads);
+      }
+      logger.info("Saving preprocessed formula to {}", save_preprocessed_file);
+      nike::core::write_frozen_formula(save_preprocessed_file,
+                                       *frozen_formula);
+    }
+  } catch (std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
   }
 
   logger.info("Reading partition file {}", part_file);
@@ -141,15 +275,33 @@ int main(int argc, char **argv) {
         nike::core::branching_strategy_to_string(branching_strategy_id));
     result = nike::core::is_realizable<nike::core::MultithreadedSynthesis>(
         parsed_formula, partition);
+  } else if (compositional) {
+    logger.info("Using compositional synthesis");
+    result = nike::core::is_realizable<nike::core::CompositionalSynthesis>(
+        parsed_formula, partition, branching_strategy_id, mode);
   } else {
     logger.info("Using synthesis mode '{}'", nike::core::mode_to_string(mode));
     logger.info("Using branching strategy '{}'",
                 branching_strategy_to_string(branching_strategy_id));
 
-    result = nike::core::is_realizable<nike::core::ForwardSynthesis>(
-        parsed_formula, partition, branching_strategy_id, mode, run_name,
-        disable_one_step_realizability = disable_one_step_realizability,
-        disable_one_step_unrealizability = disable_one_step_unrealizability);
+    auto synthesis =
+        frozen_formula != nullptr
+            ? nike::core::ForwardSynthesis(
+                  frozen_formula, partition, branching_strategy_id, mode,
+                  run_name, disable_one_step_realizability,
+                  disable_one_step_unrealizability)
+            : nike::core::ForwardSynthesis(
+                  parsed_formula, partition, branching_strategy_id, mode,
+                  run_name, disable_one_step_realizability,
+                  disable_one_step_unrealizability, 3.0, nullptr,
+                  nb_preprocessing_threads);
+    // no other search shares the context
+    synthesis.set_shares_ast_manager(false);
+    synthesis.set_prefetch_threads(nb_prefetch_threads);
+    synthesis.set_gc_threshold(gc_threshold);
+    synthesis.set_aig_branching(aig_branching);
+    synthesis.set_flat_passes(flat_passes);
+    result = synthesis.is_realizable();
   }
 
   if (result)
@@ -0,0 +1,164 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch.hpp>
+#include <nike/eval.hpp>
+#include <nike/logic/replace.hpp>
+#include <nike/logic/utils.hpp>
+
+namespace nike {
+namespace core {
+namespace Benchmark {
+
+namespace {
+/*
+ * The passes as they were written with accept/visit double dispatch, kept
+ * here as a baseline.
+ */
+class VirtualEvalVisitor : public logic::Visitor {
+public:
+  bool result;
+
+  void visit(const logic::LTLfTrue &) override { result = true; }
+  void visit(const logic::LTLfFalse &) override { result = false; }
+  void visit(const logic::LTLfPropTrue &) override { result = false; }
+  void visit(const logic::LTLfPropFalse &) override { result = false; }
+  void visit(const logic::LTLfAtom &) override { result = false; }
+  void visit(const logic::LTLfPropositionalNot &) override { result = false; }
+  void visit(const logic::LTLfAnd &f) override {
+    result = std::all_of(
+        f.args.begin(), f.args.end(),
+        [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
+  }
+  void visit(const logic::LTLfOr &f) override {
+    result = std::any_of(
+        f.args.begin(), f.args.end(),
+        [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
+  }
+  void visit(const logic::LTLfNext &) override { result = false; }
+  void visit(const logic::LTLfWeakNext &) override { result = true; }
+  void visit(const logic::LTLfUntil &) override { result = false; }
+  void visit(const logic::LTLfRelease &) override { result = true; }
+  void visit(const logic::LTLfEventually &) override { result = false; }
+  void visit(const logic::LTLfAlways &) override { result = true; }
+
+  bool apply(const logic::LTLfFormula &formula) {
+    formula.accept(*this);
+    return result;
+  }
+};
+
+class VirtualReplaceVisitor : public logic::Visitor {
+public:
+  logic::pl_ptr result;
+  std::map<logic::ast_ptr, bool, utils::Deref::Less> replacements;
+
+  void visit(const logic::PLTrue &f) override { result = f.ctx().make_true(); }
+  void visit(const logic::PLFalse &f) override {
+    result = f.ctx().make_false();
+  }
+  void visit(const logic::PLLiteral &f) override {
+    auto replacement = replacements.find(f.proposition);
+    if (replacement == replacements.end()) {
+      result = std::static_pointer_cast<const logic::PLFormula>(
+          f.shared_from_this());
+      return;
+    }
+    result = replacement->second != f.negated ? f.ctx().make_true()
+                                              : f.ctx().make_false();
+  }
+  void visit(const logic::PLAnd &f) override {
+    result = logic::forward_call_to_arguments(
+        f, [this](const logic::pl_ptr &arg) { return apply(*arg); },
+        [f](const logic::vec_pl_ptr &args) {
+          return f.ctx().make_prop_and(args);
+        });
+  }
+  void visit(const logic::PLOr &f) override {
+    result = logic::forward_call_to_arguments(
+        f, [this](const logic::pl_ptr &arg) { return apply(*arg); },
+        [f](const logic::vec_pl_ptr &args) {
+          return f.ctx().make_prop_or(args);
+        });
+  }
+
+  logic::pl_ptr apply(const logic::PLFormula &formula) {
+    formula.accept(*this);
+    return result;
+  }
+};
+
+/// disjunction of n state-like conjunctions, none of which holds at the end
+logic::ltlf_ptr state_formula(logic::Context &context, size_t n) {
+  logic::vec_ptr disjuncts;
+  for (size_t i = 0; i < n; ++i) {
+    auto a = context.make_atom("a" + std::to_string(i));
+    auto b = context.make_atom("b" + std::to_string(i));
+    disjuncts.push_back(context.make_and(
+        {context.make_weak_next(a), context.make_always(b),
+         context.make_or({context.make_next(b), a})}));
+  }
+  return context.make_or(disjuncts);
+}
+
+/// disjunction of n conjunctions of two literals
+logic::pl_ptr pl_formula(logic::Context &context, size_t n) {
+  logic::vec_pl_ptr disjuncts;
+  for (size_t i = 0; i < n; ++i) {
+    auto a = context.make_string_symbol("a" + std::to_string(i));
+    auto b = context.make_string_symbol("b" + std::to_string(i));
+    disjuncts.push_back(context.make_prop_and(
+        {context.make_literal(a, false), context.make_literal(b, true)}));
+  }
+  return context.make_prop_or(disjuncts);
+}
+} // namespace
+
+TEST_CASE("eval dispatch", "[core][benchmark][dispatch]") {
+  auto context = logic::Context();
+  auto formula = state_formula(context, 1000);
+  REQUIRE(VirtualEvalVisitor{}.apply(*formula) == eval(*formula));
+
+  BENCHMARK("virtual dispatch") {
+    return VirtualEvalVisitor{}.apply(*formula);
+  };
+  BENCHMARK("type switch") { return eval(*formula); };
+  auto flat = logic::FlatFormula(*formula);
+  REQUIRE(eval(flat) == eval(*formula));
+  BENCHMARK("flat layout") { return eval(flat); };
+  BENCHMARK("flat layout and its construction") {
+    return eval(logic::FlatFormula(*formula));
+  };
+}
+
+TEST_CASE("replace dispatch", "[core][benchmark][dispatch]") {
+  auto context = logic::Context();
+  auto formula = pl_formula(context, 1000);
+  auto symbol = context.make_string_symbol("a500");
+  auto baseline = VirtualReplaceVisitor{};
+  baseline.replacements = {{symbol, true}};
+  auto visitor = logic::ReplaceVisitor{{{symbol, true}}};
+  REQUIRE(baseline.apply(*formula) == visitor.apply(*formula));
+
+  BENCHMARK("virtual dispatch") { return baseline.apply(*formula); };
+  BENCHMARK("type switch") { return visitor.apply(*formula); };
+}
+
+} // namespace Benchmark
+} // namespace core
+} // namespace nike
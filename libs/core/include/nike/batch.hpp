@@ -0,0 +1,158 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cuddObj.hh>
+#include <functional>
+#include <istream>
+#include <nike/core.hpp>
+#include <nike/core_base.hpp>
+#include <nike/logger.hpp>
+#include <nike/logic/base.hpp>
+#include <nike/shared_verdicts.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace nike {
+namespace core {
+
+/**
+ * \brief A synthesis instance: a formula file and its partition file.
+ */
+struct BatchInstance {
+  std::string formula_file;
+  std::string partition_file;
+};
+
+enum class BatchStatus { REALIZABLE, UNREALIZABLE, ERROR, MEMOUT };
+
+std::string batch_status_to_string(BatchStatus status);
+
+/**
+ * \brief The outcome of a single instance of a batch run.
+ *
+ * Times are wall-clock milliseconds measured by the worker that solved
+ * the instance.
+ */
+struct BatchResult {
+  size_t index = 0;
+  unsigned int worker_id = 0;
+  std::string formula_file;
+  std::string partition_file;
+  BatchStatus status = BatchStatus::ERROR;
+  std::string error_message;
+  size_t nb_visited_nodes = 0;
+  double parsing_time_ms = 0.0;
+  double synthesis_time_ms = 0.0;
+  double total_time_ms = 0.0;
+};
+
+/**
+ * \brief Serialize a batch result as a single-line JSON object.
+ */
+std::string batch_result_to_json(const BatchResult &result);
+
+/**
+ * \brief Read a manifest of synthesis instances.
+ *
+ * Each non-empty line not starting with '#' contains a formula file and a
+ * partition file, separated by whitespace:
+ *   path/to/formula.ltlf path/to/formula.part
+ *
+ * \param in the manifest stream.
+ * \param base_dir the directory relative paths are resolved against.
+ * \return the instances, in manifest order.
+ */
+std::vector<BatchInstance> read_manifest(std::istream &in,
+                                         const std::string &base_dir = "");
+
+/**
+ * \brief Read a manifest from a file. Relative paths are resolved against
+ * the directory containing the manifest.
+ */
+std::vector<BatchInstance> read_manifest_from_file(const std::string &filename);
+
+struct BatchOptions {
+  size_t nb_workers = 1;
+  BranchingStrategy bs = BranchingStrategy::RANDOM;
+  StateEquivalenceMode mode = StateEquivalenceMode::HASH;
+  bool no_empty = false;
+  bool disable_one_step_realizability = false;
+  bool disable_one_step_unrealizability = false;
+  // rewrite the formulas as they are built, see logic::SimplificationRule
+  bool simplify = false;
+  // the options of each search, see the setters of ForwardSynthesis
+  size_t nb_preprocessing_threads = 1;
+  size_t nb_prefetch_threads = 0;
+  size_t gc_threshold = ForwardSynthesis::default_gc_threshold;
+  bool aig_branching = false;
+  bool flat_passes = false;
+};
+
+/**
+ * \brief Solve a single instance.
+ *
+ * The formula is parsed into the given context, and the synthesis
+ * procedure shares the given CUDD manager. Both can be reused across
+ * calls, which is what the batch workers do. Errors (missing files, parse
+ * errors, bad partitions) are reported in the result and never thrown.
+ * If a shared verdict table is given, the search reads and publishes
+ * state verdicts in it.
+ */
+BatchResult solve_batch_instance(const BatchInstance &instance,
+                                 const BatchOptions &options,
+                                 logic::Context &context,
+                                 const CUDD::Cudd &manager,
+                                 SharedVerdictTable *shared_verdicts = nullptr);
+
+/**
+ * \brief In-process solver for many synthesis instances.
+ *
+ * Instances are distributed to a pool of worker threads. Every worker owns
+ * a logic::Context and a CUDD manager that live as long as the worker, so
+ * their setup cost is paid once per worker rather than once per instance.
+ */
+class BatchSynthesis {
+public:
+  typedef std::function<void(const BatchResult &)> callback_t;
+
+  BatchSynthesis(std::vector<BatchInstance> instances, BatchOptions options);
+
+  /**
+   * \brief Solve all the instances.
+   *
+   * The callback is called once per instance, in completion order, and
+   * never concurrently.
+   */
+  void run(const callback_t &callback);
+
+  /**
+   * \brief Solve all the instances and stream the results as JSON lines.
+   */
+  void run(std::ostream &out);
+
+  const std::vector<BatchInstance> &instances() const { return instances_; }
+
+private:
+  std::vector<BatchInstance> instances_;
+  BatchOptions options_;
+  utils::Logger logger;
+};
+
+} // namespace core
+} // namespace nike
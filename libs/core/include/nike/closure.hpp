@@ -18,7 +18,8 @@
 
 #include <iostream>
 #include <map>
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/node_map.hpp>
+#include <nike/logic/traversal.hpp>
 #include <nike/utils.hpp>
 #include <set>
 #include <utility>
@@ -30,12 +31,21 @@ class Closure {
 private:
   std::vector<logic::atom_ptr> atoms;
   logic::vec_ptr from_id_to_subformula;
+  // closure index of the formulas, by node id
+  logic::NodeMap<size_t> from_node_to_id_;
   friend Closure closure(const logic::LTLfFormula &f);
+  friend Closure closure(const logic::LTLfFormula &f, size_t nb_threads);
+  friend Closure closure_of(const logic::vec_ptr &formulas);
   explicit Closure(const logic::set_ptr &formulas);
 
 public:
   Closure() = default;
   size_t get_id(const logic::ltlf_ptr &formula) const;
+  size_t get_id(const logic::LTLfFormula &formula) const;
+  /**
+   * \brief The closure indexes of several formulas, in the same order.
+   */
+  std::vector<size_t> get_ids(const logic::vec_ptr &formulas) const;
   const logic::ltlf_ptr &get_formula(size_t index) const;
   inline size_t nb_formulas() const { return from_id_to_subformula.size(); };
   inline size_t nb_atoms() const { return atoms.size(); };
@@ -45,94 +55,105 @@ public:
   std::vector<logic::atom_ptr>::const_iterator end_atoms() const;
 
   void find_atoms_();
+
+private:
+  void index_formulas_();
 };
 
-class ClosureVisitor : public logic::Visitor {
+/*
+ * Collect the closure of a formula.
+ *
+ * The closure is gathered when the subformulas are expanded; there is no
+ * result to combine. The Next of Until, Release, Eventually and Always
+ * lead back to them: a formula is only expanded the first time it is
+ * reached, which also cuts those cycles.
+ */
+class ClosureVisitor
+    : public logic::PostOrderVisitor<ClosureVisitor, logic::LTLfFormula, char> {
 private:
-  /**
-   * Insert a formula in the index, but only if it is not already present.
-   * @param formula the formula to add
-   * @return true if the formula was added (for the first time), false otherwise
-   */
-  inline bool insert_if_not_already_present_(const logic::LTLfFormula &formula);
-  inline void apply_to_binary_op_(const logic::LTLfBinaryOp &formula);
-  inline void apply_to_unary_op_(const logic::LTLfUnaryOp &formula);
+  logic::NodeSet expanded_;
+
+  inline void insert_(const logic::LTLfFormula &formula);
+  inline void push_arguments_(const logic::LTLfBinaryOp &formula);
+  template <typename FactoryFunction>
+  inline void push_suffixes_(const logic::LTLfBinaryOp &formula,
+                             FactoryFunction function);
   inline void add_end_and_not_end_(logic::Context &context);
   friend Closure closure(const logic::LTLfFormula &f);
+  friend Closure closure(const logic::LTLfFormula &f, size_t nb_threads);
+
+  void expand_(const logic::LTLfTrue &);
+  void expand_(const logic::LTLfFalse &);
+  void expand_(const logic::LTLfPropTrue &);
+  void expand_(const logic::LTLfPropFalse &);
+  void expand_(const logic::LTLfAtom &);
+  void expand_(const logic::LTLfNot &);
+  void expand_(const logic::LTLfPropositionalNot &);
+  void expand_(const logic::LTLfAnd &);
+  void expand_(const logic::LTLfOr &);
+  void expand_(const logic::LTLfImplies &);
+  void expand_(const logic::LTLfEquivalent &);
+  void expand_(const logic::LTLfXor &);
+  void expand_(const logic::LTLfNext &);
+  void expand_(const logic::LTLfWeakNext &);
+  void expand_(const logic::LTLfUntil &);
+  void expand_(const logic::LTLfRelease &);
+  void expand_(const logic::LTLfEventually &);
+  void expand_(const logic::LTLfAlways &);
 
 public:
   logic::set_ptr formulas;
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
-
-  void apply(const logic::LTLfFormula &f);
 
-  template <typename FactoryFunction>
-  inline void
-  apply_to_right_associative_binary_op_(const logic::LTLfBinaryOp &formula,
-                                        FactoryFunction function);
+  void expand(const logic::LTLfFormula &f, size_t tag);
+  char combine(const logic::LTLfFormula &, size_t, const char *) {
+    return 0;
+  }
 };
 
 Closure closure(const logic::LTLfFormula &f);
 
-inline bool ClosureVisitor::insert_if_not_already_present_(
-    const logic::LTLfFormula &formula) {
-  auto formula_ptr = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-  if (formulas.find(formula_ptr) == formulas.end()) {
-    formulas.insert(formula_ptr);
-    return true;
-  }
-  return false;
+/**
+ * \brief Compute the closure of a conjunction on several threads.
+ *
+ * The closure of a conjunction is the union of the closures of its
+ * conjuncts: each thread computes the closure of some of them, and the
+ * results are merged. The context of the formula must be thread-safe.
+ */
+Closure closure(const logic::LTLfFormula &f, size_t nb_threads);
+
+/**
+ * \brief The closure made of the given formulas, e.g. of a closure read
+ * back from a file.
+ */
+Closure closure_of(const logic::vec_ptr &formulas);
+
+inline void ClosureVisitor::insert_(const logic::LTLfFormula &formula) {
+  formulas.insert(logic::shared_from(formula));
 }
 
 inline void
-ClosureVisitor::apply_to_binary_op_(const logic::LTLfBinaryOp &formula) {
+ClosureVisitor::push_arguments_(const logic::LTLfBinaryOp &formula) {
   for (const auto &arg : formula.args) {
-    apply(*arg);
+    push(*arg);
   }
 }
 template <typename FactoryFunction>
-inline void ClosureVisitor::apply_to_right_associative_binary_op_(
-    const logic::LTLfBinaryOp &formula, FactoryFunction function) {
-  apply_to_binary_op_(formula);
-  for (auto it = formula.args.begin() + 1; it != formula.args.end() - 1; ++it) {
-    auto subformula = function(logic::vec_ptr(it, formula.args.end()));
-    apply(*subformula);
-  }
-}
 inline void
-ClosureVisitor::apply_to_unary_op_(const logic::LTLfUnaryOp &formula) {
-  auto result = insert_if_not_already_present_(formula);
-  if (result) {
-    apply(*formula.arg);
+ClosureVisitor::push_suffixes_(const logic::LTLfBinaryOp &formula,
+                               FactoryFunction function) {
+  for (auto it = formula.args.begin() + 1; it != formula.args.end() - 1; ++it) {
+    push(*function(logic::vec_ptr(it, formula.args.end())));
   }
 }
 
 void ClosureVisitor::add_end_and_not_end_(logic::Context &context) {
   auto &c = context;
   auto not_end = c.make_not_end();
-  insert_if_not_already_present_(*not_end);
-  insert_if_not_already_present_(*c.make_next(not_end));
+  insert_(*not_end);
+  insert_(*c.make_next(not_end));
   auto end = c.make_end();
-  insert_if_not_already_present_(*end);
-  insert_if_not_already_present_(*c.make_weak_next(end));
+  insert_(*end);
+  insert_(*c.make_weak_next(end));
 }
 
 } // namespace core
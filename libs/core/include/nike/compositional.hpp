@@ -0,0 +1,112 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/core_base.hpp>
+#include <nike/input_output_partition.hpp>
+#include <nike/logger.hpp>
+#include <nike/logic/types.hpp>
+#include <nike/strategy.hpp>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nike {
+namespace core {
+
+/**
+ * \brief A group of top-level conjuncts of a specification.
+ *
+ * Two conjuncts belong to the same component iff they are connected in the
+ * graph where conjuncts are linked when they share an output variable.
+ * Hence, different components have disjoint output variables.
+ */
+struct Component {
+  logic::vec_ptr conjuncts;
+  std::set<std::string> output_variables;
+  /// whether all the conjuncts are of the form G(p), p propositional
+  bool is_invariant = true;
+
+  logic::ltlf_ptr formula() const;
+};
+
+/**
+ * \brief Split a formula in NNF into components with disjoint outputs.
+ *
+ * Conjuncts that do not mention any output variable (e.g. F(tt), or
+ * constraints on the environment only) cannot be solved on their own; they
+ * are attached to the first non-invariant component (or form one, if there
+ * is none). If the formula is not a conjunction, a single component is
+ * returned.
+ */
+std::vector<Component> decompose(const logic::LTLfFormula &nnf_formula,
+                                 const InputOutputPartition &partition);
+
+/**
+ * \brief Synthesis by decomposition of conjunctive specifications.
+ *
+ * Soundness on finite traces: if any component is unrealizable, so is the
+ * whole specification. The converse does not hold in general, because the
+ * agent must satisfy every component at the same instant. It does hold
+ * when at most one component is non-invariant and every invariant
+ * component G(p) can be maintained forever by a single agent move: the
+ * agent plays the strategy of the non-invariant component, and the fixed
+ * moves of the invariants on their (disjoint) outputs.
+ *
+ * When the decomposition cannot decide realizability on its own, the
+ * components are raced against the full specification on separate
+ * threads: the first component found unrealizable, or the verdict on the
+ * full specification, wins.
+ */
+class CompositionalSynthesis : public ISynthesis {
+public:
+  CompositionalSynthesis(
+      const logic::ltlf_ptr &formula, const InputOutputPartition &partition,
+      BranchingStrategy bs = BranchingStrategy::RANDOM,
+      StateEquivalenceMode mode = StateEquivalenceMode::HASH);
+  bool is_realizable() override;
+
+  const std::vector<Component> &components() const { return components_; }
+
+  /**
+   * \brief The strategy for the whole specification, when the last call of
+   * is_realizable() found it realizable without racing the components.
+   *
+   * Its states are those of the search on the non-invariant component, or
+   * on the whole formula if it has a single component. Each move is the one
+   * of that search, completed on the outputs of the invariant components by
+   * their fixed moves. With no non-invariant component, the strategy has
+   * the single state 0.
+   */
+  const std::optional<Strategy> &strategy() const { return strategy_; }
+
+private:
+  BranchingStrategy bs_;
+  StateEquivalenceMode mode_;
+  std::vector<Component> components_;
+  std::vector<move_t> invariant_moves_;
+  std::optional<Strategy> strategy_;
+  utils::Logger logger;
+
+  bool race_(const std::vector<const Component *> &components);
+  /// the move on all the outputs, with the moves of the invariants
+  move_t complete_move_(const move_t &move) const;
+};
+
+} // namespace core
+} // namespace nike
@@ -23,8 +23,15 @@
 #include <nike/graph.hpp>
 #include <nike/input_output_partition.hpp>
 #include <nike/logger.hpp>
+#include <nike/logic/aig.hpp>
+#include <nike/logic/atom_set.hpp>
+#include <nike/logic/flat.hpp>
+#include <nike/logic/node_map.hpp>
+#include <nike/logic/size.hpp>
 #include <nike/logic/types.hpp>
 #include <nike/path.hpp>
+#include <nike/shared_verdicts.hpp>
+#include <nike/speculative.hpp>
 #include <nike/statistics.hpp>
 #include <nike/strategy.hpp>
 #include <utility>
@@ -42,15 +49,68 @@ public:
   explicit interrupted_exception() : std::exception() {}
 };
 
+/**
+ * \brief The preprocessing of a formula: its NNF, its XNF and their closure.
+ *
+ * It is immutable once built, so that several searches can share it
+ * instead of preprocessing the formula again. Searches run concurrently,
+ * e.g. the tasks of a portfolio, each search their own copy of it, in a
+ * context of their own (see copy_frozen_formula).
+ */
+class FrozenFormula {
+public:
+  logic::ltlf_ptr formula;
+  logic::ltlf_ptr nnf_formula;
+  logic::ltlf_ptr xnf_formula;
+  Closure closure;
+  size_t xnf_size = 0;
+  PreprocessingTimes times;
+
+  /**
+   * \brief Preprocess the formula, on several threads if nb_threads > 1.
+   *
+   * The context of the formula is made thread-safe for the duration of a
+   * parallel preprocessing only.
+   */
+  explicit FrozenFormula(const logic::ltlf_ptr &formula,
+                         size_t nb_threads = 1);
+  /// a preprocessing computed beforehand, e.g. read back from a file
+  FrozenFormula(logic::ltlf_ptr formula, logic::ltlf_ptr nnf_formula,
+                logic::ltlf_ptr xnf_formula, Closure closure);
+};
+
+/**
+ * \brief Write a frozen formula, with its preprocessing, in the binary
+ * format of logic::write_dag.
+ */
+void write_frozen_formula(const std::string &filename,
+                          const FrozenFormula &frozen_formula);
+/**
+ * \brief Read a frozen formula written by write_frozen_formula into the
+ * context, without preprocessing it again.
+ */
+std::shared_ptr<const FrozenFormula>
+read_frozen_formula(logic::Context &context, const std::string &filename);
+/**
+ * \brief Copy a frozen formula, with its preprocessing, into another
+ * context, e.g. the private context of a search run on its own thread.
+ *
+ * The context takes the simplification setting of the formula's context.
+ */
+std::shared_ptr<const FrozenFormula>
+copy_frozen_formula(logic::Context &context,
+                    const FrozenFormula &frozen_formula);
+
 class Context {
 public:
   logic::ltlf_ptr formula;
   InputOutputPartition partition;
   logic::Context *ast_manager;
   std::unique_ptr<OneStepRealizabilityChecker> realizability_checker;
+  std::shared_ptr<const FrozenFormula> frozen_formula;
   logic::ltlf_ptr nnf_formula;
   logic::ltlf_ptr xnf_formula;
-  Closure closure_;
+  const Closure &closure_;
   CUDD::Cudd manager_;
   Statistics statistics_;
   Graph graph;
@@ -58,9 +118,21 @@ public:
   Path path;
   std::map<std::string, size_t> prop_to_id;
   std::map<size_t, bool> discovered;
+  // the formulas of the states in discovered, which is keyed by their ids:
+  // freed and built again, a state would get a new id and be searched again
+  logic::NodeMap<logic::ltlf_ptr> state_formulas;
   std::set<long> loop_tags;
   std::map<long, logic::ltlf_ptr> sdd_node_id_to_formula;
-  std::map<logic::ltlf_ptr, CUDD::BDD> formula_to_bdd_node;
+  logic::NodeMap<CUDD::BDD> formula_to_bdd_node;
+  // sizes of the state formulas, shared across states
+  logic::SizeVisitor size_visitor;
+  // symbols of the propositional formulas met while branching
+  logic::AtomSetVisitor atom_sets;
+  // indices of the symbols of the output and of the input variables; the
+  // symbols are kept alive, so that their indices do not change
+  std::vector<logic::ast_ptr> variable_symbols;
+  logic::AtomSet controllable_symbols;
+  logic::AtomSet uncontrollable_symbols;
   utils::Logger logger;
   size_t indentation = 0;
   std::vector<int> controllable_map;
@@ -72,12 +144,39 @@ public:
   bool stopped = false;
   bool disable_one_step_realizability = false;
   bool disable_one_step_unrealizability = false;
+  size_t nb_preprocessing_threads = 1;
+  // the logic context is shared with other searches: its garbage is not
+  // collected, since they may hold formulas by reference only
+  bool shares_ast_manager = false;
+  // the propositional formulas of the states on the current path, when the
+  // search branches on AIGs
+  bool aig_branching = false;
+  logic::Aig aig;
+  // the size and zero-step checks of the states run on their flat layouts,
+  // cached per state formula until the next garbage collection
+  bool flat_passes = false;
+  logic::NodeMap<logic::FlatFormula> flat_formulas;
+  PreprocessingTimes preprocessing_times;
   Context(const logic::ltlf_ptr &formula, const InputOutputPartition &partition,
           BranchingStrategy bs, StateEquivalenceMode mode,
           double max_size_factor = 3.0,
           std::string logger_section_name = "nike",
           bool disable_one_step_realizability = false,
-          bool disable_one_step_unrealizability = false);
+          bool disable_one_step_unrealizability = false,
+          const CUDD::Cudd *manager = nullptr,
+          size_t nb_preprocessing_threads = 1);
+  /**
+   * \brief A search on a formula preprocessed beforehand, possibly shared
+   * with other searches.
+   */
+  Context(std::shared_ptr<const FrozenFormula> frozen_formula,
+          const InputOutputPartition &partition, BranchingStrategy bs,
+          StateEquivalenceMode mode, double max_size_factor = 3.0,
+          std::string logger_section_name = "nike",
+          bool disable_one_step_realizability = false,
+          bool disable_one_step_unrealizability = false,
+          const CUDD::Cudd *manager = nullptr,
+          size_t nb_preprocessing_threads = 1);
   ~Context() = default;
 
   template <typename Arg1, typename... Args>
@@ -91,6 +190,15 @@ public:
 
   void initialie_maps_();
   void reset();
+  /// keep the formula of a state alive across garbage collections
+  void keep_state(const logic::ltlf_ptr &formula) {
+    if (formula->has_id()) {
+      state_formulas[*formula] = formula;
+    }
+  }
+  /// the flat layout of a state formula, built on the first request; the
+  /// reference is valid until the next request
+  const logic::FlatFormula &flat_formula(const logic::LTLfFormula &formula);
 
 private:
   static std::map<std::string, size_t>
@@ -107,7 +215,9 @@ public:
                    std::string logger_section_name = "nike",
                    bool disable_one_step_realizability = false,
                    bool disable_one_step_unrealizability = false,
-                   double max_size_factor = 3.0)
+                   double max_size_factor = 3.0,
+                   const CUDD::Cudd *manager = nullptr,
+                   size_t nb_preprocessing_threads = 1)
       : ISynthesis(formula, partition),
         context_{formula,
                  partition,
@@ -116,8 +226,100 @@ public:
                  max_size_factor,
                  std::move(logger_section_name),
                  disable_one_step_realizability,
-                 disable_one_step_unrealizability} {};
+                 disable_one_step_unrealizability,
+                 manager,
+                 nb_preprocessing_threads} {};
+  /**
+   * \brief A search on a frozen formula, in the logic context of the
+   * formula.
+   *
+   * The preprocessing is not repeated, and the logic context is not
+   * garbage collected unless set_shares_ast_manager(false) says that the
+   * search owns it.
+   */
+  ForwardSynthesis(std::shared_ptr<const FrozenFormula> frozen_formula,
+                   const InputOutputPartition &partition,
+                   BranchingStrategy bs = BranchingStrategy::RANDOM,
+                   StateEquivalenceMode mode = StateEquivalenceMode::HASH,
+                   std::string logger_section_name = "nike",
+                   bool disable_one_step_realizability = false,
+                   bool disable_one_step_unrealizability = false,
+                   double max_size_factor = 3.0,
+                   const CUDD::Cudd *manager = nullptr)
+      : ISynthesis(frozen_formula->formula, partition),
+        context_{std::move(frozen_formula),
+                 partition,
+                 bs,
+                 mode,
+                 max_size_factor,
+                 std::move(logger_section_name),
+                 disable_one_step_realizability,
+                 disable_one_step_unrealizability,
+                 manager} {};
   bool is_realizable() override;
+  const Statistics &statistics() const { return context_.statistics_; }
+  const PreprocessingTimes &preprocessing_times() const {
+    return context_.preprocessing_times;
+  }
+  /// the moves found by the last search, by state id
+  const Strategy &strategy() const { return context_.strategy; }
+  /**
+   * \brief Run the local checks on successor states on helper threads,
+   * ahead of the search. Zero (the default) disables the prefetching.
+   *
+   * Only the states with at most max_prefetched_env_variables env
+   * variables have their successors prefetched, since there are two to
+   * the power of that number of them.
+   */
+  void set_prefetch_threads(size_t nb_threads) {
+    nb_prefetch_threads_ = nb_threads;
+  }
+  /**
+   * \brief Read and publish state verdicts in a table shared with other
+   * searches, possibly in other processes. The table must outlive the
+   * search; nullptr disables the sharing.
+   *
+   * The verdicts carry no move: the strategy then has no move for the
+   * states decided by a verdict of another search, nor for the states
+   * reached from them, and is incomplete.
+   */
+  void set_shared_verdicts(SharedVerdictTable *table);
+  /**
+   * \brief Free the unreferenced formulas of the logic context during the
+   * search, whenever it holds more than this number of nodes. The
+   * threshold then grows to twice the number of surviving nodes. Zero
+   * disables the collection.
+   *
+   * The formulas of the states met by the search are kept, so that their
+   * ids, and thus their results, stay valid: only the intermediate
+   * formulas are freed.
+   */
+  void set_gc_threshold(size_t nb_nodes) {
+    gc_threshold_ = nb_nodes;
+    next_gc_ = nb_nodes;
+  }
+  /**
+   * \brief Whether other searches use the logic context concurrently, in
+   * which case its garbage is never collected. True by default for a
+   * search on a frozen formula, false otherwise.
+   */
+  void set_shares_ast_manager(bool value) {
+    context_.shares_ast_manager = value;
+  }
+  /**
+   * \brief Branch on the variables of a state in an and-inverter graph,
+   * cofactored in place, instead of rewriting its PL formula for every
+   * assignment. False by default.
+   */
+  void set_aig_branching(bool value) { context_.aig_branching = value; }
+  /**
+   * \brief Compute the size of the states and check whether they are
+   * accepting on their flat layouts, instead of visiting their nodes.
+   * False by default.
+   */
+  void set_flat_passes(bool value) { context_.flat_passes = value; }
+  static constexpr size_t default_gc_threshold = size_t(1) << 20;
+  static constexpr size_t max_prefetched_env_variables = 4;
   void register_termination_callback(DD_THFP callback,
                                      void *callback_arg) const;
   void stop();
@@ -125,6 +327,13 @@ public:
 
 private:
   Context context_;
+  size_t nb_prefetch_threads_ = 0;
+  std::unique_ptr<SpeculativePrefetcher> prefetcher_;
+  SharedVerdictTable *shared_verdicts_ = nullptr;
+  std::unique_ptr<StructuralFingerprint> fingerprint_;
+  size_t gc_threshold_ = default_gc_threshold;
+  size_t next_gc_ = default_gc_threshold;
+  void collect_garbage_();
   size_t get_state_id(const logic::ltlf_ptr &formula);
 
   long get_bdd_id(CUDD::BDD node) {
@@ -133,15 +342,37 @@ private:
 
   inline void check_stopped();
   bool forward_synthesis_();
+  std::optional<bool> root_checks_();
   bool ids_forward_synthesis_();
   bool system_move_(const logic::ltlf_ptr &formula);
-  bool env_move_(const logic::pl_ptr &pl_formula);
-  bool find_env_move_(const logic::pl_ptr &pl_formula);
+  StateVerdict state_verdict_(const logic::ltlf_ptr &formula);
+  void share_verdict_(const logic::ltlf_ptr &formula, bool is_realizable);
   void backprop_success(size_t &node_id, NodeType node_type);
-  logic::ltlf_ptr next_state_formula_(const logic::pl_ptr &pl_formula);
+
+  // the branching on the variables of a state works on its propositional
+  // formula, either a PL formula or an edge of the AIG of the context
+  template <typename Prop> bool env_move_(const Prop &pl_formula);
+  template <typename Prop> bool find_env_move_(const Prop &pl_formula);
+  template <typename Prop>
+  bool speculative_env_move_(const Prop &pl_formula);
+  template <typename Prop>
+  void
+  enumerate_env_successors_(const Prop &pl_formula,
+                            std::vector<logic::ltlf_ptr> &next_state_formulas);
+  template <typename Prop>
+  logic::ltlf_ptr next_state_formula_(const Prop &pl_formula);
+  template <typename Prop>
   bool find_system_move(
-      const size_t &formula_id, const logic::pl_ptr &pl_formula,
+      const size_t &formula_id, const Prop &pl_formula,
       std::stack<std::pair<std::string, VarValues>> &partial_system_move);
+  logic::AtomSet variables_(const logic::pl_ptr &pl_formula);
+  logic::AtomSet variables_(logic::Aig::Edge edge);
+  logic::pl_ptr assign_(const logic::pl_ptr &pl_formula,
+                        const logic::ast_ptr &symbol, bool value);
+  logic::Aig::Edge assign_(logic::Aig::Edge edge, const logic::ast_ptr &symbol,
+                           bool value);
+  logic::ltlf_ptr to_ltlf_(const logic::pl_ptr &pl_formula);
+  logic::ltlf_ptr to_ltlf_(logic::Aig::Edge edge);
 };
 
 } // namespace core
@@ -16,39 +16,49 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/flat.hpp>
+#include <nike/logic/type_switch.hpp>
 
 namespace nike {
 namespace core {
 
-class EvalVisitor : public logic::Visitor {
-private:
-  bool result;
-
+/*
+ * Not memoized: the evaluation stops at the temporal operators, and a
+ * cache lookup costs more than evaluating the boolean skeleton.
+ */
+class EvalVisitor : public logic::TypeSwitchVisitor<EvalVisitor, bool> {
 public:
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
-
-  bool apply(const logic::LTLfFormula &formula);
+  bool visit(const logic::LTLfTrue &);
+  bool visit(const logic::LTLfFalse &);
+  bool visit(const logic::LTLfPropTrue &);
+  bool visit(const logic::LTLfPropFalse &);
+  bool visit(const logic::LTLfAtom &);
+  bool visit(const logic::LTLfNot &);
+  bool visit(const logic::LTLfPropositionalNot &);
+  bool visit(const logic::LTLfAnd &);
+  bool visit(const logic::LTLfOr &);
+  bool visit(const logic::LTLfImplies &);
+  bool visit(const logic::LTLfEquivalent &);
+  bool visit(const logic::LTLfXor &);
+  bool visit(const logic::LTLfNext &);
+  bool visit(const logic::LTLfWeakNext &);
+  bool visit(const logic::LTLfUntil &);
+  bool visit(const logic::LTLfRelease &);
+  bool visit(const logic::LTLfEventually &);
+  bool visit(const logic::LTLfAlways &);
 };
 
 bool eval(const logic::LTLfFormula &formula);
+/**
+ * \brief Same as eval on the formula the layout was built from, in one
+ * loop over its records.
+ *
+ * A negation, implication, equivalence or exclusive disjunction is
+ * rejected only if the evaluation reaches it, as EvalVisitor does, i.e.
+ * not below a temporal operator nor after a conjunct or disjunct that
+ * decides the result.
+ */
+bool eval(const logic::FlatFormula &formula);
 
 } // namespace core
 } // namespace nike
@@ -17,16 +17,24 @@
  */
 
 #include <future>
+#include <nike/core.hpp>
 #include <nike/core_base.hpp>
-#include <nike/logic/copy.hpp>
 #include <nike/shared_queue.hpp>
 
 namespace nike {
 namespace core {
 
+/**
+ * \brief A search run on its own thread.
+ *
+ * The task searches a copy of the frozen formula in a logic context of its
+ * own, so that it neither locks nor shares the state formulas it creates,
+ * and can collect them.
+ */
 class ThreadedForwardSynthesis {
 public:
-  logic::ltlf_ptr formula;
+  std::unique_ptr<logic::Context> context;
+  std::shared_ptr<const FrozenFormula> formula;
   const InputOutputPartition partition;
   BranchingStrategy branch_variable_id;
   StateEquivalenceMode mode;
@@ -34,19 +42,20 @@ public:
   std::thread t;
   std::unique_ptr<ForwardSynthesis> syn;
   unsigned int thread_id;
-  std::unique_ptr<logic::Context> context;
   bool started = false;
-  ThreadedForwardSynthesis(const logic::ltlf_ptr &formula,
+  ThreadedForwardSynthesis(const FrozenFormula &formula,
                            const InputOutputPartition &partition,
                            BranchingStrategy bs, StateEquivalenceMode mode,
                            SharedQueue<std::pair<unsigned int, bool>> &queue,
                            unsigned int thread_id)
-      : context{std::make_unique<logic::Context>()}, partition{partition},
+      : context{std::make_unique<logic::Context>()},
+        formula{copy_frozen_formula(*context, formula)}, partition{partition},
         branch_variable_id{bs}, mode{mode}, queue{queue}, thread_id{thread_id} {
-    this->formula = logic::copy_ltlf_formula(*context, *formula);
     std::string logger_name = "thread_" + std::to_string(thread_id);
     syn = std::make_unique<ForwardSynthesis>(
         this->formula, this->partition, branch_variable_id, mode, logger_name);
+    // the context is private to the task
+    syn->set_shares_ast_manager(false);
   }
 
   void start();
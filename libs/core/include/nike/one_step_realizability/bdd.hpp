@@ -18,18 +18,19 @@
 
 #include <cuddObj.hh>
 #include <nike/core.hpp>
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/type_switch.hpp>
 #include <nike/one_step_realizability/base.hpp>
 #include <optional>
 
 namespace nike {
 namespace core {
 
-class BddOneStepRealizabilityVisitor : public logic::Visitor {
+class BddOneStepRealizabilityVisitor
+    : public logic::TypeSwitchVisitor<BddOneStepRealizabilityVisitor,
+                                      CUDD::BDD> {
 public:
   InputOutputPartition partition;
   CUDD::Cudd manager;
-  CUDD::BDD result;
   std::map<logic::ast_ptr, int> propToId;
   std::vector<std::string> variableNames;
   std::vector<bool> isVariableControllable;
@@ -40,26 +41,24 @@ public:
         controllablesConj{manager.bddOne()}, uncontrollablesConj{
                                                  manager.bddOne()} {}
   ~BddOneStepRealizabilityVisitor() {}
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
-
-  CUDD::BDD apply(const logic::LTLfFormula &f);
+  CUDD::BDD visit(const logic::LTLfTrue &);
+  CUDD::BDD visit(const logic::LTLfFalse &);
+  CUDD::BDD visit(const logic::LTLfPropTrue &);
+  CUDD::BDD visit(const logic::LTLfPropFalse &);
+  CUDD::BDD visit(const logic::LTLfAtom &);
+  CUDD::BDD visit(const logic::LTLfNot &);
+  CUDD::BDD visit(const logic::LTLfPropositionalNot &);
+  CUDD::BDD visit(const logic::LTLfAnd &);
+  CUDD::BDD visit(const logic::LTLfOr &);
+  CUDD::BDD visit(const logic::LTLfImplies &);
+  CUDD::BDD visit(const logic::LTLfEquivalent &);
+  CUDD::BDD visit(const logic::LTLfXor &);
+  CUDD::BDD visit(const logic::LTLfNext &);
+  CUDD::BDD visit(const logic::LTLfWeakNext &);
+  CUDD::BDD visit(const logic::LTLfUntil &);
+  CUDD::BDD visit(const logic::LTLfRelease &);
+  CUDD::BDD visit(const logic::LTLfEventually &);
+  CUDD::BDD visit(const logic::LTLfAlways &);
 };
 
 class BddOneStepRealizabilityChecker : public OneStepRealizabilityChecker {
@@ -0,0 +1,113 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <nike/input_output_partition.hpp>
+#include <nike/logic/base.hpp>
+#include <nike/logic/node_map.hpp>
+
+namespace nike {
+namespace core {
+
+/**
+ * \brief A 128-bit structural fingerprint.
+ *
+ * Unlike the hash of a node, it does not depend on node addresses, hence
+ * it is stable across logic::Context objects and processes.
+ */
+struct Fingerprint {
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+
+  bool operator==(const Fingerprint &other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+  bool operator<(const Fingerprint &other) const {
+    return hi < other.hi || (hi == other.hi && lo < other.lo);
+  }
+};
+
+/**
+ * \brief Compute structural fingerprints of LTLf formulas, memoized by node.
+ *
+ * The fingerprint of a state also depends on the partition, since the
+ * verdict on a state does: the partition is folded into the seed. The
+ * formulas must belong to the same logic context.
+ */
+class StructuralFingerprint {
+public:
+  explicit StructuralFingerprint(const InputOutputPartition &partition);
+
+  Fingerprint operator()(const logic::LTLfFormula &formula);
+
+private:
+  Fingerprint seed_;
+  // by node id: ids are not reused, so the memo does not keep the nodes
+  // alive
+  logic::NodeMap<Fingerprint> memo_;
+};
+
+enum class SharedVerdict : uint32_t { UNKNOWN = 0, REALIZABLE, UNREALIZABLE };
+
+/**
+ * \brief A fixed-size table of state verdicts in shared memory.
+ *
+ * The table is an open-addressing array of slots in a memfd mapping; a
+ * table created before fork() is shared by the child processes. Slots are
+ * claimed with a compare-and-swap on the high half of the key, and a
+ * verdict is published only after the whole key is written. Entries are
+ * never removed; when the probe sequence is full, the insertion is
+ * dropped.
+ *
+ * Only verdicts that do not depend on the search history must be stored
+ * (e.g. not the failures due to a loop on the current path).
+ */
+class SharedVerdictTable {
+public:
+  static constexpr size_t max_probes = 32;
+
+  explicit SharedVerdictTable(size_t nb_slots);
+  ~SharedVerdictTable();
+  SharedVerdictTable(const SharedVerdictTable &) = delete;
+  SharedVerdictTable &operator=(const SharedVerdictTable &) = delete;
+
+  SharedVerdict find(const Fingerprint &key) const;
+  bool insert(const Fingerprint &key, SharedVerdict verdict);
+
+  size_t nb_slots() const { return nb_slots_; }
+  /// number of published entries (linear scan)
+  size_t size() const;
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> hi;
+    std::atomic<uint64_t> lo;
+    std::atomic<uint32_t> verdict;
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shared verdicts need address-free atomics");
+
+  size_t nb_slots_;
+  size_t mapping_size_;
+  Slot *slots_;
+};
+
+} // namespace core
+} // namespace nike
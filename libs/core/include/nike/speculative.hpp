@@ -0,0 +1,137 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <nike/logic/flat.hpp>
+#include <nike/logic/types.hpp>
+#include <nike/one_step_realizability/base.hpp>
+#include <nike/shared_queue.hpp>
+#include <nike/strategy.hpp>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nike {
+namespace core {
+
+class Context;
+
+/**
+ * \brief Outcome of the local checks on a search state.
+ *
+ * The checks are, in order: zero-step realizability (eval), one-step
+ * realizability and one-step unrealizability. The first conclusive check
+ * determines the verdict; UNKNOWN means the state must be expanded.
+ */
+struct StateVerdict {
+  enum Kind { UNKNOWN, ACCEPTING, ONE_STEP_REALIZABLE, ONE_STEP_UNREALIZABLE };
+  Kind kind = UNKNOWN;
+  /// the agent move, if kind == ONE_STEP_REALIZABLE
+  move_t move;
+};
+
+/**
+ * \brief Run the local checks on a state formula, honouring the
+ * disable flags of the context.
+ *
+ * Only the partition of the context is read, hence this function can be
+ * called concurrently with the search. The zero-step check runs on the
+ * flat layout of the formula, if given.
+ */
+StateVerdict check_state(const logic::LTLfFormula &formula, Context &context,
+                         OneStepRealizabilityChecker &checker,
+                         const logic::FlatFormula *flat_formula = nullptr);
+
+/**
+ * \brief Thread-safe map from state formulas to their verdict.
+ *
+ * Entries are keyed by the (hash-consed) formula pointer, and keep the
+ * formula alive until they are taken or released.
+ */
+class VerdictCache {
+public:
+  /// Mark the formula as pending; false if it is already pending or done.
+  bool reserve(const logic::ltlf_ptr &formula);
+  void insert(const logic::ltlf_ptr &formula, StateVerdict verdict);
+  std::optional<StateVerdict> find(const logic::LTLfFormula &formula) const;
+  /// Like find, but a verdict found is removed from the cache.
+  std::optional<StateVerdict> take(const logic::LTLfFormula &formula);
+  /// Remove the verdicts not taken, and return their number; the pending
+  /// entries are kept.
+  size_t release_ready();
+  size_t size() const;
+
+private:
+  struct Entry {
+    logic::ltlf_ptr formula;
+    bool ready = false;
+    StateVerdict verdict;
+  };
+  mutable std::mutex mutex_;
+  std::unordered_map<const logic::LTLfFormula *, Entry> entries_;
+};
+
+/**
+ * \brief A pool of helper threads that run the local checks on successor
+ * states ahead of the search.
+ *
+ * The search submits the successors of an AND-node as soon as they are
+ * enumerated; when it later visits one of them, the verdict might be
+ * already in the cache. Missing verdicts are not waited for: the search
+ * computes them itself. A verdict is removed from the cache once looked
+ * up, and the ones never looked up are released on each garbage
+ * collection, so that the cache does not keep their formulas alive.
+ *
+ * Helpers only read the formulas (no node is created), hence the
+ * logic::Context can be shared with the search thread.
+ */
+class SpeculativePrefetcher {
+public:
+  /// beyond this number of pending states, submissions are dropped
+  static constexpr size_t max_pending = 4096;
+
+  SpeculativePrefetcher(Context &context, size_t nb_threads);
+  ~SpeculativePrefetcher();
+  SpeculativePrefetcher(const SpeculativePrefetcher &) = delete;
+  SpeculativePrefetcher &operator=(const SpeculativePrefetcher &) = delete;
+
+  void submit(const logic::ltlf_ptr &formula);
+  std::optional<StateVerdict> lookup(const logic::LTLfFormula &formula);
+  /// Drop the verdicts that were not looked up.
+  void release_verdicts() { cache_.release_ready(); }
+
+  size_t nb_submitted() const { return nb_submitted_; }
+  size_t nb_hits() const { return nb_hits_; }
+  size_t nb_misses() const { return nb_misses_; }
+
+private:
+  Context &context_;
+  VerdictCache cache_;
+  SharedQueue<logic::ltlf_ptr> pending_;
+  std::atomic<size_t> nb_pending_{0};
+  std::vector<std::thread> helpers_;
+  size_t nb_submitted_ = 0;
+  size_t nb_hits_ = 0;
+  size_t nb_misses_ = 0;
+
+  void helper_loop_();
+};
+
+} // namespace core
+} // namespace nike
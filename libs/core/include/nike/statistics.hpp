@@ -31,5 +31,16 @@ public:
   void visit_node(size_t node_id);
 };
 
+/**
+ * \brief Wall-clock time, in milliseconds, of the stages before the search.
+ */
+struct PreprocessingTimes {
+  double nnf_ms = 0.0;
+  double xnf_ms = 0.0;
+  double closure_ms = 0.0;
+  double prop_to_id_ms = 0.0;
+  double root_checks_ms = 0.0;
+};
+
 } // namespace core
 } // namespace nike
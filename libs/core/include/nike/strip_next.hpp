@@ -16,37 +16,58 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/traversal.hpp>
 
 namespace nike {
 namespace core {
 
-class StripNextVisitor : public logic::Visitor {
-private:
-  logic::ltlf_ptr result;
-
+class StripNextVisitor
+    : public logic::MemoizedPostOrderVisitor<StripNextVisitor> {
 public:
-  StripNextVisitor() = default;
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
+  explicit StripNextVisitor(logic::MemoTable *memo_table = nullptr)
+      : MemoizedPostOrderVisitor{memo_table} {}
 
-  logic::ltlf_ptr apply(const logic::LTLfFormula &formula);
+  void expand(const logic::LTLfFormula &f, size_t tag);
+  logic::ltlf_ptr combine(const logic::LTLfFormula &f, size_t tag,
+                          const logic::ltlf_ptr *args);
+
+private:
+  logic::ltlf_ptr combine_(const logic::LTLfTrue &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfFalse &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfPropTrue &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfPropFalse &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfAtom &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfNot &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfPropositionalNot &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfAnd &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfOr &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfImplies &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfEquivalent &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfXor &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfNext &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfWeakNext &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfUntil &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfRelease &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfEventually &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfAlways &f,
+                           const logic::ltlf_ptr *args);
 };
 
 logic::ltlf_ptr strip_next(const logic::LTLfFormula &formula);
@@ -0,0 +1,107 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <nike/batch.hpp>
+#include <nike/logger.hpp>
+#include <nike/shared_verdicts.hpp>
+#include <sys/types.h>
+
+namespace nike {
+namespace core {
+
+struct SupervisorOptions {
+  BatchOptions batch;
+  /// resident memory limit per worker, in megabytes (0 for no limit); it
+  /// also bounds the address space a worker can add once started
+  size_t memory_limit_mb = 0;
+  /// number of slots of the shared verdict table
+  size_t shared_table_slots = size_t(1) << 20;
+  /// how often the memory of the workers is checked
+  unsigned int poll_interval_ms = 100;
+};
+
+/**
+ * \brief Process-level solver for many synthesis instances.
+ *
+ * The supervisor forks one process per worker and hands out instances to
+ * them one at a time over a pipe; results come back over another pipe.
+ * Since every instance is solved in a separate process, a memory blow-up
+ * in CUDD only costs the instance that caused it: the supervisor polls the
+ * resident memory of the workers, kills the ones above the limit, reports
+ * the instance as MEMOUT and forks a replacement. Polling alone lets a
+ * worker allocate a lot between two polls, so each worker also sets
+ * RLIMIT_AS to the address space it starts with plus the limit: an
+ * allocation beyond it fails, and the worker reports a MEMOUT and exits.
+ *
+ * The workers share a SharedVerdictTable, created before forking, where
+ * they publish the verdicts on the states they solve.
+ */
+class Supervisor {
+public:
+  Supervisor(std::vector<BatchInstance> instances, SupervisorOptions options);
+
+  /**
+   * \brief Solve all the instances.
+   *
+   * The callback is called once per instance, in completion order, from
+   * the supervisor process.
+   */
+  void run(const BatchSynthesis::callback_t &callback);
+
+  /**
+   * \brief Solve all the instances and stream the results as JSON lines.
+   */
+  void run(std::ostream &out);
+
+  const std::vector<BatchInstance> &instances() const { return instances_; }
+  /// number of entries in the shared table after the last run
+  size_t nb_shared_verdicts() const { return nb_shared_verdicts_; }
+
+private:
+  struct Worker {
+    unsigned int id = 0;
+    pid_t pid = -1;
+    int task_fd = -1;
+    int result_fd = -1;
+    bool busy = false;
+    size_t index = 0;
+    std::chrono::high_resolution_clock::time_point started;
+  };
+
+  std::vector<BatchInstance> instances_;
+  SupervisorOptions options_;
+  std::vector<Worker> workers_;
+  size_t nb_shared_verdicts_ = 0;
+  utils::Logger logger;
+
+  void spawn_(Worker &worker, SharedVerdictTable &table);
+  void reap_(Worker &worker);
+  [[noreturn]] void worker_main_(int task_fd, int result_fd,
+                                 SharedVerdictTable &table);
+  BatchResult failed_result_(const Worker &worker, BatchStatus status,
+                             const std::string &message) const;
+};
+
+/**
+ * \brief The resident memory of a process, in bytes (0 if unknown).
+ */
+size_t resident_memory(pid_t pid);
+
+} // namespace core
+} // namespace nike
@@ -16,43 +16,48 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "nike/logic/aig.hpp"
 #include "nike/logic/ltlf.hpp"
-#include "nike/logic/visitor.hpp"
+#include "nike/logic/traversal.hpp"
 #include <utility>
 
 namespace nike {
 namespace logic {
 
-class ToPLVisitor : public Visitor {
-private:
-  pl_ptr result;
-
+class ToPLVisitor : public PostOrderVisitor<ToPLVisitor, LTLfFormula, pl_ptr> {
 public:
   ToPLVisitor() {}
 
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
+  void expand(const LTLfFormula &f, size_t tag);
+  pl_ptr combine(const LTLfFormula &f, size_t tag, const pl_ptr *args);
 
-  pl_ptr apply(const LTLfFormula &b);
+private:
+  pl_ptr combine_(const logic::LTLfTrue &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfFalse &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfPropTrue &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfPropFalse &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfAtom &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfNot &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfPropositionalNot &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfAnd &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfOr &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfImplies &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfEquivalent &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfXor &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfNext &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfWeakNext &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfUntil &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfRelease &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfEventually &, const pl_ptr *args);
+  pl_ptr combine_(const logic::LTLfAlways &, const pl_ptr *args);
 };
 
 pl_ptr to_pl(const LTLfFormula &formula);
+/**
+ * \brief The AIG edge of the XNF formula, with the inputs of the
+ * propositions of the literals of to_pl.
+ */
+Aig::Edge to_aig(Aig &aig, const LTLfFormula &formula);
 
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
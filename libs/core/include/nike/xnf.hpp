@@ -16,38 +16,58 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/traversal.hpp>
 
 namespace nike {
 namespace core {
 
-class XnfVisitor : public logic::Visitor {
+/*
+ * Transform a formula in Next Normal Form.
+ *
+ * Until and Release are rewritten with their one-step unfolding, which is
+ * then transformed in turn; the Next and Weak Next subformulas are kept.
+ */
+class XnfVisitor : public logic::MemoizedPostOrderVisitor<XnfVisitor> {
+public:
+  explicit XnfVisitor(logic::MemoTable *memo_table = nullptr)
+      : MemoizedPostOrderVisitor{memo_table} {}
+
+  void expand(const logic::LTLfFormula &f, size_t tag);
+  logic::ltlf_ptr combine(const logic::LTLfFormula &f, size_t tag,
+                          const logic::ltlf_ptr *args);
+
 private:
-  logic::ltlf_ptr result;
+  void expand_(const logic::LTLfFormula &f);
+  void expand_(const logic::LTLfNot &f);
+  void expand_(const logic::LTLfBinaryOp &f);
+  void expand_(const logic::LTLfUntil &f);
+  void expand_(const logic::LTLfRelease &f);
+  void expand_(const logic::LTLfEventually &f);
+  void expand_(const logic::LTLfAlways &f);
 
-public:
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
-
-  logic::ltlf_ptr apply(const logic::LTLfFormula &formula);
+  logic::ltlf_ptr combine_(const logic::LTLfFormula &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfAnd &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfOr &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfImplies &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfEquivalent &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfXor &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfUntil &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfRelease &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfEventually &f,
+                           const logic::ltlf_ptr *args);
+  logic::ltlf_ptr combine_(const logic::LTLfAlways &f,
+                           const logic::ltlf_ptr *args);
 };
 
+/// memoized in the context of the formula
 logic::ltlf_ptr xnf(const logic::LTLfFormula &formula);
 
 } // namespace core
@@ -0,0 +1,257 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <nike/batch.hpp>
+#include <nike/core.hpp>
+#include <nike/parser/driver.hpp>
+#include <nike/shared_queue.hpp>
+#include <sstream>
+#include <thread>
+
+namespace nike {
+namespace core {
+
+namespace {
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point start,
+                  std::chrono::high_resolution_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+std::string json_escape(const std::string &s) {
+  std::ostringstream out;
+  for (const auto &c : s) {
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\r':
+      out << "\\r";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << static_cast<int>(c) << std::dec;
+      } else {
+        out << c;
+      }
+    }
+  }
+  return out.str();
+}
+
+std::string resolve_path(const std::string &path, const std::string &base_dir) {
+  std::filesystem::path p{path};
+  if (base_dir.empty() || p.is_absolute()) {
+    return path;
+  }
+  return (std::filesystem::path(base_dir) / p).string();
+}
+
+} // namespace
+
+std::string batch_status_to_string(BatchStatus status) {
+  switch (status) {
+  case BatchStatus::REALIZABLE:
+    return "REALIZABLE";
+  case BatchStatus::UNREALIZABLE:
+    return "UNREALIZABLE";
+  case BatchStatus::ERROR:
+    return "ERROR";
+  case BatchStatus::MEMOUT:
+    return "MEMOUT";
+  }
+  throw std::logic_error("unknown batch status");
+}
+
+std::string batch_result_to_json(const BatchResult &result) {
+  std::ostringstream out;
+  out << "{\"index\": " << result.index
+      << ", \"worker\": " << result.worker_id << ", \"formula\": \""
+      << json_escape(result.formula_file) << "\", \"partition\": \""
+      << json_escape(result.partition_file) << "\", \"result\": \""
+      << batch_status_to_string(result.status) << "\"";
+  if (result.status == BatchStatus::ERROR ||
+      result.status == BatchStatus::MEMOUT) {
+    out << ", \"error\": \"" << json_escape(result.error_message) << "\"";
+  }
+  out << ", \"visited_nodes\": " << result.nb_visited_nodes
+      << ", \"parsing_time_ms\": " << result.parsing_time_ms
+      << ", \"synthesis_time_ms\": " << result.synthesis_time_ms
+      << ", \"total_time_ms\": " << result.total_time_ms << "}";
+  return out.str();
+}
+
+std::vector<BatchInstance> read_manifest(std::istream &in,
+                                         const std::string &base_dir) {
+  std::vector<BatchInstance> result;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    std::istringstream line_stream(line);
+    std::string formula_file;
+    std::string partition_file;
+    if (!(line_stream >> formula_file) || formula_file[0] == '#') {
+      continue;
+    }
+    std::string extra;
+    if (!(line_stream >> partition_file) || (line_stream >> extra)) {
+      throw std::runtime_error("Incorrect format in line " +
+                               std::to_string(line_number) +
+                               " of the manifest file.");
+    }
+    result.push_back({resolve_path(formula_file, base_dir),
+                      resolve_path(partition_file, base_dir)});
+  }
+  return result;
+}
+
+std::vector<BatchInstance>
+read_manifest_from_file(const std::string &filename) {
+  std::ifstream in(filename);
+  if (!in.good()) {
+    throw std::runtime_error("cannot open manifest file " + filename);
+  }
+  auto base_dir = std::filesystem::path(filename).parent_path().string();
+  return read_manifest(in, base_dir);
+}
+
+BatchResult solve_batch_instance(const BatchInstance &instance,
+                                 const BatchOptions &options,
+                                 logic::Context &context,
+                                 const CUDD::Cudd &manager,
+                                 SharedVerdictTable *shared_verdicts) {
+  BatchResult result;
+  result.formula_file = instance.formula_file;
+  result.partition_file = instance.partition_file;
+
+  auto t_start = std::chrono::high_resolution_clock::now();
+  auto t_parsed = t_start;
+  context.set_simplification(options.simplify);
+  try {
+    // the driver does not own the context: the worker keeps it alive
+    auto driver = parser::ltlf::LTLfDriver(
+        std::shared_ptr<logic::Context>(&context, [](logic::Context *) {}));
+    driver.parse(instance.formula_file.c_str());
+    auto formula = driver.get_result();
+    if (options.no_empty) {
+      auto not_end = context.make_not(context.make_end());
+      formula = context.make_and({formula, not_end});
+    }
+    auto partition =
+        InputOutputPartition::read_from_file(instance.partition_file);
+    t_parsed = std::chrono::high_resolution_clock::now();
+
+    auto synthesis = ForwardSynthesis(
+        formula, partition, options.bs, options.mode, "batch",
+        options.disable_one_step_realizability,
+        options.disable_one_step_unrealizability, 3.0, &manager,
+        options.nb_preprocessing_threads);
+    synthesis.set_shared_verdicts(shared_verdicts);
+    synthesis.set_prefetch_threads(options.nb_prefetch_threads);
+    synthesis.set_gc_threshold(options.gc_threshold);
+    synthesis.set_aig_branching(options.aig_branching);
+    synthesis.set_flat_passes(options.flat_passes);
+    bool is_realizable = synthesis.is_realizable();
+    result.status =
+        is_realizable ? BatchStatus::REALIZABLE : BatchStatus::UNREALIZABLE;
+    result.nb_visited_nodes = synthesis.statistics().nb_visited_nodes();
+  } catch (std::bad_alloc &) {
+    result.status = BatchStatus::MEMOUT;
+    result.error_message = "out of memory";
+  } catch (std::exception &e) {
+    result.status = BatchStatus::ERROR;
+    result.error_message = e.what();
+  }
+  auto t_end = std::chrono::high_resolution_clock::now();
+  // the formulas of this instance are not needed by the next ones
+  context.collect_garbage();
+  if (result.status == BatchStatus::ERROR && t_parsed == t_start) {
+    t_parsed = t_end;
+  }
+  result.parsing_time_ms = elapsed_ms(t_start, t_parsed);
+  result.synthesis_time_ms = elapsed_ms(t_parsed, t_end);
+  result.total_time_ms = elapsed_ms(t_start, t_end);
+  return result;
+}
+
+BatchSynthesis::BatchSynthesis(std::vector<BatchInstance> instances,
+                               BatchOptions options)
+    : instances_{std::move(instances)}, options_{options}, logger{"batch"} {
+  if (options_.nb_workers == 0) {
+    throw std::invalid_argument("number of workers must be positive");
+  }
+}
+
+void BatchSynthesis::run(const callback_t &callback) {
+  SharedQueue<size_t> pending;
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    pending.push_back(i);
+  }
+  std::mutex callback_mutex;
+
+  auto worker = [&](unsigned int worker_id) {
+    logic::Context context;
+    CUDD::Cudd manager;
+    size_t index;
+    while (pending.try_pop_front(index)) {
+      auto result =
+          solve_batch_instance(instances_[index], options_, context, manager);
+      result.index = index;
+      result.worker_id = worker_id;
+      std::lock_guard<std::mutex> lock(callback_mutex);
+      callback(result);
+    }
+  };
+
+  auto nb_workers = std::min(options_.nb_workers, instances_.size());
+  logger.info("Solving {} instances with {} workers", instances_.size(),
+              nb_workers);
+  std::vector<std::thread> workers;
+  workers.reserve(nb_workers);
+  for (unsigned int i = 0; i < nb_workers; ++i) {
+    workers.emplace_back(worker, i);
+  }
+  for (auto &t : workers) {
+    t.join();
+  }
+}
+
+void BatchSynthesis::run(std::ostream &out) {
+  run([&out](const BatchResult &result) {
+    out << batch_result_to_json(result) << std::endl;
+  });
+}
+
+} // namespace core
+} // namespace nike
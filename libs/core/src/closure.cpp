@@ -22,13 +22,35 @@ namespace nike {
 namespace core {
 
 size_t Closure::get_id(const logic::ltlf_ptr &formula) const {
-  auto result = utils::binary_search_find_index(from_id_to_subformula, formula,
-                                                utils::Deref::Less());
-  if (result > from_id_to_subformula.size()) {
-    throw std::invalid_argument("formula not found");
+  return get_id(*formula);
+}
+
+size_t Closure::get_id(const logic::LTLfFormula &formula) const {
+  auto result = from_node_to_id_.find(formula);
+  if (result != nullptr) {
+    return *result;
+  }
+  if (!formula.has_id()) {
+    // not interned: look for an equal formula
+    auto it = std::find_if(
+        from_id_to_subformula.begin(), from_id_to_subformula.end(),
+        [&formula](const logic::ltlf_ptr &f) { return *f == formula; });
+    if (it != from_id_to_subformula.end()) {
+      return std::distance(from_id_to_subformula.begin(), it);
+    }
+  }
+  throw std::invalid_argument("formula not found");
+}
+
+std::vector<size_t> Closure::get_ids(const logic::vec_ptr &formulas) const {
+  std::vector<size_t> result;
+  result.reserve(formulas.size());
+  for (const auto &formula : formulas) {
+    result.push_back(get_id(*formula));
   }
   return result;
 }
+
 const logic::ltlf_ptr &Closure::get_formula(size_t index) const {
   if (index > from_id_to_subformula.size()) {
     throw std::invalid_argument("invalid index");
@@ -36,103 +58,98 @@ const logic::ltlf_ptr &Closure::get_formula(size_t index) const {
   return from_id_to_subformula[index];
 }
 
-void ClosureVisitor::visit(const logic::LTLfTrue &formula) {
-  insert_if_not_already_present_(formula);
+void ClosureVisitor::expand(const logic::LTLfFormula &f, size_t) {
+  if (expanded_.insert(f)) {
+    logic::dispatch(f, [this](const auto &formula) { expand_(formula); });
+  }
 }
-void ClosureVisitor::visit(const logic::LTLfFalse &formula) {
-  insert_if_not_already_present_(formula);
+
+void ClosureVisitor::expand_(const logic::LTLfTrue &formula) {
+  insert_(formula);
+}
+void ClosureVisitor::expand_(const logic::LTLfFalse &formula) {
+  insert_(formula);
 }
-void ClosureVisitor::visit(const logic::LTLfPropTrue &formula) {
-  insert_if_not_already_present_(formula);
+void ClosureVisitor::expand_(const logic::LTLfPropTrue &formula) {
+  insert_(formula);
   // 'true' in the closure implies 'tt' in the closure
-  auto &c = formula.ctx();
-  const auto &tt = c.make_tt();
-  insert_if_not_already_present_(*tt);
+  insert_(*formula.ctx().make_tt());
 }
-void ClosureVisitor::visit(const logic::LTLfPropFalse &formula) {
-  insert_if_not_already_present_(formula);
+void ClosureVisitor::expand_(const logic::LTLfPropFalse &formula) {
+  insert_(formula);
   // 'false' in the closure implies 'ff' in the closure
-  auto &c = formula.ctx();
-  const auto &ff = c.make_ff();
-  insert_if_not_already_present_(*ff);
+  insert_(*formula.ctx().make_ff());
 }
-void ClosureVisitor::visit(const logic::LTLfAtom &formula) {
-  insert_if_not_already_present_(formula);
+void ClosureVisitor::expand_(const logic::LTLfAtom &formula) {
+  insert_(formula);
   // 'atom' in the closure implies:
   //   (1) 'tt' in the closure (in case of success transition)
   //   (2) 'ff' in the closure (in case of failing transition)
   auto &c = formula.ctx();
-  const auto &tt = c.make_tt();
-  const auto &ff = c.make_ff();
-  insert_if_not_already_present_(*tt);
-  insert_if_not_already_present_(*ff);
+  insert_(*c.make_tt());
+  insert_(*c.make_ff());
 }
-void ClosureVisitor::visit(const logic::LTLfNot &formula) {
+void ClosureVisitor::expand_(const logic::LTLfNot &) {
   logic::throw_expected_nnf();
 }
-void ClosureVisitor::visit(const logic::LTLfPropositionalNot &formula) {
-  insert_if_not_already_present_(formula);
+void ClosureVisitor::expand_(const logic::LTLfPropositionalNot &formula) {
+  insert_(formula);
   // '!atom' in the closure implies:
   //   (1) 'tt' in the closure (in case of success transition)
   //   (2) 'ff' in the closure (in case of failing transition)
   auto &c = formula.ctx();
-  const auto &tt = c.make_tt();
-  const auto &ff = c.make_ff();
-  insert_if_not_already_present_(*tt);
-  insert_if_not_already_present_(*ff);
+  insert_(*c.make_tt());
+  insert_(*c.make_ff());
 }
-void ClosureVisitor::visit(const logic::LTLfAnd &formula) {
-  apply_to_binary_op_(formula);
+void ClosureVisitor::expand_(const logic::LTLfAnd &formula) {
+  push_arguments_(formula);
 }
-void ClosureVisitor::visit(const logic::LTLfOr &formula) {
-  apply_to_binary_op_(formula);
+void ClosureVisitor::expand_(const logic::LTLfOr &formula) {
+  push_arguments_(formula);
 }
-void ClosureVisitor::visit(const logic::LTLfImplies &formula) {
+void ClosureVisitor::expand_(const logic::LTLfImplies &) {
   logic::throw_not_implemented_error();
 }
-void ClosureVisitor::visit(const logic::LTLfEquivalent &formula) {
+void ClosureVisitor::expand_(const logic::LTLfEquivalent &) {
   logic::throw_not_implemented_error();
 }
-void ClosureVisitor::visit(const logic::LTLfXor &formula) {
-  apply_to_binary_op_(formula);
-}
-void ClosureVisitor::visit(const logic::LTLfNext &formula) {
-  apply_to_unary_op_(formula);
-}
-void ClosureVisitor::visit(const logic::LTLfWeakNext &formula) {
-  apply_to_unary_op_(formula);
-}
-void ClosureVisitor::visit(const logic::LTLfUntil &formula) {
-  apply_to_right_associative_binary_op_(formula,
-                                        [&formula](const logic::vec_ptr &args) {
-                                          return formula.ctx().make_until(args);
-                                        });
-  apply(*formula.ctx().make_next(
-      std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this())));
-}
-void ClosureVisitor::visit(const logic::LTLfRelease &formula) {
-  apply_to_right_associative_binary_op_(
-      formula, [&formula](const logic::vec_ptr &args) {
-        return formula.ctx().make_release(args);
-      });
-  apply(*formula.ctx().make_weak_next(
-      std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this())));
-}
-void ClosureVisitor::visit(const logic::LTLfEventually &formula) {
-  apply_to_unary_op_(formula);
-  apply(*formula.ctx().make_next(
-      std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this())));
-}
-void ClosureVisitor::visit(const logic::LTLfAlways &formula) {
-  apply_to_unary_op_(formula);
-  apply(*formula.ctx().make_weak_next(
-      std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this())));
-}
-void ClosureVisitor::apply(const logic::LTLfFormula &f) { f.accept(*this); }
+void ClosureVisitor::expand_(const logic::LTLfXor &formula) {
+  push_arguments_(formula);
+}
+void ClosureVisitor::expand_(const logic::LTLfNext &formula) {
+  insert_(formula);
+  push(*formula.arg);
+}
+void ClosureVisitor::expand_(const logic::LTLfWeakNext &formula) {
+  insert_(formula);
+  push(*formula.arg);
+}
+void ClosureVisitor::expand_(const logic::LTLfUntil &formula) {
+  auto &c = formula.ctx();
+  push_arguments_(formula);
+  push_suffixes_(formula, [&c](const logic::vec_ptr &args) {
+    return c.make_until(args);
+  });
+  push(*c.make_next(logic::shared_from(formula)));
+}
+void ClosureVisitor::expand_(const logic::LTLfRelease &formula) {
+  auto &c = formula.ctx();
+  push_arguments_(formula);
+  push_suffixes_(formula, [&c](const logic::vec_ptr &args) {
+    return c.make_release(args);
+  });
+  push(*c.make_weak_next(logic::shared_from(formula)));
+}
+void ClosureVisitor::expand_(const logic::LTLfEventually &formula) {
+  insert_(formula);
+  push(*formula.arg);
+  push(*formula.ctx().make_next(logic::shared_from(formula)));
+}
+void ClosureVisitor::expand_(const logic::LTLfAlways &formula) {
+  insert_(formula);
+  push(*formula.arg);
+  push(*formula.ctx().make_weak_next(logic::shared_from(formula)));
+}
 Closure closure(const logic::LTLfFormula &f) {
   auto visitor = ClosureVisitor{};
   visitor.apply(f);
@@ -140,6 +157,27 @@ Closure closure(const logic::LTLfFormula &f) {
   return Closure{visitor.formulas};
 }
 
+Closure closure(const logic::LTLfFormula &f, size_t nb_threads) {
+  if (nb_threads <= 1 || !logic::is_a<logic::LTLfAnd>(f)) {
+    return closure(f);
+  }
+  const auto &conjuncts = dynamic_cast<const logic::LTLfAnd &>(f).args;
+  std::vector<ClosureVisitor> visitors(conjuncts.size());
+  utils::parallel_for(conjuncts.size(), nb_threads, [&](size_t i) {
+    visitors[i].apply(*conjuncts[i]);
+  });
+  auto visitor = ClosureVisitor{};
+  for (const auto &partial : visitors) {
+    visitor.formulas.insert(partial.formulas.begin(), partial.formulas.end());
+  }
+  visitor.add_end_and_not_end_(f.ctx());
+  return Closure{visitor.formulas};
+}
+
+Closure closure_of(const logic::vec_ptr &formulas) {
+  return Closure{logic::set_ptr(formulas.begin(), formulas.end())};
+}
+
 logic::vec_ptr::const_iterator Closure::begin_formulas() const {
   return from_id_to_subformula.begin();
 }
@@ -159,6 +197,21 @@ std::vector<logic::atom_ptr>::const_iterator Closure::end_atoms() const {
 Closure::Closure(const logic::set_ptr &formulas)
     : from_id_to_subformula(utils::vectify(formulas)) {
   find_atoms_();
+  index_formulas_();
+}
+
+void Closure::index_formulas_() {
+  if (from_id_to_subformula.empty()) {
+    return;
+  }
+  from_node_to_id_ =
+      logic::NodeMap<size_t>(from_id_to_subformula.front()->ctx());
+  for (size_t i = 0; i < from_id_to_subformula.size(); ++i) {
+    const auto &formula = *from_id_to_subformula[i];
+    if (formula.has_id()) {
+      from_node_to_id_[formula] = i;
+    }
+  }
 }
 
 void Closure::find_atoms_() {
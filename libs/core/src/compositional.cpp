@@ -0,0 +1,270 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <nike/compositional.hpp>
+#include <nike/core.hpp>
+#include <nike/logic/atom_visitor.hpp>
+#include <nike/logic/nnf.hpp>
+#include <nike/multithreaded.hpp>
+#include <nike/one_step_realizability/base.hpp>
+#include <numeric>
+
+namespace nike {
+namespace core {
+
+namespace {
+
+bool is_propositional(const logic::LTLfFormula &f) {
+  switch (f.get_type_code()) {
+  case logic::TypeID::t_LTLfTrue:
+  case logic::TypeID::t_LTLfFalse:
+  case logic::TypeID::t_LTLfPropTrue:
+  case logic::TypeID::t_LTLfPropFalse:
+  case logic::TypeID::t_LTLfAtom:
+  case logic::TypeID::t_LTLfPropNot:
+    return true;
+  case logic::TypeID::t_LTLfAnd:
+  case logic::TypeID::t_LTLfOr: {
+    const auto &args = dynamic_cast<const logic::LTLfBinaryOp &>(f).args;
+    return std::all_of(args.begin(), args.end(),
+                       [](const logic::ltlf_ptr &a) {
+                         return is_propositional(*a);
+                       });
+  }
+  default:
+    return false;
+  }
+}
+
+bool is_invariant(const logic::LTLfFormula &f) {
+  return logic::is_a<logic::LTLfAlways>(f) &&
+         is_propositional(*dynamic_cast<const logic::LTLfAlways &>(f).arg);
+}
+
+size_t find_root(std::vector<size_t> &parent, size_t i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+} // namespace
+
+logic::ltlf_ptr Component::formula() const {
+  if (conjuncts.size() == 1) {
+    return conjuncts[0];
+  }
+  return conjuncts[0]->ctx().make_and(conjuncts);
+}
+
+std::vector<Component> decompose(const logic::LTLfFormula &nnf_formula,
+                                 const InputOutputPartition &partition) {
+  logic::vec_ptr conjuncts;
+  if (logic::is_a<logic::LTLfAnd>(nnf_formula)) {
+    conjuncts = dynamic_cast<const logic::LTLfAnd &>(nnf_formula).args;
+  } else {
+    conjuncts.push_back(logic::shared_from(nnf_formula));
+  }
+
+  // union-find over the conjuncts, linking those that share an output
+  std::vector<size_t> parent(conjuncts.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::vector<std::set<std::string>> outputs(conjuncts.size());
+  std::map<std::string, size_t> output_owner;
+  for (size_t i = 0; i < conjuncts.size(); ++i) {
+    for (const auto &symbol : logic::find_atoms(*conjuncts[i])) {
+      const auto &name =
+          std::static_pointer_cast<const logic::StringSymbol>(symbol)->name;
+      if (!partition.is_var(name) || partition.is_input(name)) {
+        continue;
+      }
+      outputs[i].insert(name);
+      auto it = output_owner.find(name);
+      if (it == output_owner.end()) {
+        output_owner[name] = i;
+      } else {
+        parent[find_root(parent, i)] = find_root(parent, it->second);
+      }
+    }
+  }
+
+  std::vector<Component> result;
+  std::map<size_t, size_t> root_to_component;
+  logic::vec_ptr residual;
+  for (size_t i = 0; i < conjuncts.size(); ++i) {
+    if (outputs[i].empty()) {
+      residual.push_back(conjuncts[i]);
+      continue;
+    }
+    auto root = find_root(parent, i);
+    auto it = root_to_component.find(root);
+    if (it == root_to_component.end()) {
+      it = root_to_component.emplace(root, result.size()).first;
+      result.emplace_back();
+    }
+    auto &component = result[it->second];
+    component.conjuncts.push_back(conjuncts[i]);
+    component.output_variables.insert(outputs[i].begin(), outputs[i].end());
+    component.is_invariant =
+        component.is_invariant && is_invariant(*conjuncts[i]);
+  }
+
+  if (!residual.empty()) {
+    auto main =
+        std::find_if(result.begin(), result.end(),
+                     [](const Component &c) { return !c.is_invariant; });
+    if (main == result.end()) {
+      result.emplace_back();
+      main = result.end() - 1;
+    }
+    main->conjuncts.insert(main->conjuncts.end(), residual.begin(),
+                           residual.end());
+    main->is_invariant = false;
+  }
+  return result;
+}
+
+CompositionalSynthesis::CompositionalSynthesis(
+    const logic::ltlf_ptr &formula, const InputOutputPartition &partition,
+    BranchingStrategy bs, StateEquivalenceMode mode)
+    : ISynthesis(formula, partition), bs_{bs}, mode_{mode},
+      logger{"compositional"} {}
+
+bool CompositionalSynthesis::is_realizable() {
+  auto nnf_formula = logic::to_nnf(*formula);
+  components_ = decompose(*nnf_formula, partition);
+  invariant_moves_.clear();
+  strategy_.reset();
+  logger.info("Found {} components", components_.size());
+  if (components_.size() <= 1) {
+    auto synthesis = ForwardSynthesis(formula, partition, bs_, mode_);
+    auto result = synthesis.is_realizable();
+    if (result) {
+      strategy_ = synthesis.strategy();
+    }
+    return result;
+  }
+
+  std::vector<const Component *> non_invariants;
+  bool invariants_maintainable = true;
+  auto checker = get_default_realizability_checker();
+  for (const auto &component : components_) {
+    if (!component.is_invariant) {
+      non_invariants.push_back(&component);
+      continue;
+    }
+    auto move = checker->one_step_realizable(*component.formula(), partition);
+    if (move == std::nullopt) {
+      invariants_maintainable = false;
+    } else {
+      invariant_moves_.push_back(*move);
+    }
+  }
+  logger.info("{} non-invariant components, invariants maintainable: {}",
+              non_invariants.size(), invariants_maintainable);
+
+  if (invariants_maintainable && non_invariants.empty()) {
+    strategy_ = Strategy(partition.output_variables);
+    strategy_->add_move(0, complete_move_(move_t{}));
+    return true;
+  }
+  if (invariants_maintainable && non_invariants.size() == 1) {
+    auto synthesis = ForwardSynthesis(non_invariants[0]->formula(), partition,
+                                      bs_, mode_);
+    auto result = synthesis.is_realizable();
+    if (result) {
+      strategy_ = Strategy(partition.output_variables);
+      for (const auto &pair : synthesis.strategy().state_to_move) {
+        strategy_->add_move(pair.first, complete_move_(pair.second));
+      }
+    }
+    return result;
+  }
+  return race_(non_invariants);
+}
+
+move_t CompositionalSynthesis::complete_move_(const move_t &move) const {
+  // the components have disjoint outputs: at most one move sets a variable
+  std::map<std::string, VarValues> values;
+  for (const auto &invariant_move : invariant_moves_) {
+    for (const auto &pair : invariant_move) {
+      if (pair.second != VarValues::DONT_CARE) {
+        values[pair.first] = pair.second;
+      }
+    }
+  }
+  for (const auto &pair : move) {
+    if (pair.second != VarValues::DONT_CARE) {
+      values[pair.first] = pair.second;
+    }
+  }
+  move_t result;
+  for (const auto &variable : partition.output_variables) {
+    auto it = values.find(variable);
+    result.emplace_back(variable,
+                        it == values.end() ? VarValues::DONT_CARE : it->second);
+  }
+  return result;
+}
+
+bool CompositionalSynthesis::race_(
+    const std::vector<const Component *> &components) {
+  std::vector<ThreadedForwardSynthesis> tasks;
+  SharedQueue<std::pair<unsigned int, bool>> queue;
+  tasks.reserve(components.size() + 1);
+
+  // the formulas are preprocessed here, in the context of the formula, and
+  // each task copies its own into a private context
+  const unsigned int full_task_id = components.size();
+  for (unsigned int i = 0; i < components.size(); ++i) {
+    tasks.emplace_back(FrozenFormula(components[i]->formula()), partition,
+                       bs_, mode_, queue, i);
+  }
+  tasks.emplace_back(FrozenFormula(formula), partition, bs_, mode_, queue,
+                     full_task_id);
+  for (auto &task : tasks) {
+    task.start();
+  }
+
+  bool result;
+  while (true) {
+    auto task_result = queue.front();
+    queue.pop_front();
+    auto task_id = task_result.first;
+    logger.info("Task {} completed with result {}", task_id,
+                task_result.second);
+    if (task_id == full_task_id || !task_result.second) {
+      result = task_result.second;
+      break;
+    }
+    // a realizable component is not conclusive: keep waiting
+  }
+
+  for (auto &task : tasks) {
+    task.stop();
+  }
+  for (auto &task : tasks) {
+    task.join();
+  }
+  return result;
+}
+
+} // namespace core
+} // namespace nike
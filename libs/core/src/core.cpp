@@ -15,12 +15,15 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <future>
 #include <map>
 #include <nike/core.hpp>
 #include <nike/eval.hpp>
-#include <nike/logic/atom_visitor.hpp>
+#include <nike/logic/copy.hpp>
 #include <nike/logic/nnf.hpp>
 #include <nike/logic/replace.hpp>
+#include <nike/logic/serialize.hpp>
 #include <nike/logic/size.hpp>
 #include <nike/one_step_unrealizability.hpp>
 #include <nike/strip_next.hpp>
@@ -34,12 +37,106 @@
 namespace nike {
 namespace core {
 
+namespace {
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point start,
+                  std::chrono::high_resolution_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/*
+ * Make a logic::Context thread-safe for the lifetime of the object.
+ */
+class ThreadSafeScope {
+private:
+  logic::Context &context_;
+  bool previous_;
+
+public:
+  ThreadSafeScope(logic::Context &context, bool enable)
+      : context_{context}, previous_{context.is_thread_safe()} {
+    if (enable) {
+      context_.set_thread_safe(true);
+    }
+  }
+  ~ThreadSafeScope() { context_.set_thread_safe(previous_); }
+};
+
+/*
+ * Apply a transformation that distributes over conjunctions to each
+ * top-level conjunct, on several threads.
+ */
+template <typename Function>
+logic::ltlf_ptr transform_conjuncts(const logic::ltlf_ptr &formula,
+                                    size_t nb_threads, Function f) {
+  if (nb_threads <= 1 || !logic::is_a<logic::LTLfAnd>(*formula)) {
+    return f(*formula);
+  }
+  const auto &conjuncts = dynamic_cast<const logic::LTLfAnd &>(*formula).args;
+  logic::vec_ptr results(conjuncts.size());
+  utils::parallel_for(conjuncts.size(), nb_threads,
+                      [&](size_t i) { results[i] = f(*conjuncts[i]); });
+  return formula->ctx().make_and(results);
+}
+
+/*
+ * Free the AIG nodes built after the creation of the object, when it is
+ * destroyed: the nodes built below a state are dropped when the search
+ * leaves it.
+ */
+class AigScope {
+private:
+  logic::Aig &aig_;
+  size_t nb_nodes_;
+
+public:
+  explicit AigScope(logic::Aig &aig) : aig_{aig}, nb_nodes_{aig.nb_nodes()} {}
+  ~AigScope() { aig_.rollback(nb_nodes_); }
+};
+
+} // namespace
+
 bool ForwardSynthesis::is_realizable() {
+  if (nb_prefetch_threads_ > 0) {
+    context_.logger.info("Speculative prefetching with {} helper threads",
+                         nb_prefetch_threads_);
+    prefetcher_ = std::make_unique<SpeculativePrefetcher>(context_,
+                                                          nb_prefetch_threads_);
+  }
+  bool result;
   if (context_.mode == StateEquivalenceMode::BDD) {
-    return forward_synthesis_();
+    result = forward_synthesis_();
+  } else {
+    // equivalence mode HASH
+    result = ids_forward_synthesis_();
+  }
+  if (prefetcher_ != nullptr) {
+    context_.logger.info("Prefetched states: {}, cache hits: {}, misses: {}",
+                         prefetcher_->nb_submitted(), prefetcher_->nb_hits(),
+                         prefetcher_->nb_misses());
+    prefetcher_.reset();
+  }
+  context_.logger.info("Interned formulas: {}, hash collisions: {}",
+                       context_.ast_manager->nb_ids(),
+                       context_.ast_manager->nb_hash_collisions());
+  if (context_.ast_manager->is_simplifying()) {
+    auto &stats = context_.ast_manager->simplification_stats();
+    context_.logger.info("Simplifications: {}", stats.total());
+    for (size_t i = 0; i < logic::nb_simplification_rules; ++i) {
+      auto rule = static_cast<logic::SimplificationRule>(i);
+      context_.logger.info("  {}: {}",
+                           logic::simplification_rule_to_string(rule),
+                           stats.count(rule));
+    }
+  }
+  for (size_t i = 0; i < logic::nb_transformations; ++i) {
+    auto transformation = static_cast<logic::Transformation>(i);
+    const auto &memo_table = context_.ast_manager->memo_table(transformation);
+    context_.logger.info("Memo table of {}: {} hits, {} misses ({:.1f}%)",
+                         logic::transformation_to_string(transformation),
+                         memo_table.nb_hits(), memo_table.nb_misses(),
+                         100.0 * memo_table.hit_rate());
   }
-  // equivalence mode HASH
-  bool result = ids_forward_synthesis_();
   return result;
 }
 
@@ -67,6 +164,50 @@ bool ForwardSynthesis::forward_synthesis_() {
   context_.logger.info(
       "Started synthesis with mode {} and branching strategy {}",
       mode_to_string(context_.mode), branching_strategy_to_string(context_.bs));
+  if (shared_verdicts_ != nullptr) {
+    auto shared =
+        shared_verdicts_->find((*fingerprint_)(*context_.xnf_formula));
+    if (shared != SharedVerdict::UNKNOWN) {
+      context_.logger.info("Found shared verdict for the initial state");
+      return shared == SharedVerdict::REALIZABLE;
+    }
+  }
+  auto t_root_checks = std::chrono::high_resolution_clock::now();
+  auto root_verdict = root_checks_();
+  context_.preprocessing_times.root_checks_ms = elapsed_ms(
+      t_root_checks, std::chrono::high_resolution_clock::now());
+  context_.logger.info("Root checks: {} ms",
+                       context_.preprocessing_times.root_checks_ms);
+  if (root_verdict != std::nullopt) {
+    share_verdict_(context_.xnf_formula, root_verdict.value());
+    return root_verdict.value();
+  }
+
+  context_.logger.info("Starting the search...");
+
+  context_.logger.info("Starting first system move...");
+  auto is_realizable = system_move_(context_.xnf_formula);
+  share_verdict_(context_.xnf_formula, is_realizable);
+  context_.logger.info("Explored states: {}",
+                       context_.statistics_.nb_visited_nodes());
+
+  context_.logger.debug("Strategy: {}", strategy_to_string(context_.strategy));
+
+  return is_realizable;
+}
+
+std::optional<bool> ForwardSynthesis::root_checks_() {
+  // the checks only read the formula: with more than one preprocessing
+  // thread, the (usually most expensive) unrealizability check runs
+  // concurrently with the others
+  std::future<bool> concurrent_unrealizability;
+  if (context_.nb_preprocessing_threads > 1 &&
+      !context_.disable_one_step_unrealizability) {
+    concurrent_unrealizability = std::async(std::launch::async, [this]() {
+      return one_step_unrealizability(*context_.nnf_formula, context_);
+    });
+  }
+
   context_.logger.info("Check zero-step realizability");
   if (eval(*context_.nnf_formula)) {
     context_.logger.info("Zero-step realizability check successful");
@@ -88,7 +229,9 @@ bool ForwardSynthesis::forward_synthesis_() {
   if (!context_.disable_one_step_unrealizability) {
     context_.logger.info("Check one-step unrealizability");
     auto is_unrealizable =
-        one_step_unrealizability(*context_.nnf_formula, context_);
+        concurrent_unrealizability.valid()
+            ? concurrent_unrealizability.get()
+            : one_step_unrealizability(*context_.nnf_formula, context_);
     if (is_unrealizable) {
       context_.logger.info("One-step unrealizability check successful");
       return false;
@@ -96,17 +239,7 @@ bool ForwardSynthesis::forward_synthesis_() {
   } else {
     context_.logger.info("One-step unrealizability check disabled");
   }
-
-  context_.logger.info("Starting the search...");
-
-  context_.logger.info("Starting first system move...");
-  auto is_realizable = system_move_(context_.xnf_formula);
-  context_.logger.info("Explored states: {}",
-                       context_.statistics_.nb_visited_nodes());
-
-  context_.logger.debug("Strategy: {}", strategy_to_string(context_.strategy));
-
-  return is_realizable;
+  return std::nullopt;
 }
 
 std::map<std::string, size_t>
@@ -123,8 +256,27 @@ Context::compute_prop_to_id_map(const Closure &closure,
   }
   return result;
 }
+void ForwardSynthesis::collect_garbage_() {
+  if (gc_threshold_ == 0 || context_.shares_ast_manager) {
+    return;
+  }
+  auto nb_nodes = context_.ast_manager->nb_nodes();
+  if (nb_nodes < next_gc_) {
+    return;
+  }
+  context_.atom_sets.clear_cache();
+  context_.flat_formulas.clear();
+  if (prefetcher_ != nullptr) {
+    prefetcher_->release_verdicts();
+  }
+  auto nb_freed = context_.ast_manager->collect_garbage();
+  context_.logger.info("Freed {} of {} formulas", nb_freed, nb_nodes);
+  next_gc_ = std::max(gc_threshold_, 2 * (nb_nodes - nb_freed));
+}
+
 bool ForwardSynthesis::system_move_(const logic::ltlf_ptr &formula) {
   check_stopped();
+  collect_garbage_();
   context_.indentation += 1;
 
   //  context_.print_search_debug("Formula: {}", logic::to_string(*formula));
@@ -132,10 +284,13 @@ bool ForwardSynthesis::system_move_(const logic::ltlf_ptr &formula) {
   size_t bdd_formula_id = get_state_id(formula);
   if (context_.mode == StateEquivalenceMode::HASH) {
     // check if formula is too large
-    auto formulaSize = logic::size(*formula);
+    auto formulaSize =
+        context_.flat_passes
+            ? logic::size(context_.flat_formula(*formula))
+            : context_.size_visitor.apply(*formula);
     context_.print_search_debug("Formula size of {} is {}", bdd_formula_id,
                                 formulaSize);
-    if (logic::size(*formula) > context_.current_max_size_) {
+    if (formulaSize > context_.current_max_size_) {
       context_.print_search_debug("Formula size is {} which is greater than "
                                   "currently tolerated size {}",
                                   formulaSize, context_.current_max_size_);
@@ -167,6 +322,8 @@ bool ForwardSynthesis::system_move_(const logic::ltlf_ptr &formula) {
     }
   }
 
+  context_.keep_state(formula);
+
   if (context_.path.contains(bdd_formula_id)) {
     context_.print_search_debug("Loop detected for node {}, tagging the node",
                                 bdd_formula_id);
@@ -176,51 +333,68 @@ bool ForwardSynthesis::system_move_(const logic::ltlf_ptr &formula) {
     return false;
   }
 
-  if (eval(*formula)) {
-    context_.print_search_debug("{} accepting!", bdd_formula_id);
-    context_.discovered[bdd_formula_id] = true;
-    context_.indentation -= 1;
-    return true;
-  }
-
-  if (!context_.disable_one_step_realizability) {
-    auto one_step_realizability_result =
-        this->context_.realizability_checker->one_step_realizable(
-            *formula, context_.partition);
-    if (one_step_realizability_result != std::nullopt) {
-      context_.print_search_debug(
-          "One-step realizability success for node {}: SUCCESS",
-          bdd_formula_id);
-      context_.strategy.add_move(bdd_formula_id,
-                                 one_step_realizability_result.value());
-      context_.discovered[bdd_formula_id] = true;
+  if (shared_verdicts_ != nullptr) {
+    auto shared = shared_verdicts_->find((*fingerprint_)(*formula));
+    if (shared != SharedVerdict::UNKNOWN) {
+      bool is_success = shared == SharedVerdict::REALIZABLE;
+      // the verdict comes without a move: the state has none in the strategy
+      context_.print_search_debug("shared verdict for node {}: {}",
+                                  bdd_formula_id, is_success);
+      context_.discovered[bdd_formula_id] = is_success;
       context_.indentation -= 1;
-      return true;
+      return is_success;
     }
   }
 
-  if (!context_.disable_one_step_unrealizability) {
-    auto is_unrealizable = one_step_unrealizability(*formula, context_);
-    if (is_unrealizable) {
-      context_.print_search_debug(
-          "One-step unrealizability success for node {}: FAILURE",
-          bdd_formula_id);
-      context_.discovered[bdd_formula_id] = false;
-      context_.indentation -= 1;
-      return false;
-    }
+  auto verdict = state_verdict_(formula);
+  if (verdict.kind != StateVerdict::UNKNOWN) {
+    share_verdict_(formula,
+                   verdict.kind != StateVerdict::ONE_STEP_UNREALIZABLE);
+  }
+  switch (verdict.kind) {
+  case StateVerdict::ACCEPTING:
+    context_.print_search_debug("{} accepting!", bdd_formula_id);
+    context_.discovered[bdd_formula_id] = true;
+    context_.indentation -= 1;
+    return true;
+  case StateVerdict::ONE_STEP_REALIZABLE:
+    context_.print_search_debug(
+        "One-step realizability success for node {}: SUCCESS", bdd_formula_id);
+    context_.strategy.add_move(bdd_formula_id, verdict.move);
+    context_.discovered[bdd_formula_id] = true;
+    context_.indentation -= 1;
+    return true;
+  case StateVerdict::ONE_STEP_UNREALIZABLE:
+    context_.print_search_debug(
+        "One-step unrealizability success for node {}: FAILURE",
+        bdd_formula_id);
+    context_.discovered[bdd_formula_id] = false;
+    context_.indentation -= 1;
+    return false;
+  case StateVerdict::UNKNOWN:
+    break;
   }
 
   context_.path.push(bdd_formula_id);
-  logic::pl_ptr pl_formula = to_pl(*formula);
   std::stack<std::pair<std::string, VarValues>> system_move_stack;
-  auto result = find_system_move(bdd_formula_id, pl_formula, system_move_stack);
+  bool result;
+  if (context_.aig_branching) {
+    AigScope scope{context_.aig};
+    auto edge = logic::to_aig(context_.aig, *formula);
+    result = find_system_move(bdd_formula_id, edge, system_move_stack);
+  } else {
+    logic::pl_ptr pl_formula = to_pl(*formula);
+    result = find_system_move(bdd_formula_id, pl_formula, system_move_stack);
+  }
   if (result) {
     context_.print_search_debug("found winning strategy at state {}",
                                 bdd_formula_id);
     context_.print_search_debug("updating strategy: {} -> {}", bdd_formula_id,
                                 move_stack_to_string(system_move_stack));
     context_.strategy.add_move_from_stack(bdd_formula_id, system_move_stack);
+    // failures might be due to a loop on the current path: only successes
+    // are shared
+    share_verdict_(formula, true);
 
     if (context_.loop_tags.find(bdd_formula_id) != context_.loop_tags.end()) {
       context_.print_search_debug("trigger backward search to update "
@@ -239,23 +413,14 @@ bool ForwardSynthesis::system_move_(const logic::ltlf_ptr &formula) {
   return result;
 }
 
+template <typename Prop>
 bool ForwardSynthesis::find_system_move(
-    const size_t &formula_id, const logic::pl_ptr &pl_formula,
+    const size_t &formula_id, const Prop &pl_formula,
     std::stack<std::pair<std::string, VarValues>> &partial_system_move) {
   check_stopped();
   bool result;
-  auto allVars = logic::find_atoms(*pl_formula);
-  std::vector<logic::ast_ptr> controllableVars;
-  controllableVars.reserve(context_.partition.output_variables.size());
-  for (const auto &atom : allVars) {
-    if (std::find(
-            context_.partition.output_variables.begin(),
-            context_.partition.output_variables.end(),
-            std::static_pointer_cast<const logic::StringSymbol>(atom)->name) !=
-        context_.partition.output_variables.end()) {
-      controllableVars.push_back(atom);
-    }
-  }
+  auto controllableVars =
+      variables_(pl_formula) & context_.controllable_symbols;
 
   if (controllableVars.empty()) {
     // system choice is irrelevant
@@ -264,14 +429,14 @@ bool ForwardSynthesis::find_system_move(
     return result;
   }
   // pick first variable, and try to set it to 'true'
-  auto symbol = controllableVars[0];
+  auto symbol = context_.ast_manager->symbol(controllableVars.first());
   std::string varname =
       std::static_pointer_cast<const logic::StringSymbol>(symbol)->name;
   bool v = context_.branch_variable->choose(varname);
   context_.print_search_debug("branch on system variable {} ({})", varname,
                               std::to_string(v));
 
-  auto pl_formula_true = logic::replace({{symbol, v}}, *pl_formula);
+  auto pl_formula_true = assign_(pl_formula, symbol, v);
   partial_system_move.emplace(varname, VarValues::TRUE);
   result = find_system_move(formula_id, pl_formula_true, partial_system_move);
   if (result) {
@@ -286,7 +451,7 @@ bool ForwardSynthesis::find_system_move(
                               varname, std::to_string(v));
   context_.print_search_debug("branch on system variable {} ({})", varname,
                               std::to_string(not v));
-  auto pl_formula_false = logic::replace({{symbol, not v}}, *pl_formula);
+  auto pl_formula_false = assign_(pl_formula, symbol, not v);
   partial_system_move.emplace(varname, VarValues::FALSE);
   result = find_system_move(formula_id, pl_formula_false, partial_system_move);
   if (result) {
@@ -300,21 +465,11 @@ bool ForwardSynthesis::find_system_move(
   return false;
 }
 
-bool ForwardSynthesis::find_env_move_(const logic::pl_ptr &pl_formula) {
+template <typename Prop>
+bool ForwardSynthesis::find_env_move_(const Prop &pl_formula) {
   check_stopped();
   bool result;
-  auto allVars = logic::find_atoms(*pl_formula);
-  std::vector<logic::ast_ptr> envVars;
-  envVars.reserve(context_.partition.input_variables.size());
-  for (const auto &atom : allVars) {
-    if (std::find(
-            context_.partition.input_variables.begin(),
-            context_.partition.input_variables.end(),
-            std::static_pointer_cast<const logic::StringSymbol>(atom)->name) !=
-        context_.partition.input_variables.end()) {
-      envVars.push_back(atom);
-    }
-  }
+  auto envVars = variables_(pl_formula) & context_.uncontrollable_symbols;
 
   if (envVars.empty()) {
     // env choice is irrelevant -> go to next state
@@ -326,14 +481,14 @@ bool ForwardSynthesis::find_env_move_(const logic::pl_ptr &pl_formula) {
   }
 
   // pick first variable, and try to set it to 'true'
-  auto symbol = envVars[0];
+  auto symbol = context_.ast_manager->symbol(envVars.first());
   auto varname =
       std::static_pointer_cast<const logic::StringSymbol>(symbol)->name;
   bool v = context_.branch_variable->choose(varname);
   context_.print_search_debug("branch on env variable {} ({})", varname,
                               std::to_string(v));
 
-  auto pl_formula_true = logic::replace({{symbol, v}}, *pl_formula);
+  auto pl_formula_true = assign_(pl_formula, symbol, v);
   result = find_env_move_(pl_formula_true);
   if (!result) {
     context_.print_search_debug("branch on env variable {} ({}) FAILURE",
@@ -346,7 +501,7 @@ bool ForwardSynthesis::find_env_move_(const logic::pl_ptr &pl_formula) {
                               std::to_string(v));
   context_.print_search_debug("branch on env variable {} ({})", varname,
                               std::to_string(not v));
-  auto pl_formula_false = logic::replace({{symbol, not v}}, *pl_formula);
+  auto pl_formula_false = assign_(pl_formula, symbol, not v);
   result = find_env_move_(pl_formula_false);
   if (!result) {
     context_.print_search_debug("branch on env variable {} ({}) FAILURE",
@@ -358,18 +513,115 @@ bool ForwardSynthesis::find_env_move_(const logic::pl_ptr &pl_formula) {
   return true;
 }
 
-logic::ltlf_ptr
-ForwardSynthesis::next_state_formula_(const logic::pl_ptr &pl_formula) {
-  auto formula = to_ltlf(*pl_formula);
+template <typename Prop>
+bool ForwardSynthesis::speculative_env_move_(const Prop &pl_formula) {
+  // hand the successors to the helpers, so that they check the siblings
+  // while the search goes deep into the first one. The search itself is
+  // the one of find_env_move_, with the same branching choices and the
+  // same exit on the first losing env move. The successors of a state with
+  // too many env variables are not prefetched.
+  auto envVars = variables_(pl_formula) & context_.uncontrollable_symbols;
+  if (envVars.size() <= max_prefetched_env_variables) {
+    std::vector<logic::ltlf_ptr> next_state_formulas;
+    enumerate_env_successors_(pl_formula, next_state_formulas);
+    context_.print_search_debug("prefetch {} successor states",
+                                next_state_formulas.size());
+    for (const auto &next_formula : next_state_formulas) {
+      prefetcher_->submit(next_formula);
+    }
+  }
+  return find_env_move_(pl_formula);
+}
+
+template <typename Prop>
+void ForwardSynthesis::enumerate_env_successors_(
+    const Prop &pl_formula,
+    std::vector<logic::ltlf_ptr> &next_state_formulas) {
+  check_stopped();
+  auto envVars = variables_(pl_formula) & context_.uncontrollable_symbols;
+  if (envVars.empty()) {
+    next_state_formulas.push_back(next_state_formula_(pl_formula));
+    return;
+  }
+  // the branching strategy is not asked, so that it makes the same choices
+  // with or without prefetching
+  auto symbol = context_.ast_manager->symbol(envVars.first());
+  enumerate_env_successors_(assign_(pl_formula, symbol, true),
+                            next_state_formulas);
+  enumerate_env_successors_(assign_(pl_formula, symbol, false),
+                            next_state_formulas);
+}
+
+StateVerdict ForwardSynthesis::state_verdict_(const logic::ltlf_ptr &formula) {
+  if (prefetcher_ != nullptr) {
+    auto verdict = prefetcher_->lookup(*formula);
+    if (verdict != std::nullopt) {
+      return verdict.value();
+    }
+  }
+  const logic::FlatFormula *flat_formula = nullptr;
+  if (context_.flat_passes) {
+    flat_formula = &context_.flat_formula(*formula);
+  }
+  return check_state(*formula, context_, *context_.realizability_checker,
+                     flat_formula);
+}
+
+void ForwardSynthesis::set_shared_verdicts(SharedVerdictTable *table) {
+  shared_verdicts_ = table;
+  fingerprint_ = table != nullptr
+                     ? std::make_unique<StructuralFingerprint>(partition)
+                     : nullptr;
+}
+
+void ForwardSynthesis::share_verdict_(const logic::ltlf_ptr &formula,
+                                      bool is_realizable) {
+  if (shared_verdicts_ == nullptr) {
+    return;
+  }
+  shared_verdicts_->insert((*fingerprint_)(*formula),
+                           is_realizable ? SharedVerdict::REALIZABLE
+                                         : SharedVerdict::UNREALIZABLE);
+}
+
+template <typename Prop>
+logic::ltlf_ptr ForwardSynthesis::next_state_formula_(const Prop &pl_formula) {
+  auto formula = to_ltlf_(pl_formula);
   auto next_state_formula = xnf(*strip_next(*formula));
   return next_state_formula;
 }
 
+logic::AtomSet ForwardSynthesis::variables_(const logic::pl_ptr &pl_formula) {
+  return context_.atom_sets.apply(*pl_formula);
+}
+logic::AtomSet ForwardSynthesis::variables_(logic::Aig::Edge edge) {
+  return context_.aig.support(edge);
+}
+logic::pl_ptr ForwardSynthesis::assign_(const logic::pl_ptr &pl_formula,
+                                        const logic::ast_ptr &symbol,
+                                        bool value) {
+  return logic::replace({{symbol, value}}, *pl_formula);
+}
+logic::Aig::Edge ForwardSynthesis::assign_(logic::Aig::Edge edge,
+                                           const logic::ast_ptr &symbol,
+                                           bool value) {
+  return context_.aig.cofactor(edge, *symbol, value);
+}
+logic::ltlf_ptr ForwardSynthesis::to_ltlf_(const logic::pl_ptr &pl_formula) {
+  return logic::to_ltlf(*pl_formula);
+}
+logic::ltlf_ptr ForwardSynthesis::to_ltlf_(logic::Aig::Edge edge) {
+  return logic::to_ltlf(
+      *logic::to_pl(*context_.ast_manager, context_.aig, edge));
+}
+
 size_t ForwardSynthesis::get_state_id(const logic::ltlf_ptr &formula) {
   size_t bdd_formula_id;
   switch (context_.mode) {
   case StateEquivalenceMode::HASH:
-    bdd_formula_id = (size_t)formula.get();
+    // node ids are never reused, unlike addresses of collected nodes
+    bdd_formula_id =
+        formula->has_id() ? formula->id() : (size_t)formula.get();
     return bdd_formula_id;
   case StateEquivalenceMode::BDD:
     auto bdd = to_bdd(*formula, context_);
@@ -378,10 +630,11 @@ size_t ForwardSynthesis::get_state_id(const logic::ltlf_ptr &formula) {
   }
 }
 
-bool ForwardSynthesis::env_move_(const logic::pl_ptr &pl_formula) {
+template <typename Prop>
+bool ForwardSynthesis::env_move_(const Prop &pl_formula) {
   check_stopped();
   context_.indentation += 1;
-  auto formula = logic::to_ltlf(*pl_formula);
+  auto formula = to_ltlf_(pl_formula);
   auto bdd_formula_id = get_state_id(formula);
   context_.print_search_debug("visit env node {}", bdd_formula_id);
   if (context_.discovered.find(bdd_formula_id) != context_.discovered.end()) {
@@ -396,7 +649,9 @@ bool ForwardSynthesis::env_move_(const logic::pl_ptr &pl_formula) {
     context_.indentation -= 1;
     return is_success;
   }
-  auto result = find_env_move_(pl_formula);
+  context_.keep_state(formula);
+  auto result = prefetcher_ != nullptr ? speculative_env_move_(pl_formula)
+                                      : find_env_move_(pl_formula);
   if (result) {
     context_.print_search_debug("all env moves lead to success from state {}",
                                 bdd_formula_id);
@@ -446,36 +701,158 @@ void ForwardSynthesis::backprop_success(size_t &node_id, NodeType node_type) {
   }
 }
 
+FrozenFormula::FrozenFormula(const logic::ltlf_ptr &formula,
+                             size_t nb_threads)
+    : formula{formula} {
+  nb_threads = std::max<size_t>(nb_threads, 1);
+  ThreadSafeScope thread_safe_scope(formula->ctx(), nb_threads > 1);
+  auto t_start = std::chrono::high_resolution_clock::now();
+  nnf_formula = transform_conjuncts(
+      formula, nb_threads,
+      [](const logic::LTLfFormula &f) { return logic::to_nnf(f); });
+  // the factories leave out the rules that build new temporal subformulas:
+  // they can only be applied before the closure is computed
+  if (formula->ctx().is_simplifying()) {
+    nnf_formula = logic::simplify(*nnf_formula);
+  }
+  auto t_nnf = std::chrono::high_resolution_clock::now();
+  xnf_formula = transform_conjuncts(
+      nnf_formula, nb_threads,
+      [](const logic::LTLfFormula &f) { return xnf(f); });
+  auto t_xnf = std::chrono::high_resolution_clock::now();
+  xnf_size = logic::size(*xnf_formula);
+  closure = core::closure(*xnf_formula, nb_threads);
+  auto t_closure = std::chrono::high_resolution_clock::now();
+  times.nnf_ms = elapsed_ms(t_start, t_nnf);
+  times.xnf_ms = elapsed_ms(t_nnf, t_xnf);
+  times.closure_ms = elapsed_ms(t_xnf, t_closure);
+}
+
+FrozenFormula::FrozenFormula(logic::ltlf_ptr formula,
+                             logic::ltlf_ptr nnf_formula,
+                             logic::ltlf_ptr xnf_formula, Closure closure)
+    : formula{std::move(formula)}, nnf_formula{std::move(nnf_formula)},
+      xnf_formula{std::move(xnf_formula)}, closure{std::move(closure)},
+      xnf_size{logic::size(*this->xnf_formula)} {}
+
+// the roots of the file: the formula, its NNF and XNF, then the closure
+void write_frozen_formula(const std::string &filename,
+                          const FrozenFormula &frozen_formula) {
+  logic::vec_ptr roots{frozen_formula.formula, frozen_formula.nnf_formula,
+                       frozen_formula.xnf_formula};
+  roots.insert(roots.end(), frozen_formula.closure.begin_formulas(),
+               frozen_formula.closure.end_formulas());
+  logic::write_dag_to_file(filename, roots);
+}
+
+std::shared_ptr<const FrozenFormula>
+read_frozen_formula(logic::Context &context, const std::string &filename) {
+  auto roots = logic::read_dag_from_file(context, filename);
+  if (roots.size() < 3) {
+    throw std::runtime_error("not a frozen formula: " + filename);
+  }
+  auto closure_formulas = logic::vec_ptr(roots.begin() + 3, roots.end());
+  return std::make_shared<const FrozenFormula>(
+      roots[0], roots[1], roots[2], closure_of(closure_formulas));
+}
+
+std::shared_ptr<const FrozenFormula>
+copy_frozen_formula(logic::Context &context,
+                    const FrozenFormula &frozen_formula) {
+  // the nodes are already rewritten: copy them as they are, so that the
+  // closure still indexes the subformulas of the XNF
+  context.set_simplification(false);
+  logic::CopyVisitor copy{context};
+  auto formula = copy.apply(*frozen_formula.formula);
+  auto nnf_formula = copy.apply(*frozen_formula.nnf_formula);
+  auto xnf_formula = copy.apply(*frozen_formula.xnf_formula);
+  logic::vec_ptr closure_formulas;
+  for (auto it = frozen_formula.closure.begin_formulas();
+       it != frozen_formula.closure.end_formulas(); ++it) {
+    closure_formulas.push_back(copy.apply(**it));
+  }
+  context.set_simplification(frozen_formula.formula->ctx().is_simplifying());
+  auto result = std::make_shared<FrozenFormula>(
+      formula, nnf_formula, xnf_formula, closure_of(closure_formulas));
+  result->times = frozen_formula.times;
+  return result;
+}
+
 Context::Context(const logic::ltlf_ptr &formula,
                  const InputOutputPartition &partition, BranchingStrategy bs,
                  StateEquivalenceMode mode, double max_size_factor,
                  std::string logger_section_name,
                  bool disable_one_step_realizability,
-                 bool disable_one_step_unrealizability)
+                 bool disable_one_step_unrealizability,
+                 const CUDD::Cudd *manager, size_t nb_preprocessing_threads)
+    : Context(std::make_shared<const FrozenFormula>(formula,
+                                                    nb_preprocessing_threads),
+              partition, bs, mode, max_size_factor,
+              std::move(logger_section_name), disable_one_step_realizability,
+              disable_one_step_unrealizability, manager,
+              nb_preprocessing_threads) {
+  // the preprocessing is owned by this search only
+  shares_ast_manager = false;
+}
+
+Context::Context(std::shared_ptr<const FrozenFormula> frozen_formula,
+                 const InputOutputPartition &partition, BranchingStrategy bs,
+                 StateEquivalenceMode mode, double max_size_factor,
+                 std::string logger_section_name,
+                 bool disable_one_step_realizability,
+                 bool disable_one_step_unrealizability,
+                 const CUDD::Cudd *manager, size_t nb_preprocessing_threads)
     : logger{std::move(logger_section_name)},
       realizability_checker{get_default_realizability_checker()},
-      formula{formula}, partition{partition}, ast_manager{&formula->ctx()},
+      formula{frozen_formula->formula}, partition{partition},
+      ast_manager{&frozen_formula->formula->ctx()},
+      frozen_formula{std::move(frozen_formula)},
+      nnf_formula{this->frozen_formula->nnf_formula},
+      xnf_formula{this->frozen_formula->xnf_formula},
+      closure_{this->frozen_formula->closure},
+      manager_{manager != nullptr ? *manager : CUDD::Cudd()},
       strategy{partition.output_variables}, bs{bs}, mode{mode},
       disable_one_step_realizability{disable_one_step_realizability},
-      disable_one_step_unrealizability{disable_one_step_unrealizability} {
-
-  nnf_formula = logic::to_nnf(*formula);
-  xnf_formula = xnf(*nnf_formula);
-  current_max_size_ = logic::size(*xnf_formula) * max_size_factor;
-  Closure closure_object = closure(*xnf_formula);
-  closure_ = closure_object;
-  if (disable_one_step_realizability and disable_one_step_unrealizability and
-      mode != StateEquivalenceMode::BDD) {
+      disable_one_step_unrealizability{disable_one_step_unrealizability},
+      nb_preprocessing_threads{std::max<size_t>(nb_preprocessing_threads, 1)},
+      shares_ast_manager{true} {
+  auto t_start = std::chrono::high_resolution_clock::now();
+  current_max_size_ = this->frozen_formula->xnf_size * max_size_factor;
+  if (manager == nullptr and disable_one_step_realizability and
+      disable_one_step_unrealizability and mode != StateEquivalenceMode::BDD) {
     manager_ = CUDD::Cudd(closure_.nb_formulas(), 0, 4096);
     manager_.AutodynEnable();
   }
   prop_to_id = compute_prop_to_id_map(closure_, partition);
+  auto t_maps = std::chrono::high_resolution_clock::now();
+  preprocessing_times = this->frozen_formula->times;
+  preprocessing_times.prop_to_id_ms = elapsed_ms(t_start, t_maps);
+  logger.info("Preprocessing on {} threads: nnf {} ms, xnf {} ms, closure {} "
+              "ms, variable maps {} ms",
+              this->nb_preprocessing_threads, preprocessing_times.nnf_ms,
+              preprocessing_times.xnf_ms, preprocessing_times.closure_ms,
+              preprocessing_times.prop_to_id_ms);
   statistics_ = Statistics();
   branch_variable = get_branching_strategy(bs);
   initialie_maps_();
 }
 
 void Context::initialie_maps_() {
+  auto index_of = [this](const std::string &name) {
+    auto symbol = ast_manager->make_string_symbol(name);
+    variable_symbols.push_back(symbol);
+    return static_cast<const logic::StringSymbol &>(*symbol).index();
+  };
+  variable_symbols.clear();
+  controllable_symbols = logic::AtomSet();
+  for (const auto &name : partition.output_variables) {
+    controllable_symbols.insert(index_of(name));
+  }
+  uncontrollable_symbols = logic::AtomSet();
+  for (const auto &name : partition.input_variables) {
+    uncontrollable_symbols.insert(index_of(name));
+  }
+
   const auto nb_variables = closure_.nb_formulas() + closure_.nb_atoms();
   controllable_map =
       std::vector<int>(closure_.nb_formulas() + closure_.nb_atoms());
@@ -507,10 +884,29 @@ void Context::reset() {
   path = Path();
   prop_to_id = std::map<std::string, size_t>();
   discovered = std::map<size_t, bool>();
+  state_formulas.clear();
   loop_tags = std::set<long>();
   sdd_node_id_to_formula = std::map<long, logic::ltlf_ptr>();
-  formula_to_bdd_node = std::map<logic::ltlf_ptr, CUDD::BDD>();
+  formula_to_bdd_node.clear();
+  size_visitor.clear_cache();
+  atom_sets.clear_cache();
+  flat_formulas.clear();
   indentation = 0;
+  aig.clear();
+  if (!shares_ast_manager) {
+    ast_manager->collect_garbage();
+  }
+}
+
+const logic::FlatFormula &
+Context::flat_formula(const logic::LTLfFormula &formula) {
+  auto *cached = flat_formulas.find(formula);
+  if (cached != nullptr) {
+    return *cached;
+  }
+  auto &result = flat_formulas[formula];
+  result = logic::FlatFormula(formula);
+  return result;
 }
 
 void ForwardSynthesis::register_termination_callback(DD_THFP callback,
@@ -18,58 +18,97 @@
 #include <nike/eval.hpp>
 #include <nike/logic/ltlf.hpp>
 #include <numeric>
+#include <vector>
 
 namespace nike {
 namespace core {
 
-void EvalVisitor::visit(const logic::LTLfTrue &formula) { result = true; }
-void EvalVisitor::visit(const logic::LTLfFalse &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfPropTrue &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfPropFalse &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfAtom &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfNot &formula) {
+bool EvalVisitor::visit(const logic::LTLfTrue &) { return true; }
+bool EvalVisitor::visit(const logic::LTLfFalse &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfPropTrue &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfPropFalse &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfAtom &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfNot &) {
   logic::throw_expected_nnf();
 }
-void EvalVisitor::visit(const logic::LTLfPropositionalNot &formula) {
-  result = false;
+bool EvalVisitor::visit(const logic::LTLfPropositionalNot &) {
+  return false;
 }
-void EvalVisitor::visit(const logic::LTLfAnd &formula) {
-  result =
-      std::all_of(formula.args.begin(), formula.args.end(),
-                  [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
+bool EvalVisitor::visit(const logic::LTLfAnd &formula) {
+  return std::all_of(
+      formula.args.begin(), formula.args.end(),
+      [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
 }
-void EvalVisitor::visit(const logic::LTLfOr &formula) {
-  result =
-      std::any_of(formula.args.begin(), formula.args.end(),
-                  [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
+bool EvalVisitor::visit(const logic::LTLfOr &formula) {
+  return std::any_of(
+      formula.args.begin(), formula.args.end(),
+      [this](const logic::ltlf_ptr &arg) { return apply(*arg); });
 }
-void EvalVisitor::visit(const logic::LTLfImplies &formula) {
-  result = apply(*simplify(formula));
+bool EvalVisitor::visit(const logic::LTLfImplies &formula) {
+  return apply(*simplify(formula));
 }
-void EvalVisitor::visit(const logic::LTLfEquivalent &formula) {
-  result = apply(*simplify(formula));
+bool EvalVisitor::visit(const logic::LTLfEquivalent &formula) {
+  return apply(*simplify(formula));
 }
-void EvalVisitor::visit(const logic::LTLfXor &formula) {
-  result = apply(*simplify(formula));
-}
-void EvalVisitor::visit(const logic::LTLfNext &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfWeakNext &formula) { result = true; }
-void EvalVisitor::visit(const logic::LTLfUntil &formula) { result = false; }
-void EvalVisitor::visit(const logic::LTLfRelease &formula) { result = true; }
-void EvalVisitor::visit(const logic::LTLfEventually &formula) {
-  result = false;
-}
-void EvalVisitor::visit(const logic::LTLfAlways &formula) { result = true; }
-
-bool EvalVisitor::apply(const logic::LTLfFormula &formula) {
-  formula.accept(*this);
-  return result;
+bool EvalVisitor::visit(const logic::LTLfXor &formula) {
+  return apply(*simplify(formula));
 }
+bool EvalVisitor::visit(const logic::LTLfNext &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfWeakNext &) { return true; }
+bool EvalVisitor::visit(const logic::LTLfUntil &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfRelease &) { return true; }
+bool EvalVisitor::visit(const logic::LTLfEventually &) { return false; }
+bool EvalVisitor::visit(const logic::LTLfAlways &) { return true; }
 
 bool eval(const logic::LTLfFormula &formula) {
   EvalVisitor visitor{};
   return visitor.apply(formula);
 }
 
+bool eval(const logic::FlatFormula &formula) {
+  // the value of each record, or not_nnf if evaluating it would throw
+  enum : uint8_t { false_value, true_value, not_nnf };
+  const auto &nodes = formula.nodes();
+  std::vector<uint8_t> values(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto &node = nodes[i];
+    const auto *args = formula.args(node);
+    uint8_t value = false_value;
+    switch (node.type) {
+    case logic::TypeID::t_LTLfTrue:
+    case logic::TypeID::t_LTLfWeakNext:
+    case logic::TypeID::t_LTLfRelease:
+    case logic::TypeID::t_LTLfAlways:
+      value = true_value;
+      break;
+    case logic::TypeID::t_LTLfNot:
+    case logic::TypeID::t_LTLfImplies:
+    case logic::TypeID::t_LTLfEquivalent:
+    case logic::TypeID::t_LTLfXor:
+      value = not_nnf;
+      break;
+    case logic::TypeID::t_LTLfAnd:
+      // the first conjunct that is not true decides, as in std::all_of
+      value = true_value;
+      for (uint32_t j = 0; j < node.nb_args and value == true_value; ++j) {
+        value = values[args[j]];
+      }
+      break;
+    case logic::TypeID::t_LTLfOr:
+      for (uint32_t j = 0; j < node.nb_args and value == false_value; ++j) {
+        value = values[args[j]];
+      }
+      break;
+    default:
+      break;
+    }
+    values[i] = value;
+  }
+  if (values.empty() or values.back() == not_nnf) {
+    logic::throw_expected_nnf();
+  }
+  return values.back() == true_value;
+}
+
 } // namespace core
 } // namespace nike
@@ -69,7 +69,8 @@ bool MultithreadedSynthesis::is_realizable() {
   SharedQueue<std::pair<unsigned int, bool>> queue;
 
   logger.info("Initializing synthesis tasks");
-  auto formula_ = formula;
+  // the formula is preprocessed once, and each task copies the result
+  const FrozenFormula frozen_formula(formula);
   auto partition_ = partition;
   unsigned int thread_id = 0;
   for (auto &mode : modes) {
@@ -80,8 +81,8 @@ bool MultithreadedSynthesis::is_realizable() {
         break;
       }
 
-      tasks.emplace_back(formula_, partition_, branch_variable, mode, queue,
-                         thread_id);
+      tasks.emplace_back(frozen_formula, partition_, branch_variable, mode,
+                         queue, thread_id);
       tasks[thread_id].start();
       ++thread_id;
     }
@@ -23,20 +23,20 @@
 namespace nike {
 namespace core {
 
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfTrue &formula) {
-  result = manager.bddOne();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfTrue &) {
+  return manager.bddOne();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfFalse &formula) {
-  result = manager.bddZero();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfFalse &) {
+  return manager.bddZero();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfPropTrue &formula) {
-  result = manager.bddOne();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfPropTrue &) {
+  return manager.bddOne();
 }
-void BddOneStepRealizabilityVisitor::visit(
-    const logic::LTLfPropFalse &formula) {
-  result = manager.bddZero();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfPropFalse &) {
+  return manager.bddZero();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
+CUDD::BDD
+BddOneStepRealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
   bool controllable = false;
   assert(logic::is_a<const logic::StringSymbol>(*formula.symbol));
   auto prop =
@@ -47,10 +47,11 @@ void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
     controllable = true;
   }
 
-  auto varId = propToId.find(formula.shared_from_this());
+  CUDD::BDD result;
+  auto varId = propToId.find(logic::shared_from(formula));
   if (varId == propToId.end()) {
     result = manager.bddVar();
-    propToId[formula.shared_from_this()] = propToId.size();
+    propToId[logic::shared_from(formula)] = propToId.size();
     variableNames.push_back(prop);
     isVariableControllable.push_back(controllable);
   } else {
@@ -62,15 +63,16 @@ void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
   } else {
     controllablesConj = controllablesConj & result;
   }
+  return result;
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfNot &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfNot &) {
   logic::throw_expected_nnf();
 }
-void BddOneStepRealizabilityVisitor::visit(
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(
     const logic::LTLfPropositionalNot &formula) {
-  result = !apply(*formula.get_atom());
+  return !apply(*formula.get_atom());
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
   CUDD::BDD finalResult = manager.bddOne();
   for (const auto &subf : formula.args) {
     finalResult = finalResult & apply(*subf);
@@ -78,9 +80,9 @@ void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
       break;
     }
   }
-  result = finalResult;
+  return finalResult;
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfOr &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfOr &formula) {
   CUDD::BDD finalResult = manager.bddZero();
   for (const auto &subf : formula.args) {
     finalResult = finalResult | apply(*subf);
@@ -88,41 +90,38 @@ void BddOneStepRealizabilityVisitor::visit(const logic::LTLfOr &formula) {
       break;
     }
   }
-  result = finalResult;
+  return finalResult;
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfImplies &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfImplies &) {
   logic::throw_expected_nnf();
 }
-void BddOneStepRealizabilityVisitor::visit(
-    const logic::LTLfEquivalent &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfEquivalent &) {
   logic::throw_expected_nnf();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfXor &formula) {
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfXor &) {
   logic::throw_expected_nnf();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfNext &formula) {
-  result = manager.bddZero();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfNext &) {
+  return manager.bddZero();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfWeakNext &formula) {
-  result = manager.bddOne();
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(const logic::LTLfWeakNext &) {
+  return manager.bddOne();
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfUntil &formula) {
-  result = apply(**formula.args.rbegin());
+CUDD::BDD
+BddOneStepRealizabilityVisitor::visit(const logic::LTLfUntil &formula) {
+  return apply(**formula.args.rbegin());
 }
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfRelease &formula) {
-  result = apply(**formula.args.rbegin());
+CUDD::BDD
+BddOneStepRealizabilityVisitor::visit(const logic::LTLfRelease &formula) {
+  return apply(**formula.args.rbegin());
 }
-void BddOneStepRealizabilityVisitor::visit(
+CUDD::BDD BddOneStepRealizabilityVisitor::visit(
     const logic::LTLfEventually &formula) {
-  result = apply(*formula.arg);
-}
-void BddOneStepRealizabilityVisitor::visit(const logic::LTLfAlways &formula) {
-  result = apply(*formula.arg);
+  return apply(*formula.arg);
 }
-
-CUDD::BDD BddOneStepRealizabilityVisitor::apply(const logic::LTLfFormula &f) {
-  f.accept(*this);
-  return result;
+CUDD::BDD
+BddOneStepRealizabilityVisitor::visit(const logic::LTLfAlways &formula) {
+  return apply(*formula.arg);
 }
 
 std::optional<move_t> BddOneStepRealizabilityChecker::one_step_realizable(
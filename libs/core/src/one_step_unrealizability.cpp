@@ -21,19 +21,19 @@
 namespace nike {
 namespace core {
 
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfTrue &formula) {
-  result = manager.bddOne();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfTrue &) {
+  return manager.bddOne();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfFalse &formula) {
-  result = manager.bddZero();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfFalse &) {
+  return manager.bddZero();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfPropTrue &formula) {
-  result = manager.bddOne();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfPropTrue &) {
+  return manager.bddOne();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfPropFalse &formula) {
-  result = manager.bddZero();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfPropFalse &) {
+  return manager.bddZero();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
   bool controllable = false;
   if (logic::is_a<const logic::StringSymbol>(*formula.symbol)) {
     auto prop =
@@ -46,10 +46,11 @@ void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
     }
   }
 
-  auto varId = propToId.find(formula.shared_from_this());
+  CUDD::BDD result;
+  auto varId = propToId.find(logic::shared_from(formula));
   if (varId == propToId.end()) {
     result = manager.bddVar();
-    propToId[formula.shared_from_this()] = propToId.size();
+    propToId[logic::shared_from(formula)] = propToId.size();
   } else {
     result = manager.bddVar(varId->second);
   }
@@ -57,15 +58,16 @@ void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAtom &formula) {
   if (controllable) {
     controllablesConj = controllablesConj & result;
   }
+  return result;
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfNot &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfNot &) {
   logic::throw_expected_nnf();
 }
-void OneStepUnrealizabilityVisitor::visit(
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(
     const logic::LTLfPropositionalNot &formula) {
-  result = !apply(*formula.get_atom());
+  return !apply(*formula.get_atom());
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
   CUDD::BDD finalResult = manager.bddOne();
   for (const auto &subf : formula.args) {
     finalResult = finalResult & apply(*subf);
@@ -73,9 +75,9 @@ void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAnd &formula) {
       break;
     }
   }
-  result = finalResult;
+  return finalResult;
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfOr &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfOr &formula) {
   CUDD::BDD finalResult = manager.bddZero();
   for (const auto &subf : formula.args) {
     finalResult = finalResult | apply(*subf);
@@ -83,25 +85,25 @@ void OneStepUnrealizabilityVisitor::visit(const logic::LTLfOr &formula) {
       break;
     }
   }
-  result = finalResult;
+  return finalResult;
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfImplies &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfImplies &) {
   logic::throw_expected_nnf();
 }
-void OneStepUnrealizabilityVisitor::visit(
-    const logic::LTLfEquivalent &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfEquivalent &) {
   logic::throw_expected_nnf();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfXor &formula) {
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfXor &) {
   logic::throw_expected_nnf();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfNext &formula) {
-  result = manager.bddOne();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfNext &) {
+  return manager.bddOne();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfWeakNext &formula) {
-  result = manager.bddOne();
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfWeakNext &) {
+  return manager.bddOne();
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfUntil &formula) {
+CUDD::BDD
+OneStepUnrealizabilityVisitor::visit(const logic::LTLfUntil &formula) {
   CUDD::BDD finalResult = manager.bddZero();
   for (const auto &subf : formula.args) {
     finalResult = finalResult | apply(*subf);
@@ -109,22 +111,18 @@ void OneStepUnrealizabilityVisitor::visit(const logic::LTLfUntil &formula) {
       break;
     }
   }
-  result = finalResult;
-}
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfRelease &formula) {
-  result = apply(**formula.args.rbegin());
+  return finalResult;
 }
-void OneStepUnrealizabilityVisitor::visit(
-    const logic::LTLfEventually &formula) {
-  result = manager.bddOne();
+CUDD::BDD
+OneStepUnrealizabilityVisitor::visit(const logic::LTLfRelease &formula) {
+  return apply(**formula.args.rbegin());
 }
-void OneStepUnrealizabilityVisitor::visit(const logic::LTLfAlways &formula) {
-  result = apply(*formula.arg);
+CUDD::BDD OneStepUnrealizabilityVisitor::visit(const logic::LTLfEventually &) {
+  return manager.bddOne();
 }
-
-CUDD::BDD OneStepUnrealizabilityVisitor::apply(const logic::LTLfFormula &f) {
-  f.accept(*this);
-  return result;
+CUDD::BDD
+OneStepUnrealizabilityVisitor::visit(const logic::LTLfAlways &formula) {
+  return apply(*formula.arg);
 }
 
 bool one_step_unrealizability(const logic::LTLfFormula &f, Context &context) {
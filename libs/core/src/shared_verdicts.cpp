@@ -0,0 +1,222 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <nike/logic/ltlf.hpp>
+#include <nike/shared_verdicts.hpp>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace nike {
+namespace core {
+
+namespace {
+
+uint64_t mix(uint64_t x) {
+  // splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+Fingerprint combine(const Fingerprint &f, uint64_t value) {
+  return {mix(f.hi ^ (value + 0x9e3779b97f4a7c15ULL)),
+          mix(f.lo + value * 0xff51afd7ed558ccdULL + 0x632be59bd9b4e019ULL)};
+}
+
+Fingerprint combine(const Fingerprint &f, const Fingerprint &other) {
+  return combine(combine(f, other.hi), other.lo);
+}
+
+Fingerprint combine(const Fingerprint &f, const std::string &s) {
+  // FNV-1a
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (const auto &c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ULL;
+  }
+  return combine(combine(f, h), s.size());
+}
+
+} // namespace
+
+StructuralFingerprint::StructuralFingerprint(
+    const InputOutputPartition &partition) {
+  seed_ = {0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+  for (const auto &p : partition.input_variables) {
+    seed_ = combine(combine(seed_, p), uint64_t{1});
+  }
+  for (const auto &p : partition.output_variables) {
+    seed_ = combine(combine(seed_, p), uint64_t{2});
+  }
+}
+
+Fingerprint
+StructuralFingerprint::operator()(const logic::LTLfFormula &formula) {
+  if (const auto *memoized = memo_.find(formula)) {
+    return *memoized;
+  }
+  auto type = formula.get_type_code();
+  auto result = combine(seed_, static_cast<uint64_t>(type));
+  switch (type) {
+  case logic::TypeID::t_LTLfTrue:
+  case logic::TypeID::t_LTLfFalse:
+  case logic::TypeID::t_LTLfPropTrue:
+  case logic::TypeID::t_LTLfPropFalse:
+    break;
+  case logic::TypeID::t_LTLfAtom: {
+    const auto &atom = dynamic_cast<const logic::LTLfAtom &>(formula);
+    result = combine(
+        result,
+        std::static_pointer_cast<const logic::StringSymbol>(atom.symbol)->name);
+    break;
+  }
+  case logic::TypeID::t_LTLfPropNot:
+  case logic::TypeID::t_LTLfNot:
+  case logic::TypeID::t_LTLfNext:
+  case logic::TypeID::t_LTLfWeakNext:
+  case logic::TypeID::t_LTLfEventually:
+  case logic::TypeID::t_LTLfAlways:
+    result = combine(
+        result,
+        (*this)(*dynamic_cast<const logic::LTLfUnaryOp &>(formula).arg));
+    break;
+  case logic::TypeID::t_LTLfAnd:
+  case logic::TypeID::t_LTLfOr: {
+    // commutative: the order of the operands does not matter
+    const auto &args = dynamic_cast<const logic::LTLfBinaryOp &>(formula).args;
+    std::vector<Fingerprint> children;
+    children.reserve(args.size());
+    for (const auto &arg : args) {
+      children.push_back((*this)(*arg));
+    }
+    std::sort(children.begin(), children.end());
+    for (const auto &child : children) {
+      result = combine(result, child);
+    }
+    break;
+  }
+  case logic::TypeID::t_LTLfImplies:
+  case logic::TypeID::t_LTLfEquivalent:
+  case logic::TypeID::t_LTLfXor:
+  case logic::TypeID::t_LTLfUntil:
+  case logic::TypeID::t_LTLfRelease:
+    for (const auto &arg :
+         dynamic_cast<const logic::LTLfBinaryOp &>(formula).args) {
+      result = combine(result, (*this)(*arg));
+    }
+    break;
+  default:
+    throw std::invalid_argument("cannot fingerprint a non-LTLf node");
+  }
+  if (formula.has_id()) {
+    memo_[formula] = result;
+  }
+  return result;
+}
+
+SharedVerdictTable::SharedVerdictTable(size_t nb_slots)
+    : nb_slots_{std::max<size_t>(nb_slots, 1)},
+      mapping_size_{nb_slots_ * sizeof(Slot)} {
+  int fd = memfd_create("nike-verdicts", MFD_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("memfd_create failed: ") +
+                             std::strerror(errno));
+  }
+  if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+    auto error = errno;
+    close(fd);
+    throw std::runtime_error(std::string("ftruncate failed: ") +
+                             std::strerror(error));
+  }
+  void *mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(std::string("mmap failed: ") +
+                             std::strerror(errno));
+  }
+  slots_ = static_cast<Slot *>(mapping);
+  for (size_t i = 0; i < nb_slots_; ++i) {
+    new (&slots_[i]) Slot{{0}, {0}, {0}};
+  }
+}
+
+SharedVerdictTable::~SharedVerdictTable() { munmap(slots_, mapping_size_); }
+
+SharedVerdict SharedVerdictTable::find(const Fingerprint &key) const {
+  // zero marks an empty slot
+  auto hi = key.hi != 0 ? key.hi : 1;
+  auto start = static_cast<size_t>(key.lo % nb_slots_);
+  for (size_t i = 0; i < std::min(max_probes, nb_slots_); ++i) {
+    const auto &slot = slots_[(start + i) % nb_slots_];
+    auto slot_hi = slot.hi.load(std::memory_order_acquire);
+    if (slot_hi == 0) {
+      return SharedVerdict::UNKNOWN;
+    }
+    if (slot_hi != hi) {
+      continue;
+    }
+    auto verdict = slot.verdict.load(std::memory_order_acquire);
+    if (verdict != 0 && slot.lo.load(std::memory_order_relaxed) == key.lo) {
+      return static_cast<SharedVerdict>(verdict);
+    }
+  }
+  return SharedVerdict::UNKNOWN;
+}
+
+bool SharedVerdictTable::insert(const Fingerprint &key, SharedVerdict verdict) {
+  auto hi = key.hi != 0 ? key.hi : 1;
+  auto start = static_cast<size_t>(key.lo % nb_slots_);
+  for (size_t i = 0; i < std::min(max_probes, nb_slots_); ++i) {
+    auto &slot = slots_[(start + i) % nb_slots_];
+    uint64_t expected = 0;
+    if (slot.hi.compare_exchange_strong(expected, hi,
+                                        std::memory_order_acq_rel)) {
+      slot.lo.store(key.lo, std::memory_order_relaxed);
+      slot.verdict.store(static_cast<uint32_t>(verdict),
+                         std::memory_order_release);
+      return true;
+    }
+    if (expected == hi &&
+        slot.verdict.load(std::memory_order_acquire) != 0 &&
+        slot.lo.load(std::memory_order_relaxed) == key.lo) {
+      // already there
+      return false;
+    }
+  }
+  return false;
+}
+
+size_t SharedVerdictTable::size() const {
+  size_t result = 0;
+  for (size_t i = 0; i < nb_slots_; ++i) {
+    result += slots_[i].verdict.load(std::memory_order_relaxed) != 0;
+  }
+  return result;
+}
+
+} // namespace core
+} // namespace nike
@@ -0,0 +1,162 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/core.hpp>
+#include <nike/eval.hpp>
+#include <nike/one_step_unrealizability.hpp>
+#include <nike/speculative.hpp>
+
+namespace nike {
+namespace core {
+
+StateVerdict check_state(const logic::LTLfFormula &formula, Context &context,
+                         OneStepRealizabilityChecker &checker,
+                         const logic::FlatFormula *flat_formula) {
+  StateVerdict verdict;
+  if (flat_formula != nullptr ? eval(*flat_formula) : eval(formula)) {
+    verdict.kind = StateVerdict::ACCEPTING;
+    return verdict;
+  }
+  if (!context.disable_one_step_realizability) {
+    auto move = checker.one_step_realizable(formula, context.partition);
+    if (move != std::nullopt) {
+      verdict.kind = StateVerdict::ONE_STEP_REALIZABLE;
+      verdict.move = std::move(move.value());
+      return verdict;
+    }
+  }
+  if (!context.disable_one_step_unrealizability &&
+      one_step_unrealizability(formula, context)) {
+    verdict.kind = StateVerdict::ONE_STEP_UNREALIZABLE;
+  }
+  return verdict;
+}
+
+bool VerdictCache::reserve(const logic::ltlf_ptr &formula) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.emplace(formula.get(), Entry{formula}).second;
+}
+
+void VerdictCache::insert(const logic::ltlf_ptr &formula,
+                          StateVerdict verdict) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &entry = entries_[formula.get()];
+  entry.formula = formula;
+  entry.verdict = std::move(verdict);
+  entry.ready = true;
+}
+
+std::optional<StateVerdict>
+VerdictCache::find(const logic::LTLfFormula &formula) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(&formula);
+  if (it == entries_.end() || !it->second.ready) {
+    return std::nullopt;
+  }
+  return it->second.verdict;
+}
+
+std::optional<StateVerdict>
+VerdictCache::take(const logic::LTLfFormula &formula) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(&formula);
+  if (it == entries_.end() || !it->second.ready) {
+    return std::nullopt;
+  }
+  auto result = std::move(it->second.verdict);
+  entries_.erase(it);
+  return result;
+}
+
+size_t VerdictCache::release_ready() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t nb_released = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.ready) {
+      it = entries_.erase(it);
+      ++nb_released;
+    } else {
+      ++it;
+    }
+  }
+  return nb_released;
+}
+
+size_t VerdictCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+SpeculativePrefetcher::SpeculativePrefetcher(Context &context,
+                                             size_t nb_threads)
+    : context_{context} {
+  helpers_.reserve(nb_threads);
+  for (size_t i = 0; i < nb_threads; ++i) {
+    helpers_.emplace_back(&SpeculativePrefetcher::helper_loop_, this);
+  }
+}
+
+SpeculativePrefetcher::~SpeculativePrefetcher() {
+  // a null formula tells a helper to terminate
+  for (size_t i = 0; i < helpers_.size(); ++i) {
+    pending_.push_back(nullptr);
+  }
+  for (auto &t : helpers_) {
+    t.join();
+  }
+}
+
+void SpeculativePrefetcher::submit(const logic::ltlf_ptr &formula) {
+  if (nb_pending_ >= max_pending || !cache_.reserve(formula)) {
+    return;
+  }
+  ++nb_submitted_;
+  ++nb_pending_;
+  pending_.push_back(formula);
+}
+
+std::optional<StateVerdict>
+SpeculativePrefetcher::lookup(const logic::LTLfFormula &formula) {
+  auto result = cache_.take(formula);
+  if (result == std::nullopt) {
+    ++nb_misses_;
+  } else {
+    ++nb_hits_;
+  }
+  return result;
+}
+
+void SpeculativePrefetcher::helper_loop_() {
+  auto checker = get_default_realizability_checker();
+  logic::ltlf_ptr formula;
+  while (true) {
+    pending_.wait_pop_front(formula);
+    if (formula == nullptr) {
+      return;
+    }
+    --nb_pending_;
+    try {
+      cache_.insert(formula, check_state(*formula, context_, *checker));
+    } catch (std::exception &) {
+      // the search will run the checks itself
+    }
+    formula.reset();
+  }
+}
+
+} // namespace core
+} // namespace nike
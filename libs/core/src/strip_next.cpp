@@ -20,106 +20,124 @@
 
 namespace nike {
 namespace core {
-void StripNextVisitor::visit(const logic::LTLfTrue &formula) {
-  result = formula.ctx().make_tt();
+
+namespace {
+logic::vec_ptr arguments(const logic::LTLfBinaryOp &formula,
+                         const logic::ltlf_ptr *args) {
+  return logic::vec_ptr(args, args + formula.args.size());
 }
-void StripNextVisitor::visit(const logic::LTLfFalse &formula) {
-  result = formula.ctx().make_ff();
+} // namespace
+
+void StripNextVisitor::expand(const logic::LTLfFormula &f, size_t) {
+  // the arguments of the Next subformulas are kept as they are
+  switch (f.type_code()) {
+  case logic::TypeID::t_LTLfAnd:
+  case logic::TypeID::t_LTLfOr:
+  case logic::TypeID::t_LTLfImplies:
+  case logic::TypeID::t_LTLfEquivalent:
+  case logic::TypeID::t_LTLfXor:
+    logic::for_each_argument(
+        f, [this](const logic::LTLfFormula &arg) { push(arg); });
+    break;
+  default:
+    break;
+  }
 }
-void StripNextVisitor::visit(const logic::LTLfPropTrue &formula) {
-  result = formula.ctx().make_prop_true();
+
+logic::ltlf_ptr StripNextVisitor::combine(const logic::LTLfFormula &f, size_t,
+                                          const logic::ltlf_ptr *args) {
+  return logic::dispatch(
+      f, [this, args](const auto &formula) { return combine_(formula, args); });
 }
-void StripNextVisitor::visit(const logic::LTLfPropFalse &formula) {
-  result = formula.ctx().make_prop_false();
+
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfTrue &formula,
+                                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_tt();
 }
-void StripNextVisitor::visit(const logic::LTLfAtom &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfFalse &formula,
+                                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_ff();
 }
-void StripNextVisitor::visit(const logic::LTLfNot &formula) {
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfPropTrue &formula,
+                                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_prop_true();
+}
+logic::ltlf_ptr
+StripNextVisitor::combine_(const logic::LTLfPropFalse &formula,
+                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_prop_false();
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfAtom &formula,
+                                           const logic::ltlf_ptr *) {
+  return logic::shared_from(formula);
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfNot &,
+                                           const logic::ltlf_ptr *) {
   logic::throw_expected_nnf();
 }
-void StripNextVisitor::visit(const logic::LTLfPropositionalNot &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-  ;
-}
-void StripNextVisitor::visit(const logic::LTLfAnd &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_and(container);
-      });
-}
-void StripNextVisitor::visit(const logic::LTLfOr &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_or(container);
-      });
-}
-void StripNextVisitor::visit(const logic::LTLfImplies &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_implies(container);
-      });
-}
-void StripNextVisitor::visit(const logic::LTLfEquivalent &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_equivalent(container);
-      });
-}
-void StripNextVisitor::visit(const logic::LTLfXor &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_xor(container);
-      });
-}
-void StripNextVisitor::visit(const logic::LTLfNext &formula) {
-  result = formula.ctx().make_and({formula.arg, formula.ctx().make_not_end()});
-}
-void StripNextVisitor::visit(const logic::LTLfWeakNext &formula) {
-  result = formula.ctx().make_or({formula.arg, formula.ctx().make_end()});
-}
-void StripNextVisitor::visit(const logic::LTLfUntil &formula) {
+logic::ltlf_ptr
+StripNextVisitor::combine_(const logic::LTLfPropositionalNot &formula,
+                           const logic::ltlf_ptr *) {
+  return logic::shared_from(formula);
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfAnd &formula,
+                                           const logic::ltlf_ptr *args) {
+  return formula.ctx().make_and(arguments(formula, args));
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfOr &formula,
+                                           const logic::ltlf_ptr *args) {
+  return formula.ctx().make_or(arguments(formula, args));
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfImplies &formula,
+                                           const logic::ltlf_ptr *args) {
+  return formula.ctx().make_implies(arguments(formula, args));
+}
+logic::ltlf_ptr
+StripNextVisitor::combine_(const logic::LTLfEquivalent &formula,
+                           const logic::ltlf_ptr *args) {
+  return formula.ctx().make_equivalent(arguments(formula, args));
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfXor &formula,
+                                           const logic::ltlf_ptr *args) {
+  return formula.ctx().make_xor(arguments(formula, args));
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfNext &formula,
+                                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_and({formula.arg, formula.ctx().make_not_end()});
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfWeakNext &formula,
+                                           const logic::ltlf_ptr *) {
+  return formula.ctx().make_or({formula.arg, formula.ctx().make_end()});
+}
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfUntil &,
+                                           const logic::ltlf_ptr *) {
   logic::throw_expected_xnf();
 }
-void StripNextVisitor::visit(const logic::LTLfRelease &formula) {
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfRelease &,
+                                           const logic::ltlf_ptr *) {
   logic::throw_expected_xnf();
 }
-void StripNextVisitor::visit(const logic::LTLfEventually &formula) {
+logic::ltlf_ptr
+StripNextVisitor::combine_(const logic::LTLfEventually &formula,
+                           const logic::ltlf_ptr *) {
   auto not_end = formula.ctx().make_not_end();
   if (*not_end == formula) {
-    result = formula.ctx().make_tt();
-    return;
+    return formula.ctx().make_tt();
   }
   logic::throw_expected_xnf();
 }
-void StripNextVisitor::visit(const logic::LTLfAlways &formula) {
+logic::ltlf_ptr StripNextVisitor::combine_(const logic::LTLfAlways &formula,
+                                           const logic::ltlf_ptr *) {
   auto end = formula.ctx().make_end();
   if (*end == formula) {
-    result = formula.ctx().make_ff();
-    return;
+    return formula.ctx().make_ff();
   }
   logic::throw_expected_xnf();
 }
 
-logic::ltlf_ptr StripNextVisitor::apply(const logic::LTLfFormula &formula) {
-  formula.accept(*this);
-  return result;
-}
-
 logic::ltlf_ptr strip_next(const logic::LTLfFormula &formula) {
-  auto visitor = StripNextVisitor{};
+  auto visitor = StripNextVisitor{
+      &formula.ctx().memo_table(logic::Transformation::strip_next)};
   return visitor.apply(formula);
 }
 
@@ -0,0 +1,384 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <nike/supervisor.hpp>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace nike {
+namespace core {
+
+namespace {
+
+// fixed-size part of a result, as sent by a worker
+struct WireResult {
+  int32_t status;
+  uint64_t nb_visited_nodes;
+  double parsing_time_ms;
+  double synthesis_time_ms;
+  double total_time_ms;
+  uint64_t error_size;
+};
+
+bool write_all(int fd, const void *data, size_t size) {
+  auto bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    auto n = write(fd, bytes, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    bytes += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool read_all(int fd, void *data, size_t size) {
+  auto bytes = static_cast<char *>(data);
+  while (size > 0) {
+    auto n = read(fd, bytes, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    bytes += n;
+    size -= n;
+  }
+  return true;
+}
+
+void close_fd(int &fd) {
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+// bound the address space the calling process can add to what it maps
+// now: allocations beyond it fail at once, instead of growing until the
+// next poll of the supervisor
+void limit_address_space(size_t limit) {
+  std::ifstream statm("/proc/self/statm");
+  size_t size_pages = 0;
+  statm >> size_pages;
+  auto size = static_cast<rlim_t>(size_pages) *
+                  static_cast<rlim_t>(sysconf(_SC_PAGESIZE)) +
+              limit;
+  rlimit bound{size, size};
+  setrlimit(RLIMIT_AS, &bound);
+}
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::high_resolution_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+size_t resident_memory(pid_t pid) {
+  std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+  size_t size_pages = 0;
+  size_t resident_pages = 0;
+  if (!(statm >> size_pages >> resident_pages)) {
+    return 0;
+  }
+  return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+Supervisor::Supervisor(std::vector<BatchInstance> instances,
+                       SupervisorOptions options)
+    : instances_{std::move(instances)}, options_{options},
+      logger{"supervisor"} {
+  if (options_.batch.nb_workers == 0) {
+    throw std::invalid_argument("number of workers must be positive");
+  }
+}
+
+void Supervisor::spawn_(Worker &worker, SharedVerdictTable &table) {
+  int task_pipe[2];
+  int result_pipe[2];
+  if (pipe(task_pipe) != 0) {
+    throw std::runtime_error(std::string("pipe failed: ") +
+                             std::strerror(errno));
+  }
+  if (pipe(result_pipe) != 0) {
+    auto error = errno;
+    close(task_pipe[0]);
+    close(task_pipe[1]);
+    throw std::runtime_error(std::string("pipe failed: ") +
+                             std::strerror(error));
+  }
+  // do not let the child inherit unflushed output
+  std::cout.flush();
+  std::cerr.flush();
+  auto pid = fork();
+  if (pid < 0) {
+    auto error = errno;
+    close(task_pipe[0]);
+    close(task_pipe[1]);
+    close(result_pipe[0]);
+    close(result_pipe[1]);
+    throw std::runtime_error(std::string("fork failed: ") +
+                             std::strerror(error));
+  }
+  if (pid == 0) {
+    close(task_pipe[1]);
+    close(result_pipe[0]);
+    for (auto &other : workers_) {
+      close_fd(other.task_fd);
+      close_fd(other.result_fd);
+    }
+    worker_main_(task_pipe[0], result_pipe[1], table);
+  }
+  close(task_pipe[0]);
+  close(result_pipe[1]);
+  worker.pid = pid;
+  worker.task_fd = task_pipe[1];
+  worker.result_fd = result_pipe[0];
+  worker.busy = false;
+  logger.info("Worker {} started with pid {}", worker.id, pid);
+}
+
+void Supervisor::worker_main_(int task_fd, int result_fd,
+                              SharedVerdictTable &table) {
+  int exit_code = 0;
+  try {
+    logic::Context context;
+    CUDD::Cudd manager;
+    if (options_.memory_limit_mb != 0) {
+      limit_address_space(options_.memory_limit_mb * 1024 * 1024);
+    }
+    uint64_t index;
+    while (read_all(task_fd, &index, sizeof(index))) {
+      auto result = solve_batch_instance(instances_[index], options_.batch,
+                                         context, manager, &table);
+      // CUDD reports a failed allocation with an exception of its own
+      if (result.status == BatchStatus::ERROR &&
+          manager.ReadErrorCode() == CUDD_MEMORY_OUT) {
+        result.status = BatchStatus::MEMOUT;
+      }
+      WireResult wire{static_cast<int32_t>(result.status),
+                      result.nb_visited_nodes,
+                      result.parsing_time_ms,
+                      result.synthesis_time_ms,
+                      result.total_time_ms,
+                      result.error_message.size()};
+      if (!write_all(result_fd, &wire, sizeof(wire)) ||
+          !write_all(result_fd, result.error_message.data(),
+                     result.error_message.size())) {
+        break;
+      }
+      // the supervisor replaces a worker that ran out of memory
+      if (result.status == BatchStatus::MEMOUT) {
+        break;
+      }
+    }
+  } catch (...) {
+    exit_code = 1;
+  }
+  close(task_fd);
+  close(result_fd);
+  // skip the destructors and atexit handlers of the parent's state
+  _exit(exit_code);
+}
+
+void Supervisor::reap_(Worker &worker) {
+  close_fd(worker.task_fd);
+  close_fd(worker.result_fd);
+  if (worker.pid > 0) {
+    int status;
+    while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    worker.pid = -1;
+  }
+  worker.busy = false;
+}
+
+BatchResult Supervisor::failed_result_(const Worker &worker,
+                                       BatchStatus status,
+                                       const std::string &message) const {
+  BatchResult result;
+  result.index = worker.index;
+  result.worker_id = worker.id;
+  result.formula_file = instances_[worker.index].formula_file;
+  result.partition_file = instances_[worker.index].partition_file;
+  result.status = status;
+  result.error_message = message;
+  result.total_time_ms = elapsed_ms(worker.started);
+  result.synthesis_time_ms = result.total_time_ms;
+  return result;
+}
+
+void Supervisor::run(const BatchSynthesis::callback_t &callback) {
+  if (instances_.empty()) {
+    return;
+  }
+  SharedVerdictTable table(options_.shared_table_slots);
+  // a worker might die while we write to its pipe
+  struct sigaction ignore_sigpipe {};
+  struct sigaction old_sigpipe {};
+  ignore_sigpipe.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &ignore_sigpipe, &old_sigpipe);
+
+  auto nb_workers = std::min(options_.batch.nb_workers, instances_.size());
+  logger.info("Solving {} instances with {} worker processes",
+              instances_.size(), nb_workers);
+  const size_t memory_limit = options_.memory_limit_mb * 1024 * 1024;
+  workers_ = std::vector<Worker>(nb_workers);
+  for (unsigned int i = 0; i < nb_workers; ++i) {
+    workers_[i].id = i;
+    spawn_(workers_[i], table);
+  }
+
+  size_t next = 0;
+  size_t nb_done = 0;
+  auto dispatch = [&](Worker &worker) {
+    while (!worker.busy && next < instances_.size()) {
+      uint64_t index = next++;
+      worker.index = index;
+      worker.started = std::chrono::high_resolution_clock::now();
+      worker.busy = true;
+      if (!write_all(worker.task_fd, &index, sizeof(index))) {
+        reap_(worker);
+        callback(failed_result_(worker, BatchStatus::ERROR,
+                                "worker terminated unexpectedly"));
+        ++nb_done;
+        spawn_(worker, table);
+      }
+    }
+  };
+  auto replace = [&](Worker &worker, BatchStatus status,
+                     const std::string &message) {
+    if (worker.pid > 0 && status == BatchStatus::MEMOUT) {
+      kill(worker.pid, SIGKILL);
+    }
+    reap_(worker);
+    callback(failed_result_(worker, status, message));
+    ++nb_done;
+    if (next < instances_.size()) {
+      spawn_(worker, table);
+    }
+  };
+
+  for (auto &worker : workers_) {
+    dispatch(worker);
+  }
+  while (nb_done < instances_.size()) {
+    std::vector<pollfd> fds;
+    std::vector<Worker *> polled;
+    for (auto &worker : workers_) {
+      if (worker.busy) {
+        fds.push_back({worker.result_fd, POLLIN, 0});
+        polled.push_back(&worker);
+      }
+    }
+    auto n = poll(fds.data(), fds.size(),
+                  static_cast<int>(options_.poll_interval_ms));
+    if (n < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("poll failed: ") +
+                               std::strerror(errno));
+    }
+
+    for (size_t i = 0; n > 0 && i < fds.size(); ++i) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      auto &worker = *polled[i];
+      WireResult wire{};
+      std::string error_message;
+      bool ok = read_all(worker.result_fd, &wire, sizeof(wire));
+      if (ok) {
+        error_message.resize(wire.error_size);
+        ok = read_all(worker.result_fd, &error_message[0], wire.error_size);
+      }
+      if (!ok) {
+        replace(worker, BatchStatus::ERROR, "worker terminated unexpectedly");
+        dispatch(worker);
+        continue;
+      }
+      BatchResult result;
+      result.index = worker.index;
+      result.worker_id = worker.id;
+      result.formula_file = instances_[worker.index].formula_file;
+      result.partition_file = instances_[worker.index].partition_file;
+      result.status = static_cast<BatchStatus>(wire.status);
+      result.error_message = std::move(error_message);
+      result.nb_visited_nodes = wire.nb_visited_nodes;
+      result.parsing_time_ms = wire.parsing_time_ms;
+      result.synthesis_time_ms = wire.synthesis_time_ms;
+      result.total_time_ms = wire.total_time_ms;
+      worker.busy = false;
+      callback(result);
+      ++nb_done;
+      if (result.status == BatchStatus::MEMOUT) {
+        reap_(worker);
+        if (next < instances_.size()) {
+          spawn_(worker, table);
+        }
+      }
+      dispatch(worker);
+    }
+
+    if (memory_limit == 0) {
+      continue;
+    }
+    for (auto &worker : workers_) {
+      if (!worker.busy) {
+        continue;
+      }
+      auto memory = resident_memory(worker.pid);
+      if (memory > memory_limit) {
+        logger.info("Worker {} uses {} bytes, killing it", worker.id, memory);
+        replace(worker, BatchStatus::MEMOUT,
+                "memory limit of " + std::to_string(options_.memory_limit_mb) +
+                    " MB exceeded");
+        dispatch(worker);
+      }
+    }
+  }
+
+  // closing the task pipes makes the idle workers exit
+  for (auto &worker : workers_) {
+    reap_(worker);
+  }
+  workers_.clear();
+  nb_shared_verdicts_ = table.size();
+  logger.info("Shared verdicts: {}", nb_shared_verdicts_);
+  sigaction(SIGPIPE, &old_sigpipe, nullptr);
+}
+
+void Supervisor::run(std::ostream &out) {
+  run([&out](const BatchResult &result) {
+    out << batch_result_to_json(result) << std::endl;
+  });
+}
+
+} // namespace core
+} // namespace nike
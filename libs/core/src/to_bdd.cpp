@@ -97,21 +97,19 @@ void ToBddVisitor::visit(const logic::LTLfAlways &formula) {
 }
 
 CUDD::BDD ToBddVisitor::apply(const logic::LTLfFormula &formula) {
-  auto formula_ptr = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-  auto cached_result = context_.formula_to_bdd_node.find(formula_ptr);
-  if (cached_result != context_.formula_to_bdd_node.end()) {
-    return cached_result->second;
+  auto cached_result = context_.formula_to_bdd_node.find(formula);
+  if (cached_result != nullptr) {
+    return *cached_result;
   }
   formula.accept(*this);
-  context_.formula_to_bdd_node[formula_ptr] = result;
+  if (formula.has_id()) {
+    context_.formula_to_bdd_node.insert_or_assign(formula, result);
+  }
   return result;
 }
 
 CUDD::BDD ToBddVisitor::get_bdd_var(const logic::LTLfFormula &formula) {
-  auto varIndex = context_.closure_.get_id(
-      std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this()));
+  auto varIndex = context_.closure_.get_id(formula);
   return context_.manager_.bddVar();
 }
 
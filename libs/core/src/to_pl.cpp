@@ -24,92 +24,131 @@
 namespace nike {
 namespace logic {
 
-void ToPLVisitor::visit(const logic::LTLfTrue &f) {
-  result = f.ctx().make_literal(f.shared_from_this(), false);
+void ToPLVisitor::expand(const LTLfFormula &f, size_t) {
+  // only the boolean operators of the XNF are translated: the temporal
+  // subformulas become literals
+  auto type = f.type_code();
+  if (type == TypeID::t_LTLfAnd or type == TypeID::t_LTLfOr) {
+    for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
+  }
 }
-void ToPLVisitor::visit(const logic::LTLfFalse &f) {
-  result = f.ctx().make_literal(f.shared_from_this(), false);
+
+pl_ptr ToPLVisitor::combine(const LTLfFormula &f, size_t, const pl_ptr *args) {
+  return dispatch(
+      f, [this, args](const auto &formula) { return combine_(formula, args); });
 }
-void ToPLVisitor::visit(const logic::LTLfPropTrue &f) {
-  auto not_end = f.ctx().make_not_end();
-  result = f.ctx().make_literal(f.shared_from_this(), false);
+
+pl_ptr ToPLVisitor::combine_(const logic::LTLfTrue &f, const pl_ptr *) {
+  return f.ctx().make_literal(logic::shared_from(f), false);
+}
+pl_ptr ToPLVisitor::combine_(const logic::LTLfFalse &f, const pl_ptr *) {
+  return f.ctx().make_literal(logic::shared_from(f), false);
 }
-void ToPLVisitor::visit(const logic::LTLfPropFalse &f) {
-  result = f.ctx().make_false();
+pl_ptr ToPLVisitor::combine_(const logic::LTLfPropTrue &f, const pl_ptr *) {
+  return f.ctx().make_literal(logic::shared_from(f), false);
 }
-void ToPLVisitor::visit(const logic::LTLfAtom &f) {
-  result = f.ctx().make_literal(f.symbol, false);
+pl_ptr ToPLVisitor::combine_(const logic::LTLfPropFalse &f, const pl_ptr *) {
+  return f.ctx().make_false();
 }
-void ToPLVisitor::visit(const logic::LTLfNot &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfAtom &f, const pl_ptr *) {
+  return f.ctx().make_literal(f.symbol, false);
+}
+pl_ptr ToPLVisitor::combine_(const logic::LTLfNot &, const pl_ptr *) {
   logic::throw_expected_nnf();
 }
-void ToPLVisitor::visit(const logic::LTLfPropositionalNot &f) {
-  result = f.ctx().make_literal(
+pl_ptr ToPLVisitor::combine_(const logic::LTLfPropositionalNot &f,
+                             const pl_ptr *) {
+  return f.ctx().make_literal(
       std::static_pointer_cast<const LTLfAtom>(f.arg)->symbol, true);
 }
-void ToPLVisitor::visit(const logic::LTLfAnd &f) {
-  const auto &container = f.args;
-  auto new_container = vec_pl_ptr(container.size());
-  std::transform(
-      container.begin(), container.end(), new_container.begin(),
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); });
-  result = f.ctx().make_prop_and(new_container);
-}
-void ToPLVisitor::visit(const logic::LTLfOr &f) {
-  const auto &container = f.args;
-  auto new_container = vec_pl_ptr(container.size());
-  std::transform(
-      container.begin(), container.end(), new_container.begin(),
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); });
-  result = f.ctx().make_prop_or(new_container);
-}
-void ToPLVisitor::visit(const logic::LTLfImplies &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfAnd &f, const pl_ptr *args) {
+  return f.ctx().make_prop_and(vec_pl_ptr(args, args + f.args.size()));
+}
+pl_ptr ToPLVisitor::combine_(const logic::LTLfOr &f, const pl_ptr *args) {
+  return f.ctx().make_prop_or(vec_pl_ptr(args, args + f.args.size()));
+}
+pl_ptr ToPLVisitor::combine_(const logic::LTLfImplies &, const pl_ptr *) {
   logic::throw_expected_nnf();
 }
-void ToPLVisitor::visit(const logic::LTLfEquivalent &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfEquivalent &, const pl_ptr *) {
   logic::throw_expected_nnf();
 }
-void ToPLVisitor::visit(const logic::LTLfXor &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfXor &, const pl_ptr *) {
   logic::throw_expected_nnf();
 }
-void ToPLVisitor::visit(const logic::LTLfNext &f) {
-  result = f.ctx().make_literal(f.shared_from_this(), false);
+pl_ptr ToPLVisitor::combine_(const logic::LTLfNext &f, const pl_ptr *) {
+  return f.ctx().make_literal(logic::shared_from(f), false);
 }
-void ToPLVisitor::visit(const logic::LTLfWeakNext &f) {
-  result = f.ctx().make_literal(f.shared_from_this(), false);
+pl_ptr ToPLVisitor::combine_(const logic::LTLfWeakNext &f, const pl_ptr *) {
+  return f.ctx().make_literal(logic::shared_from(f), false);
 }
-void ToPLVisitor::visit(const logic::LTLfUntil &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfUntil &, const pl_ptr *) {
   logic::throw_expected_xnf();
 }
-void ToPLVisitor::visit(const logic::LTLfRelease &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfRelease &, const pl_ptr *) {
   logic::throw_expected_xnf();
 }
-void ToPLVisitor::visit(const logic::LTLfEventually &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfEventually &f, const pl_ptr *) {
   auto not_end = f.ctx().make_not_end();
   if (*not_end == f) {
-    result = f.ctx().make_literal(f.shared_from_this(), false);
-    return;
+    return f.ctx().make_literal(logic::shared_from(f), false);
   }
   logic::throw_expected_xnf();
 }
-void ToPLVisitor::visit(const logic::LTLfAlways &f) {
+pl_ptr ToPLVisitor::combine_(const logic::LTLfAlways &f, const pl_ptr *) {
   auto end = f.ctx().make_end();
   if (*end == f) {
-    result = f.ctx().make_literal(f.shared_from_this(), false);
-    return;
+    return f.ctx().make_literal(logic::shared_from(f), false);
   }
   logic::throw_expected_xnf();
 }
 
-pl_ptr ToPLVisitor::apply(const LTLfFormula &b) {
-  b.accept(*this);
-  return result;
-}
-
 pl_ptr to_pl(const LTLfFormula &formula) {
   ToPLVisitor visitor{};
   return visitor.apply(formula);
 }
 
+namespace {
+
+// the boolean operators are built in the AIG, and the other nodes are
+// translated as literals by to_pl
+class ToAigVisitor
+    : public PostOrderVisitor<ToAigVisitor, LTLfFormula, Aig::Edge> {
+public:
+  explicit ToAigVisitor(Aig &aig) : aig_{aig} {}
+
+  void expand(const LTLfFormula &f, size_t) {
+    auto type = f.type_code();
+    if (type == TypeID::t_LTLfAnd or type == TypeID::t_LTLfOr) {
+      for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
+    }
+  }
+  Aig::Edge combine(const LTLfFormula &f, size_t, const Aig::Edge *args) {
+    auto type = f.type_code();
+    if (type != TypeID::t_LTLfAnd and type != TypeID::t_LTLfOr) {
+      return logic::to_aig(aig_, *to_pl_.apply(f));
+    }
+    bool is_or = type == TypeID::t_LTLfOr;
+    auto nb_args = static_cast<const LTLfBinaryOp &>(f).args.size();
+    auto result = is_or ? Aig::false_edge : Aig::true_edge;
+    for (size_t i = 0; i < nb_args; ++i) {
+      result = is_or ? aig_.make_or(result, args[i])
+                     : aig_.make_and(result, args[i]);
+    }
+    return result;
+  }
+
+private:
+  Aig &aig_;
+  ToPLVisitor to_pl_;
+};
+
+} // namespace
+
+Aig::Edge to_aig(Aig &aig, const LTLfFormula &formula) {
+  ToAigVisitor visitor{aig};
+  return visitor.apply(formula);
+}
+
 } // namespace logic
 } // namespace nike
\ No newline at end of file
@@ -21,158 +21,140 @@
 namespace nike {
 namespace core {
 
-void XnfVisitor::visit(const logic::LTLfTrue &formula) {
-  result = formula.ctx().make_tt();
-}
-void XnfVisitor::visit(const logic::LTLfFalse &formula) {
-  result = formula.ctx().make_ff();
-}
-void XnfVisitor::visit(const logic::LTLfPropTrue &formula) {
-  result = formula.ctx().make_prop_true();
+namespace {
+logic::ltlf_ptr self(const logic::LTLfFormula &formula) {
+  return logic::shared_from(formula);
+}
+logic::vec_ptr arguments(const logic::LTLfBinaryOp &formula,
+                         const logic::ltlf_ptr *args) {
+  return logic::vec_ptr(args, args + formula.args.size());
+}
+// the first argument, and the operator applied to the others
+template <typename Factory>
+std::pair<logic::ltlf_ptr, logic::ltlf_ptr>
+head_tail(const logic::LTLfBinaryOp &formula, Factory factory) {
+  if (formula.args.size() == 2) {
+    return {formula.args[0], formula.args[1]};
+  }
+  return {formula.args[0], factory(logic::vec_ptr(formula.args.begin() + 1,
+                                                  formula.args.end()))};
 }
-void XnfVisitor::visit(const logic::LTLfPropFalse &formula) {
-  result = formula.ctx().make_prop_false();
+} // namespace
+
+void XnfVisitor::expand(const logic::LTLfFormula &f, size_t) {
+  logic::dispatch(f, [this](const auto &formula) { expand_(formula); });
 }
-void XnfVisitor::visit(const logic::LTLfAtom &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
+
+logic::ltlf_ptr XnfVisitor::combine(const logic::LTLfFormula &f, size_t,
+                                    const logic::ltlf_ptr *args) {
+  return logic::dispatch(
+      f, [this, args](const auto &formula) { return combine_(formula, args); });
 }
-void XnfVisitor::visit(const logic::LTLfNot &formula) {
+
+// atoms, constants and the Next subformulas are in XNF
+void XnfVisitor::expand_(const logic::LTLfFormula &) {}
+void XnfVisitor::expand_(const logic::LTLfNot &) {
   logic::throw_expected_nnf();
 }
-void XnfVisitor::visit(const logic::LTLfPropositionalNot &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-}
-void XnfVisitor::visit(const logic::LTLfAnd &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_and(container);
-      });
-}
-void XnfVisitor::visit(const logic::LTLfOr &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_or(container);
-      });
-}
-void XnfVisitor::visit(const logic::LTLfImplies &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_implies(container);
-      });
-}
-void XnfVisitor::visit(const logic::LTLfEquivalent &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_equivalent(container);
-      });
-}
-void XnfVisitor::visit(const logic::LTLfXor &formula) {
-  result = logic::forward_call_to_arguments(
-      formula,
-      [this](const logic::ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const logic::vec_ptr &container) {
-        return formula.ctx().make_xor(container);
-      });
-}
-void XnfVisitor::visit(const logic::LTLfNext &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-  ;
-}
-void XnfVisitor::visit(const logic::LTLfWeakNext &formula) {
-  result = std::static_pointer_cast<const logic::LTLfFormula>(
-      formula.shared_from_this());
-  ;
-}
-void XnfVisitor::visit(const logic::LTLfUntil &formula) {
-  auto &c = formula.ctx();
-  logic::ltlf_ptr head, tail;
-  if (formula.args.size() == 2) {
-    head = formula.args[0];
-    tail = formula.args[1];
-  } else {
-    head = formula.args[0];
-    tail = c.make_until(
-        logic::vec_ptr(formula.args.begin() + 1, formula.args.end()));
+void XnfVisitor::expand_(const logic::LTLfBinaryOp &formula) {
+  for (const auto &arg : formula.args) {
+    push(*arg);
   }
-  auto next_until =
-      c.make_next(result = std::static_pointer_cast<const logic::LTLfFormula>(
-                      formula.shared_from_this()));
-  auto left_part = c.make_and({tail, c.make_not_end()});
-  auto right_part = c.make_and({head, next_until});
-  auto temp = c.make_or({left_part, right_part});
-  result = apply(*temp);
-}
-void XnfVisitor::visit(const logic::LTLfRelease &formula) {
+}
+void XnfVisitor::expand_(const logic::LTLfUntil &formula) {
+  // a U b = (b & F(tt)) | (a & X[!](a U b))
   auto &c = formula.ctx();
-  logic::ltlf_ptr head, tail;
-  if (formula.args.size() == 2) {
-    head = formula.args[0];
-    tail = formula.args[1];
-  } else {
-    head = formula.args[0];
-    tail = c.make_release(
-        logic::vec_ptr(formula.args.begin() + 1, formula.args.end()));
+  auto head_and_tail = head_tail(
+      formula, [&c](const logic::vec_ptr &args) { return c.make_until(args); });
+  auto next_until = c.make_next(self(formula));
+  auto left_part = c.make_and({head_and_tail.second, c.make_not_end()});
+  auto right_part = c.make_and({head_and_tail.first, next_until});
+  push(*c.make_or({left_part, right_part}));
+}
+void XnfVisitor::expand_(const logic::LTLfRelease &formula) {
+  // a R b = (b | G(ff)) & (a | X(a R b))
+  auto &c = formula.ctx();
+  auto head_and_tail = head_tail(formula, [&c](const logic::vec_ptr &args) {
+    return c.make_release(args);
+  });
+  auto wnext_release = c.make_weak_next(self(formula));
+  auto left_part = c.make_or({head_and_tail.second, c.make_end()});
+  auto right_part = c.make_or({head_and_tail.first, wnext_release});
+  push(*c.make_and({left_part, right_part}));
+}
+void XnfVisitor::expand_(const logic::LTLfEventually &formula) {
+  if (*formula.ctx().make_not_end() != formula) {
+    push(*formula.arg);
+  }
+}
+void XnfVisitor::expand_(const logic::LTLfAlways &formula) {
+  if (*formula.ctx().make_end() != formula) {
+    push(*formula.arg);
   }
-  auto wnext_release = c.make_weak_next(
-      result = std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this()));
-  auto left_part = c.make_or({tail, c.make_end()});
-  auto right_part = c.make_or({head, wnext_release});
-  auto temp = c.make_and({left_part, right_part});
-  result = apply(*temp);
-}
-void XnfVisitor::visit(const logic::LTLfEventually &formula) {
+}
+
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfFormula &formula,
+                                     const logic::ltlf_ptr *) {
+  return self(formula);
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfAnd &formula,
+                                     const logic::ltlf_ptr *args) {
+  return formula.ctx().make_and(arguments(formula, args));
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfOr &formula,
+                                     const logic::ltlf_ptr *args) {
+  return formula.ctx().make_or(arguments(formula, args));
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfImplies &formula,
+                                     const logic::ltlf_ptr *args) {
+  return formula.ctx().make_implies(arguments(formula, args));
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfEquivalent &formula,
+                                     const logic::ltlf_ptr *args) {
+  return formula.ctx().make_equivalent(arguments(formula, args));
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfXor &formula,
+                                     const logic::ltlf_ptr *args) {
+  return formula.ctx().make_xor(arguments(formula, args));
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfUntil &,
+                                     const logic::ltlf_ptr *args) {
+  // the XNF of the unfolding
+  return args[0];
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfRelease &,
+                                     const logic::ltlf_ptr *args) {
+  return args[0];
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfEventually &formula,
+                                     const logic::ltlf_ptr *args) {
   auto &c = formula.ctx();
-  auto not_end = formula.ctx().make_not_end();
+  auto not_end = c.make_not_end();
   if (*not_end == formula) {
-    result = result = std::static_pointer_cast<const logic::LTLfFormula>(
-        formula.shared_from_this());
-    ;
-    return;
+    return self(formula);
   }
-  // F(phi), phi != tt
-  auto now_part = c.make_and({apply(*formula.arg), not_end});
-  auto next_part =
-      c.make_next(result = std::static_pointer_cast<const logic::LTLfFormula>(
-                      formula.shared_from_this()));
-  auto temp = c.make_or({now_part, next_part});
-  result = temp;
-}
-void XnfVisitor::visit(const logic::LTLfAlways &formula) {
+  // F(phi) = (phi & F(tt)) | X[!](F(phi)), phi != tt
+  auto now_part = c.make_and({args[0], not_end});
+  auto next_part = c.make_next(self(formula));
+  return c.make_or({now_part, next_part});
+}
+logic::ltlf_ptr XnfVisitor::combine_(const logic::LTLfAlways &formula,
+                                     const logic::ltlf_ptr *args) {
   auto &c = formula.ctx();
-  auto end = formula.ctx().make_end();
+  auto end = c.make_end();
   if (*end == formula) {
-    result = result = std::static_pointer_cast<const logic::LTLfFormula>(
-        formula.shared_from_this());
-    return;
+    return self(formula);
   }
-  // G(phi), phi != ff
-  auto now_part = c.make_or({apply(*formula.arg), end});
-  auto next_part = c.make_weak_next(
-      result = std::static_pointer_cast<const logic::LTLfFormula>(
-          formula.shared_from_this()));
-  auto temp = c.make_and({now_part, next_part});
-  result = apply(*temp);
-}
-
-logic::ltlf_ptr XnfVisitor::apply(const logic::LTLfFormula &formula) {
-  formula.accept(*this);
-  return result;
+  // G(phi) = (phi | G(ff)) & X(G(phi)), phi != ff; both parts are already
+  // in XNF, since the XNF of the XNF of phi is itself
+  auto now_part = c.make_or({args[0], end});
+  auto next_part = c.make_weak_next(self(formula));
+  return c.make_and({now_part, next_part});
 }
 
 logic::ltlf_ptr xnf(const logic::LTLfFormula &formula) {
-  XnfVisitor visitor;
+  XnfVisitor visitor{
+      &formula.ctx().memo_table(logic::Transformation::xnf)};
   return visitor.apply(formula);
 }
 
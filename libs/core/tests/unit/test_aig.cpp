@@ -0,0 +1,76 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/core.hpp>
+#include <nike/logic/nnf.hpp>
+#include <nike/parser/driver.hpp>
+#include <nike/to_ltlf.hpp>
+#include <nike/to_pl.hpp>
+#include <nike/xnf.hpp>
+#include <sstream>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+logic::ltlf_ptr parse(parser::ltlf::LTLfDriver &driver,
+                      const std::string &formula) {
+  std::stringstream stream(formula);
+  driver.parse(stream);
+  return driver.result;
+}
+} // namespace
+
+TEST_CASE("AIG of an XNF formula", "[core][aig]") {
+  auto formula_string =
+      GENERATE(as<std::string>{}, "a U b", "G(a -> X[!](b)) & F(c)",
+               "(a & !b) | X(c R (a | b))", "true", "false");
+  auto driver = parser::ltlf::LTLfDriver();
+  auto &context = *driver.context;
+  auto xnf_formula = xnf(*logic::to_nnf(*parse(driver, formula_string)));
+
+  logic::Aig aig;
+  auto edge = logic::to_aig(aig, *xnf_formula);
+  auto expected = logic::to_ltlf(*logic::to_pl(*xnf_formula));
+  REQUIRE(logic::to_ltlf(*logic::to_pl(context, aig, edge)) == expected);
+}
+
+TEST_CASE("AIG branching agrees with forward synthesis", "[core][aig]") {
+  auto partition = InputOutputPartition({"x", "y"}, {"a", "b"});
+  auto formula_string = GENERATE(
+      as<std::string>{}, "F(a & x)", "G(a <-> x)", "G(a <-> X[!](x))",
+      "(x U a) & F(b)", "G(x -> F(a)) & F(y & b)", "F(x) | G(a & !b)",
+      "(X[!](x) -> X[!](a)) & G(y -> X[!](b))");
+  auto prefetch_threads = GENERATE(0, 2);
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+
+  auto expected = ForwardSynthesis(formula, partition,
+                                   BranchingStrategy::TRUE_FIRST)
+                      .is_realizable();
+  auto synthesis =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST);
+  synthesis.set_aig_branching(true);
+  synthesis.set_prefetch_threads(prefetch_threads);
+  REQUIRE(synthesis.is_realizable() == expected);
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
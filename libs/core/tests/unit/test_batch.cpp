@@ -0,0 +1,125 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test_core/core_test_utils.hpp"
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nike/batch.hpp>
+#include <sstream>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+std::filesystem::path write_file(const std::filesystem::path &dir,
+                                 const std::string &name,
+                                 const std::string &content) {
+  auto path = dir / name;
+  std::ofstream out(path);
+  out << content;
+  return path;
+}
+} // namespace
+
+TEST_CASE("read manifest", "[core][batch]") {
+  std::stringstream manifest;
+  manifest << "# a comment\n"
+           << "f1.ltlf f1.part\n"
+           << "\n"
+           << "  /abs/f2.ltlf\t/abs/f2.part  \n";
+  auto instances = read_manifest(manifest, "base");
+  REQUIRE(instances.size() == 2);
+  REQUIRE(instances[0].formula_file ==
+          (std::filesystem::path("base") / "f1.ltlf").string());
+  REQUIRE(instances[0].partition_file ==
+          (std::filesystem::path("base") / "f1.part").string());
+  REQUIRE(instances[1].formula_file == "/abs/f2.ltlf");
+  REQUIRE(instances[1].partition_file == "/abs/f2.part");
+}
+
+TEST_CASE("read manifest with bad line", "[core][batch]") {
+  std::stringstream manifest;
+  manifest << "f1.ltlf f1.part\n"
+           << "f2.ltlf\n";
+  REQUIRE_THROWS_AS(read_manifest(manifest), std::runtime_error);
+}
+
+TEST_CASE("batch result to json", "[core][batch]") {
+  BatchResult result;
+  result.index = 3;
+  result.worker_id = 1;
+  result.formula_file = "dir/\"f\".ltlf";
+  result.partition_file = "dir/f.part";
+  result.status = BatchStatus::ERROR;
+  result.error_message = "parse failed";
+  auto json = batch_result_to_json(result);
+  REQUIRE(json.find("\"index\": 3") != std::string::npos);
+  REQUIRE(json.find("\"formula\": \"dir/\\\"f\\\".ltlf\"") !=
+          std::string::npos);
+  REQUIRE(json.find("\"result\": \"ERROR\"") != std::string::npos);
+  REQUIRE(json.find("\"error\": \"parse failed\"") != std::string::npos);
+  REQUIRE(json.find('\n') == std::string::npos);
+}
+
+TEST_CASE("batch synthesis", "[core][batch]") {
+  auto temp_directory = TempDirectory("nike_test_batch");
+  const auto &dir = temp_directory.path();
+  write_file(dir, "a.ltlf", "a");
+  write_file(dir, "until.ltlf", "b U a");
+  write_file(dir, "a_out.part", ".inputs: b\n.outputs: a\n");
+  write_file(dir, "a_in.part", ".inputs: a\n.outputs: b\n");
+  auto manifest = write_file(dir, "manifest.txt",
+                             "a.ltlf a_out.part\n"
+                             "a.ltlf a_in.part\n"
+                             "until.ltlf a_out.part\n"
+                             "until.ltlf a_in.part\n"
+                             "missing.ltlf a_in.part\n");
+
+  BatchOptions options;
+  options.nb_workers = 2;
+  SECTION("default search options") {}
+  SECTION("search options passed to every instance") {
+    options.nb_prefetch_threads = 2;
+    options.gc_threshold = 1;
+    options.aig_branching = true;
+    options.flat_passes = true;
+  }
+  auto batch =
+      BatchSynthesis(read_manifest_from_file(manifest.string()), options);
+  std::map<size_t, BatchResult> results;
+  batch.run([&results](const BatchResult &result) {
+    results[result.index] = result;
+  });
+
+  REQUIRE(results.size() == 5);
+  REQUIRE(results[0].status == BatchStatus::REALIZABLE);
+  REQUIRE(results[1].status == BatchStatus::UNREALIZABLE);
+  REQUIRE(results[2].status == BatchStatus::REALIZABLE);
+  REQUIRE(results[3].status == BatchStatus::UNREALIZABLE);
+  REQUIRE(results[4].status == BatchStatus::ERROR);
+  for (const auto &pair : results) {
+    REQUIRE(pair.second.worker_id < 2);
+    REQUIRE(pair.second.total_time_ms >= 0.0);
+  }
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
@@ -194,8 +194,8 @@ TEST_CASE("Test closure of a & b", "[core][SDD]") {
   auto expected = logic::vec_ptr({
       tt,
       ff,
-      b,
       a,
+      b,
       next_not_end,
       wnext_end,
       not_end,
@@ -250,12 +250,13 @@ TEST_CASE("Test closure of X[!]a", "[core][SDD]") {
   auto next_a = context.make_next(a);
   auto formula_closure = closure(*next_a);
 
+  // interned formulas of the same type are ordered by creation
   auto expected = logic::vec_ptr({
       tt,
       ff,
       a,
-      next_a,
       next_not_end,
+      next_a,
       wnext_end,
       not_end,
       end,
@@ -266,6 +267,45 @@ TEST_CASE("Test closure of X[!]a", "[core][SDD]") {
   REQUIRE(expected == actual);
 }
 
+TEST_CASE("Closure index lookup", "[core][SDD]") {
+  auto context = logic::Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto formula = context.make_until({a, context.make_next(b)});
+  auto formula_closure = closure(*formula);
+
+  logic::vec_ptr formulas(formula_closure.begin_formulas(),
+                          formula_closure.end_formulas());
+  auto ids = formula_closure.get_ids(formulas);
+  for (size_t i = 0; i < formulas.size(); ++i) {
+    REQUIRE(formula_closure.get_id(formulas[i]) == i);
+    REQUIRE(formula_closure.get_id(*formulas[i]) == i);
+    REQUIRE(ids[i] == i);
+  }
+  REQUIRE_THROWS_AS(formula_closure.get_id(context.make_atom("c")),
+                    std::invalid_argument);
+
+  // nodes that are not interned are found by comparison
+  auto detached = std::make_shared<const logic::LTLfAtom>(context, "a");
+  REQUIRE(formula_closure.get_id(*detached) == formula_closure.get_id(a));
+}
+
+TEST_CASE("Test closure of a deep formula", "[core][SDD]") {
+  auto context = logic::Context();
+  const size_t depth = 1000000;
+
+  // F(a & F(a & ... F a))
+  auto a = context.make_atom("a");
+  logic::ltlf_ptr formula = context.make_eventually(a);
+  for (size_t i = 1; i < depth; ++i) {
+    formula = context.make_eventually(context.make_and({a, formula}));
+  }
+
+  auto formula_closure = closure(*formula);
+  // tt, ff, a, end, !end, X !end and WX end, plus F and X F of each level
+  REQUIRE(formula_closure.nb_formulas() == 7 + 2 * depth);
+}
+
 } // namespace Test
 } // namespace core
 } // namespace nike
\ No newline at end of file
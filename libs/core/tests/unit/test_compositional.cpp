@@ -0,0 +1,121 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <catch.hpp>
+#include <nike/compositional.hpp>
+#include <nike/core.hpp>
+#include <nike/logic/nnf.hpp>
+#include <nike/parser/driver.hpp>
+#include <sstream>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+logic::ltlf_ptr parse(parser::ltlf::LTLfDriver &driver,
+                      const std::string &formula) {
+  std::stringstream stream(formula);
+  driver.parse(stream);
+  return driver.result;
+}
+
+bool compositional_is_realizable(const logic::ltlf_ptr &formula,
+                                 const InputOutputPartition &partition) {
+  auto synthesis = CompositionalSynthesis(formula, partition);
+  return synthesis.is_realizable();
+}
+
+bool monolithic_is_realizable(const logic::ltlf_ptr &formula,
+                              const InputOutputPartition &partition) {
+  auto synthesis = ForwardSynthesis(formula, partition);
+  return synthesis.is_realizable();
+}
+} // namespace
+
+TEST_CASE("decompose conjunction with disjoint outputs",
+          "[core][compositional]") {
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, "G(a | x) & F(b) & (c U x) & F(x)");
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto components = decompose(*logic::to_nnf(*formula), partition);
+
+  REQUIRE(components.size() == 3);
+  size_t nb_invariants = 0;
+  size_t nb_conjuncts = 0;
+  for (const auto &component : components) {
+    REQUIRE(component.output_variables.size() == 1);
+    nb_invariants += component.is_invariant;
+    nb_conjuncts += component.conjuncts.size();
+  }
+  REQUIRE(nb_invariants == 1);
+  // F(x) has no outputs, and is attached to a non-invariant component
+  REQUIRE(nb_conjuncts == 4);
+}
+
+TEST_CASE("decompose conjunction with shared outputs",
+          "[core][compositional]") {
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, "F(a & b) & G(b | c) & F(x)");
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto components = decompose(*logic::to_nnf(*formula), partition);
+
+  REQUIRE(components.size() == 1);
+  REQUIRE(components[0].conjuncts.size() == 3);
+  REQUIRE(!components[0].is_invariant);
+}
+
+TEST_CASE("compositional synthesis agrees with forward synthesis",
+          "[core][compositional]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto formula_string = GENERATE(
+      as<std::string>{}, "F(a) & F(b)", "G(a | x) & F(b) & F(tt)",
+      "G(a & x) & F(b) & F(tt)", "F(a) & (b U x) & F(tt)",
+      "G(a) & G(!b) & F(c & X[!](c))", "F(a) & G(!a) & F(b)",
+      "(X[!](a)) & (X[!](X[!](b))) & G(c)");
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+  auto expected = monolithic_is_realizable(formula, partition);
+  auto actual = compositional_is_realizable(formula, partition);
+  REQUIRE(expected == actual);
+}
+
+TEST_CASE("compositional strategy", "[core][compositional]") {
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, "G(a | x) & F(b)");
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto synthesis = CompositionalSynthesis(formula, partition);
+  REQUIRE(synthesis.is_realizable());
+  REQUIRE(synthesis.components().size() == 2);
+
+  // the moves of the search on F(b), with the move maintaining G(a | x)
+  const auto &strategy = synthesis.strategy();
+  REQUIRE(strategy.has_value());
+  REQUIRE(!strategy->state_to_move.empty());
+  for (const auto &pair : strategy->state_to_move) {
+    const auto &move = pair.second;
+    REQUIRE(move.size() == partition.output_variables.size());
+    auto a = std::find(move.begin(), move.end(),
+                       std::make_pair(std::string("a"), VarValues::TRUE));
+    REQUIRE(a != move.end());
+  }
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
@@ -16,10 +16,14 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <filesystem>
 #include <nike/core.hpp>
 #include <nike/core_base.hpp>
 #include <nike/input_output_partition.hpp>
 #include <nike/logic/types.hpp>
+#include <random>
+#include <string>
+#include <system_error>
 
 namespace nike::core::Test {
 
@@ -31,4 +35,31 @@ inline bool test_is_realizable(const nike::logic::ltlf_ptr &formula,
       formula, partition, b, mode);
 }
 
+/*
+ * A new directory in the temporary directory, removed with its content on
+ * destruction. Its name has a random suffix, so that concurrent test runs
+ * do not share it.
+ */
+class TempDirectory {
+public:
+  explicit TempDirectory(const std::string &prefix) {
+    std::random_device random;
+    do {
+      path_ = std::filesystem::temp_directory_path() /
+              (prefix + "_" + std::to_string(random()));
+    } while (!std::filesystem::create_directory(path_));
+  }
+  TempDirectory(const TempDirectory &) = delete;
+  TempDirectory &operator=(const TempDirectory &) = delete;
+  ~TempDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+  }
+
+  const std::filesystem::path &path() const { return path_; }
+
+private:
+  std::filesystem::path path_;
+};
+
 } // namespace nike::core::Test
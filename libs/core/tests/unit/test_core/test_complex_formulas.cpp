@@ -90,6 +90,52 @@ TEST_CASE("forward synthesis of random formula 5") {
   REQUIRE(!result);
 }
 
+TEST_CASE("forward synthesis with garbage collection at every state") {
+  auto formula_string = GENERATE(
+      as<std::string>{},
+      "(((p0) | (G(F(p4)))) & (F(p3))) U ((p3) & ((~(p1)) | (F(~(p3)))))",
+      "G(p0 -> F(p3)) & F(p1 & X[!](p4))", "(p4 U p3) & G(F(p1 <-> p0))");
+  auto mode =
+      GENERATE(StateEquivalenceMode::HASH, StateEquivalenceMode::BDD);
+  auto driver = parser::ltlf::LTLfDriver();
+  std::istringstream fstring(formula_string);
+  driver.parse(fstring);
+  auto formula = driver.result;
+  auto partition = InputOutputPartition({"p1", "p0"}, {"p3", "p4"});
+  auto expected = ForwardSynthesis(formula, partition,
+                                   BranchingStrategy::TRUE_FIRST, mode);
+  expected.set_gc_threshold(0);
+  auto collected = ForwardSynthesis(formula, partition,
+                                    BranchingStrategy::TRUE_FIRST, mode);
+  collected.set_gc_threshold(1);
+  REQUIRE(collected.is_realizable() == expected.is_realizable());
+}
+
+TEST_CASE("forward synthesis with simplification") {
+  auto formula_string = GENERATE(
+      as<std::string>{}, "X(X(a)) & (c | X(X(b)))",
+      "(X(a) | X(b)) & G(c -> X[!](a & b))", "G(c -> F(a)) & F(c & b)",
+      "(c U a) & F(b) & F(a & !a)", "(X[!](c) -> X[!](a)) & G(c -> X[!](b))");
+  auto mode =
+      GENERATE(StateEquivalenceMode::HASH, StateEquivalenceMode::BDD);
+  auto partition = InputOutputPartition({"c"}, {"a", "b"});
+  auto driver = parser::ltlf::LTLfDriver();
+  std::istringstream fstring(formula_string);
+  driver.parse(fstring);
+  auto expected = ForwardSynthesis(driver.result, partition,
+                                   BranchingStrategy::TRUE_FIRST, mode);
+
+  // the states are rewritten as they are built, during the search too
+  auto simplifying_driver = parser::ltlf::LTLfDriver();
+  simplifying_driver.context->set_simplification(true);
+  std::istringstream simplified_fstring(formula_string);
+  simplifying_driver.parse(simplified_fstring);
+  auto simplified =
+      ForwardSynthesis(simplifying_driver.result, partition,
+                       BranchingStrategy::TRUE_FIRST, mode);
+  REQUIRE(simplified.is_realizable() == expected.is_realizable());
+}
+
 } // namespace Test
 } // namespace core
 } // namespace nike
\ No newline at end of file
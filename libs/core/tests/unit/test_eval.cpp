@@ -98,6 +98,33 @@ TEST_CASE("Test eval of X a", "[core][SDD]") {
   REQUIRE(eval(*weak_next_a));
 }
 
+TEST_CASE("Test eval of flat formulas", "[core][SDD]") {
+  auto context = logic::Context();
+
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto weak_next_a = context.make_weak_next(a);
+  auto not_b = context.make_not(b);
+  auto formulas = logic::vec_ptr{
+      context.make_tt(),
+      context.make_prop_not(a),
+      context.make_and({weak_next_a, context.make_always(b)}),
+      context.make_or({a, context.make_release({a, b})}),
+      context.make_or({a, context.make_until({a, b})}),
+      // the negations are not reached: the arguments are ordered by type,
+      // and an atom comes before a negation
+      context.make_next(not_b),
+      context.make_and({a, not_b}),
+      context.make_or({context.make_and({a, not_b}), weak_next_a}),
+  };
+  for (const auto &formula : formulas) {
+    REQUIRE(eval(logic::FlatFormula(*formula)) == eval(*formula));
+  }
+  REQUIRE_THROWS_AS(eval(logic::FlatFormula(*not_b)), std::logic_error);
+  REQUIRE_THROWS_AS(eval(logic::FlatFormula(*context.make_or({a, not_b}))),
+                    std::logic_error);
+}
+
 } // namespace Test
 } // namespace core
 } // namespace nike
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test_core/core_test_utils.hpp"
+#include <catch.hpp>
+#include <future>
+#include <nike/core.hpp>
+#include <nike/parser/driver.hpp>
+#include <sstream>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+logic::ltlf_ptr parse(parser::ltlf::LTLfDriver &driver,
+                      const std::string &formula) {
+  std::stringstream stream(formula);
+  driver.parse(stream);
+  return driver.result;
+}
+
+std::string many_conjuncts(size_t n) {
+  std::stringstream formula;
+  for (size_t i = 0; i < n; ++i) {
+    if (i > 0) {
+      formula << " & ";
+    }
+    switch (i % 4) {
+    case 0:
+      formula << "F(a" << i << " & x)";
+      break;
+    case 1:
+      formula << "G(!(a" << i << ") | X[!](y))";
+      break;
+    case 2:
+      formula << "(x U a" << i << ")";
+      break;
+    default:
+      formula << "!(G(a" << i << " -> X(y)))";
+    }
+  }
+  return formula.str();
+}
+} // namespace
+
+TEST_CASE("parallel preprocessing", "[core][preprocessing]") {
+  auto nb_conjuncts = GENERATE(1, 2, 40);
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, many_conjuncts(nb_conjuncts));
+  std::vector<std::string> outputs;
+  for (int i = 0; i < nb_conjuncts; ++i) {
+    outputs.push_back("a" + std::to_string(i));
+  }
+  auto partition = InputOutputPartition({"x", "y"}, outputs);
+
+  auto sequential = Context(formula, partition, BranchingStrategy::TRUE_FIRST,
+                            StateEquivalenceMode::HASH, 3.0, "nike", false,
+                            false, nullptr, 1);
+  auto parallel = Context(formula, partition, BranchingStrategy::TRUE_FIRST,
+                        StateEquivalenceMode::HASH, 3.0, "nike", false, false,
+                        nullptr, 4);
+
+  REQUIRE(!formula->ctx().is_thread_safe());
+  REQUIRE(sequential.nnf_formula == parallel.nnf_formula);
+  REQUIRE(sequential.xnf_formula == parallel.xnf_formula);
+  REQUIRE(sequential.closure_.nb_formulas() == parallel.closure_.nb_formulas());
+  REQUIRE(std::equal(sequential.closure_.begin_formulas(),
+                     sequential.closure_.end_formulas(),
+                     parallel.closure_.begin_formulas()));
+  REQUIRE(sequential.closure_.nb_atoms() == parallel.closure_.nb_atoms());
+  REQUIRE(sequential.prop_to_id == parallel.prop_to_id);
+  REQUIRE(parallel.preprocessing_times.nnf_ms >= 0.0);
+  REQUIRE(parallel.preprocessing_times.closure_ms >= 0.0);
+}
+
+TEST_CASE("forward synthesis with parallel preprocessing",
+          "[core][preprocessing]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto formula_string =
+      GENERATE(as<std::string>{}, "F(a) & F(b) & G(c)", "F(a & x) & G(b | x)",
+               "G(a <-> x) & F(b) & (c U x)", "(X[!](a)) & (X[!](X[!](b)))");
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST)
+          .is_realizable();
+  auto synthesis =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST,
+                       StateEquivalenceMode::HASH, "nike", false, false, 3.0,
+                       nullptr, 3);
+  REQUIRE(synthesis.is_realizable() == expected);
+  REQUIRE(synthesis.preprocessing_times().root_checks_ms >= 0.0);
+}
+
+TEST_CASE("searches sharing a frozen formula", "[core][preprocessing]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto formula_string =
+      GENERATE(as<std::string>{}, "F(a) & F(b) & G(c)", "F(a & x) & G(b | x)",
+               "G(a <-> x) & F(b) & (c U x)", "(X[!](a)) & (X[!](X[!](b)))");
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST)
+          .is_realizable();
+
+  auto frozen_formula = std::make_shared<const FrozenFormula>(formula);
+  auto first =
+      Context(frozen_formula, partition, BranchingStrategy::TRUE_FIRST,
+              StateEquivalenceMode::HASH);
+  auto second = Context(frozen_formula, partition,
+                        BranchingStrategy::FALSE_FIRST,
+                        StateEquivalenceMode::HASH);
+  // nothing is copied: the searches work in the context of the formula
+  REQUIRE(first.ast_manager == &formula->ctx());
+  REQUIRE(first.xnf_formula == second.xnf_formula);
+  REQUIRE(&first.closure_ == &second.closure_);
+  REQUIRE(first.shares_ast_manager);
+
+  formula->ctx().set_thread_safe(true);
+  std::vector<std::future<bool>> results;
+  for (auto bs : {BranchingStrategy::TRUE_FIRST,
+                  BranchingStrategy::FALSE_FIRST, BranchingStrategy::RANDOM}) {
+    results.push_back(std::async(std::launch::async, [&, bs]() {
+      return ForwardSynthesis(frozen_formula, partition, bs).is_realizable();
+    }));
+  }
+  for (auto &result : results) {
+    REQUIRE(result.get() == expected);
+  }
+  formula->ctx().set_thread_safe(false);
+}
+
+TEST_CASE("frozen formula copied to other contexts", "[core][preprocessing]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto formula_string =
+      GENERATE(as<std::string>{}, "F(a) & F(b) & G(c)", "F(a & x) & G(b | x)",
+               "G(a <-> x) & F(b) & (c U x)", "(X[!](a)) & (X[!](X[!](b)))");
+  auto simplify = GENERATE(false, true);
+  auto driver = parser::ltlf::LTLfDriver();
+  driver.context->set_simplification(simplify);
+  auto formula = parse(driver, formula_string);
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST)
+          .is_realizable();
+  auto frozen_formula = FrozenFormula(formula);
+
+  auto copy_context = logic::Context();
+  auto copy = copy_frozen_formula(copy_context, frozen_formula);
+  REQUIRE(&copy->formula->ctx() == &copy_context);
+  REQUIRE(copy_context.is_simplifying() == simplify);
+  REQUIRE(copy->xnf_size == frozen_formula.xnf_size);
+  REQUIRE(copy->closure.nb_formulas() == frozen_formula.closure.nb_formulas());
+  REQUIRE(copy->closure.nb_atoms() == frozen_formula.closure.nb_atoms());
+
+  // each search owns its copy, and collects it as it goes
+  std::vector<std::future<bool>> results;
+  for (auto bs : {BranchingStrategy::TRUE_FIRST,
+                  BranchingStrategy::FALSE_FIRST, BranchingStrategy::RANDOM}) {
+    results.push_back(std::async(std::launch::async, [&, bs]() {
+      auto context = logic::Context();
+      auto synthesis = ForwardSynthesis(
+          copy_frozen_formula(context, frozen_formula), partition, bs);
+      synthesis.set_shares_ast_manager(false);
+      synthesis.set_gc_threshold(1);
+      return synthesis.is_realizable();
+    }));
+  }
+  for (auto &result : results) {
+    REQUIRE(result.get() == expected);
+  }
+}
+
+TEST_CASE("frozen formula saved to a file", "[core][preprocessing]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b", "c"});
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, "G(a <-> x) & F(b) & (c U x)");
+  auto frozen_formula = FrozenFormula(formula);
+  auto temp_directory = TempDirectory("nike_test_frozen");
+  auto filename = (temp_directory.path() / "formula.dag").string();
+  write_frozen_formula(filename, frozen_formula);
+
+  auto context = logic::Context();
+  auto loaded = read_frozen_formula(context, filename);
+  REQUIRE(&loaded->formula->ctx() == &context);
+  REQUIRE(loaded->xnf_size == frozen_formula.xnf_size);
+  REQUIRE(loaded->closure.nb_formulas() ==
+          frozen_formula.closure.nb_formulas());
+  REQUIRE(loaded->closure.nb_atoms() == frozen_formula.closure.nb_atoms());
+  // the preprocessing read back is the one computed again
+  auto recomputed = FrozenFormula(loaded->formula);
+  REQUIRE(loaded->nnf_formula == recomputed.nnf_formula);
+  REQUIRE(loaded->xnf_formula == recomputed.xnf_formula);
+
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST)
+          .is_realizable();
+  auto synthesis =
+      ForwardSynthesis(loaded, partition, BranchingStrategy::TRUE_FIRST);
+  synthesis.set_shares_ast_manager(false);
+  REQUIRE(synthesis.is_realizable() == expected);
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
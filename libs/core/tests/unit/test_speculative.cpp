@@ -0,0 +1,109 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/core.hpp>
+#include <nike/parser/driver.hpp>
+#include <nike/speculative.hpp>
+#include <sstream>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+logic::ltlf_ptr parse(parser::ltlf::LTLfDriver &driver,
+                      const std::string &formula) {
+  std::stringstream stream(formula);
+  driver.parse(stream);
+  return driver.result;
+}
+} // namespace
+
+TEST_CASE("verdict cache", "[core][speculative]") {
+  logic::Context context;
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  VerdictCache cache;
+
+  REQUIRE(cache.reserve(a));
+  REQUIRE(!cache.reserve(a));
+  // pending entries are not visible
+  REQUIRE(cache.find(*a) == std::nullopt);
+  REQUIRE(cache.find(*b) == std::nullopt);
+
+  StateVerdict verdict;
+  verdict.kind = StateVerdict::ONE_STEP_REALIZABLE;
+  verdict.move = {{"a", VarValues::TRUE}};
+  cache.insert(a, verdict);
+  auto found = cache.find(*a);
+  REQUIRE(found != std::nullopt);
+  REQUIRE(found->kind == StateVerdict::ONE_STEP_REALIZABLE);
+  REQUIRE(found->move == verdict.move);
+  REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("verdict cache releases its formulas", "[core][speculative]") {
+  logic::Context context;
+  VerdictCache cache;
+  auto nb_nodes = context.nb_nodes();
+  {
+    auto taken = context.make_next(context.make_atom("a"));
+    auto not_taken = context.make_next(context.make_atom("b"));
+    auto pending = context.make_next(context.make_atom("c"));
+    for (const auto &formula : {taken, not_taken, pending}) {
+      REQUIRE(cache.reserve(formula));
+    }
+    cache.insert(taken, StateVerdict{});
+    cache.insert(not_taken, StateVerdict{});
+    REQUIRE(cache.take(*taken) != std::nullopt);
+    REQUIRE(cache.take(*taken) == std::nullopt);
+    REQUIRE(cache.take(*pending) == std::nullopt);
+  }
+  REQUIRE(cache.release_ready() == 1);
+  REQUIRE(cache.size() == 1);
+  // only the pending formula, its atom and its symbol are left
+  context.collect_garbage();
+  REQUIRE(context.nb_nodes() == nb_nodes + 3);
+}
+
+TEST_CASE("speculative prefetching agrees with forward synthesis",
+          "[core][speculative]") {
+  auto partition = InputOutputPartition({"x", "y"}, {"a", "b"});
+  auto formula_string = GENERATE(
+      as<std::string>{}, "F(a & x)", "G(a <-> x)", "G(a <-> X[!](x))",
+      "(x U a) & F(b)", "G(x -> F(a)) & F(y & b)", "F(x) | G(a & !b)",
+      "(X[!](x) -> X[!](a)) & G(y -> X[!](b))");
+  auto mode = GENERATE(StateEquivalenceMode::HASH, StateEquivalenceMode::BDD);
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST, mode)
+          .is_realizable();
+  auto synthesis =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST, mode);
+  synthesis.set_prefetch_threads(2);
+  synthesis.set_gc_threshold(GENERATE(ForwardSynthesis::default_gc_threshold,
+                                      size_t(1)));
+  auto actual = synthesis.is_realizable();
+  REQUIRE(expected == actual);
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
@@ -0,0 +1,199 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "test_core/core_test_utils.hpp"
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nike/core.hpp>
+#include <nike/parser/driver.hpp>
+#include <nike/shared_verdicts.hpp>
+#include <nike/supervisor.hpp>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace nike {
+namespace core {
+namespace Test {
+
+namespace {
+logic::ltlf_ptr parse(parser::ltlf::LTLfDriver &driver,
+                      const std::string &formula) {
+  std::stringstream stream(formula);
+  driver.parse(stream);
+  return driver.result;
+}
+
+std::filesystem::path write_file(const std::filesystem::path &dir,
+                                 const std::string &name,
+                                 const std::string &content) {
+  auto path = dir / name;
+  std::ofstream out(path);
+  out << content;
+  return path;
+}
+} // namespace
+
+TEST_CASE("structural fingerprint", "[core][supervisor]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b"});
+  auto driver_1 = parser::ltlf::LTLfDriver();
+  auto driver_2 = parser::ltlf::LTLfDriver();
+  auto f1 = parse(driver_1, "F(a & x) | G(b)");
+  auto f2 = parse(driver_2, "G(b) | F(x & a)");
+  auto f3 = parse(driver_2, "F(a & x) & G(b)");
+  REQUIRE(&f1->ctx() != &f2->ctx());
+
+  auto fingerprint_1 = StructuralFingerprint(partition);
+  auto fingerprint_2 = StructuralFingerprint(partition);
+  REQUIRE(fingerprint_1(*f1) == fingerprint_2(*f2));
+  REQUIRE(fingerprint_1(*f1) != fingerprint_2(*f3));
+
+  auto other_partition = InputOutputPartition({"a"}, {"x", "b"});
+  auto fingerprint_3 = StructuralFingerprint(other_partition);
+  REQUIRE(fingerprint_1(*f1) != fingerprint_3(*f1));
+}
+
+TEST_CASE("structural fingerprint of collected formulas",
+          "[core][supervisor]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b"});
+  logic::Context context;
+  auto fingerprint = StructuralFingerprint(partition);
+  auto formula = context.make_next(context.make_atom("a"));
+  auto expected = fingerprint(*formula);
+
+  // the memo does not keep the formula alive
+  formula = nullptr;
+  REQUIRE(context.collect_garbage() > 0);
+  // built again, the formula gets new ids and the same fingerprint
+  formula = context.make_next(context.make_atom("a"));
+  REQUIRE(fingerprint(*formula) == expected);
+}
+
+TEST_CASE("shared verdict table", "[core][supervisor]") {
+  SharedVerdictTable table(8);
+  Fingerprint k1{1, 2};
+  Fingerprint k2{1, 10};
+  Fingerprint k3{0, 3};
+  REQUIRE(table.find(k1) == SharedVerdict::UNKNOWN);
+  REQUIRE(table.insert(k1, SharedVerdict::REALIZABLE));
+  REQUIRE(!table.insert(k1, SharedVerdict::REALIZABLE));
+  REQUIRE(table.insert(k2, SharedVerdict::UNREALIZABLE));
+  REQUIRE(table.insert(k3, SharedVerdict::UNREALIZABLE));
+  REQUIRE(table.find(k1) == SharedVerdict::REALIZABLE);
+  REQUIRE(table.find(k2) == SharedVerdict::UNREALIZABLE);
+  REQUIRE(table.find(k3) == SharedVerdict::UNREALIZABLE);
+  REQUIRE(table.find(Fingerprint{2, 2}) == SharedVerdict::UNKNOWN);
+  REQUIRE(table.size() == 3);
+
+  SECTION("entries are visible across processes") {
+    auto pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+      table.insert(Fingerprint{5, 5}, SharedVerdict::REALIZABLE);
+      _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    REQUIRE(table.find(Fingerprint{5, 5}) == SharedVerdict::REALIZABLE);
+  }
+}
+
+TEST_CASE("forward synthesis with shared verdicts", "[core][supervisor]") {
+  auto partition = InputOutputPartition({"x"}, {"a", "b"});
+  auto formula_string =
+      GENERATE(as<std::string>{}, "F(a & x)", "G(a <-> X[!](x))",
+               "(x U a) & F(b)", "F(x) | G(a & !b)");
+  SharedVerdictTable table(1024);
+  auto driver = parser::ltlf::LTLfDriver();
+  auto formula = parse(driver, formula_string);
+  auto expected =
+      ForwardSynthesis(formula, partition, BranchingStrategy::TRUE_FIRST)
+          .is_realizable();
+
+  // the second search runs in a fresh context, on the verdicts of the first
+  for (int i = 0; i < 2; ++i) {
+    auto other_driver = parser::ltlf::LTLfDriver();
+    auto other_formula = parse(other_driver, formula_string);
+    auto synthesis = ForwardSynthesis(other_formula, partition,
+                                      BranchingStrategy::TRUE_FIRST);
+    synthesis.set_shared_verdicts(&table);
+    REQUIRE(synthesis.is_realizable() == expected);
+  }
+  REQUIRE(table.size() > 0);
+}
+
+TEST_CASE("supervisor", "[core][supervisor]") {
+  auto temp_directory = TempDirectory("nike_test_supervisor");
+  const auto &dir = temp_directory.path();
+  write_file(dir, "a.ltlf", "a");
+  write_file(dir, "until.ltlf", "b U a");
+  write_file(dir, "a_out.part", ".inputs: b\n.outputs: a\n");
+  write_file(dir, "a_in.part", ".inputs: a\n.outputs: b\n");
+  auto manifest = write_file(dir, "manifest.txt",
+                             "a.ltlf a_out.part\n"
+                             "a.ltlf a_in.part\n"
+                             "until.ltlf a_out.part\n"
+                             "until.ltlf a_in.part\n"
+                             "missing.ltlf a_in.part\n");
+  std::map<size_t, BatchStatus> expected = {{0, BatchStatus::REALIZABLE},
+                                            {1, BatchStatus::UNREALIZABLE},
+                                            {2, BatchStatus::REALIZABLE},
+                                            {3, BatchStatus::UNREALIZABLE},
+                                            {4, BatchStatus::ERROR}};
+
+  SupervisorOptions options;
+  options.batch.nb_workers = 2;
+  options.shared_table_slots = 1024;
+  options.poll_interval_ms = 10;
+
+  SECTION("without memory limit") {
+    auto supervisor =
+        Supervisor(read_manifest_from_file(manifest.string()), options);
+    std::map<size_t, BatchResult> results;
+    supervisor.run([&results](const BatchResult &result) {
+      results[result.index] = result;
+    });
+    REQUIRE(results.size() == 5);
+    for (const auto &pair : results) {
+      REQUIRE(pair.second.status == expected[pair.first]);
+      REQUIRE(pair.second.worker_id < 2);
+    }
+    REQUIRE(supervisor.nb_shared_verdicts() > 0);
+  }
+
+  SECTION("with a memory limit no worker can satisfy") {
+    // workers are either killed, or complete before being polled
+    options.memory_limit_mb = 1;
+    auto supervisor =
+        Supervisor(read_manifest_from_file(manifest.string()), options);
+    std::map<size_t, BatchResult> results;
+    supervisor.run([&results](const BatchResult &result) {
+      results[result.index] = result;
+    });
+    REQUIRE(results.size() == 5);
+    for (const auto &pair : results) {
+      REQUIRE((pair.second.status == expected[pair.first] ||
+               pair.second.status == BatchStatus::MEMOUT));
+    }
+  }
+}
+
+} // namespace Test
+} // namespace core
+} // namespace nike
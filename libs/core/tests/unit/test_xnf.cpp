@@ -15,7 +15,9 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <catch.hpp>
+#include <nike/logic/memo.hpp>
 #include <nike/xnf.hpp>
 
 namespace nike {
@@ -127,6 +129,65 @@ TEST_CASE("Test XNF of a R b", "[core][SDD]") {
   REQUIRE(actual == expected);
 }
 
+TEST_CASE("Test XNF of a deep formula", "[core][SDD]") {
+  auto context = logic::Context();
+  const size_t depth = 1000000;
+
+  // F(a & F(a & ... F a))
+  auto a = context.make_atom("a");
+  logic::ltlf_ptr formula = context.make_eventually(a);
+  for (size_t i = 1; i < depth; ++i) {
+    formula = context.make_eventually(context.make_and({a, formula}));
+  }
+
+  auto actual = xnf(*formula);
+  // (a & F tt & xnf(F ...)) | X F(a & F ...), down to the innermost F a
+  size_t nb_levels = 1;
+  auto nested = actual;
+  while (nested->type_code() == logic::TypeID::t_LTLfOr) {
+    const auto &disjuncts =
+        std::static_pointer_cast<const logic::LTLfOr>(nested)->args;
+    auto conjunction = std::find_if(
+        disjuncts.begin(), disjuncts.end(), [](const logic::ltlf_ptr &arg) {
+          return arg->type_code() == logic::TypeID::t_LTLfAnd;
+        });
+    if (conjunction == disjuncts.end()) {
+      break;
+    }
+    const auto &conjuncts =
+        std::static_pointer_cast<const logic::LTLfAnd>(*conjunction)->args;
+    auto next = std::find_if(
+        conjuncts.begin(), conjuncts.end(), [](const logic::ltlf_ptr &arg) {
+          return arg->type_code() == logic::TypeID::t_LTLfOr;
+        });
+    if (next == conjuncts.end()) {
+      break;
+    }
+    nested = *next;
+    ++nb_levels;
+  }
+  REQUIRE(nb_levels == depth);
+  REQUIRE(xnf(*actual) == actual);
+}
+
+TEST_CASE("XNF memoized in the context", "[core][SDD]") {
+  auto context = logic::Context();
+  auto &table = context.memo_table(logic::Transformation::xnf);
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto until = context.make_until({a, b});
+  auto expected = xnf(*until);
+  REQUIRE(table.nb_hits() == 0);
+
+  // the unfolding of the Until is looked up in the next state
+  auto state = context.make_and({context.make_atom("c"), until});
+  REQUIRE(xnf(*state) ==
+          context.make_and({context.make_atom("c"), expected}));
+  REQUIRE(table.nb_hits() == 1);
+  REQUIRE(xnf(*state) == xnf(*state));
+  REQUIRE(table.nb_hits() == 3);
+}
+
 } // namespace Test
 } // namespace core
 } // namespace nike
\ No newline at end of file
@@ -0,0 +1,136 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch.hpp>
+#include <nike/logic/atom_set.hpp>
+#include <nike/logic/atom_visitor.hpp>
+#include <nike/logic/flat.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/nnf.hpp>
+#include <nike/logic/print.hpp>
+#include <nike/logic/size.hpp>
+
+namespace nike {
+namespace logic {
+namespace Benchmark {
+
+namespace {
+/*
+ * Formula in which each level refers twice to the level below, as in the
+ * XNF of nested temporal operators: the DAG has O(depth) nodes, the tree
+ * it unfolds to has O(2^depth).
+ */
+ltlf_ptr shared_dag(Context &context, size_t depth) {
+  ltlf_ptr formula = context.make_atom("a");
+  for (size_t i = 0; i < depth; ++i) {
+    auto atom = context.make_atom("b" + std::to_string(i));
+    auto next = context.make_and({atom, context.make_next(formula)});
+    formula = context.make_or({next, context.make_weak_next(formula)});
+  }
+  return formula;
+}
+
+/// the size as computed before memoization: one visit per tree node
+size_t tree_size(const LTLfFormula &formula) {
+  if (const auto *unary = dynamic_cast<const LTLfUnaryOp *>(&formula)) {
+    return 1 + tree_size(*unary->arg);
+  }
+  if (const auto *binary = dynamic_cast<const LTLfBinaryOp *>(&formula)) {
+    size_t result = 1;
+    for (const auto &arg : binary->args) {
+      result += tree_size(*arg);
+    }
+    return result;
+  }
+  return 1;
+}
+} // namespace
+
+TEST_CASE("size of a shared DAG", "[logic][benchmark][visitor]") {
+  auto context = Context();
+  auto formula = shared_dag(context, 16);
+  REQUIRE(size(*formula) == tree_size(*formula));
+
+  BENCHMARK("tree traversal, depth 16") { return tree_size(*formula); };
+  BENCHMARK("memoized, depth 16") { return size(*formula); };
+
+  auto deep_formula = shared_dag(context, 1000);
+  BENCHMARK("memoized, depth 1000") { return size(*deep_formula); };
+  SizeVisitor visitor;
+  visitor.apply(*deep_formula);
+  BENCHMARK("persistent cache, depth 1000") {
+    return visitor.apply(*deep_formula);
+  };
+  auto flat = FlatFormula(*deep_formula);
+  REQUIRE(size(flat) == size(*deep_formula));
+  BENCHMARK("flat layout, depth 1000") { return size(flat); };
+  BENCHMARK("flat layout and its construction, depth 1000") {
+    return size(FlatFormula(*deep_formula));
+  };
+}
+
+TEST_CASE("passes over a shared DAG", "[logic][benchmark][visitor]") {
+  auto context = Context();
+  auto formula = shared_dag(context, 1000);
+  auto negated = context.make_not(formula);
+
+  BENCHMARK("nnf, depth 1000") { return to_nnf(*negated); };
+
+  auto formula_100 = shared_dag(context, 100);
+  BENCHMARK("find atoms, depth 100") { return find_atoms(*formula_100); };
+  BENCHMARK("find atom set, depth 100") {
+    return find_atom_set(*formula_100);
+  };
+
+  auto small_formula = shared_dag(context, 12);
+  BENCHMARK("print, depth 12") { return to_string(*small_formula); };
+}
+
+TEST_CASE("passes over a deep chain", "[logic][benchmark][visitor]") {
+  auto context = Context();
+  // !(X !(X ... !a)), too deep for a recursive traversal
+  ltlf_ptr formula = context.make_atom("a");
+  for (size_t i = 0; i < 1000000; ++i) {
+    formula = context.make_not(context.make_next(formula));
+  }
+  auto nnf = to_nnf(*formula);
+
+  BENCHMARK("nnf, depth 10^6") { return to_nnf(*formula); };
+  BENCHMARK("size, depth 10^6") { return size(*nnf); };
+  auto flat = FlatFormula(*nnf);
+  BENCHMARK("size of the flat layout, depth 10^6") { return size(flat); };
+
+  auto shallow = context.make_not(shared_dag(context, 8));
+  BENCHMARK("nnf, depth 8") { return to_nnf(*shallow); };
+}
+
+TEST_CASE("shared pointer of a node", "[logic][benchmark][visitor]") {
+  auto context = Context();
+  auto formula = shared_dag(context, 8);
+  const LTLfFormula &node = *formula;
+
+  BENCHMARK("cast of shared_from_this()") {
+    return std::static_pointer_cast<const LTLfFormula>(
+        node.shared_from_this());
+  };
+  BENCHMARK("shared_from()") { return shared_from(node); };
+}
+
+} // namespace Benchmark
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,126 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <nike/logic/atom_set.hpp>
+#include <nike/logic/pl.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief And-inverter graph over the propositions of a context.
+ *
+ * The nodes are the constant false, inputs and two-input conjunctions,
+ * stored in a vector. An edge is twice the index of a node, plus one if
+ * it is negated, so negation is free and false and true are the edges 0
+ * and 1. The conjunctions are hashed structurally and simplified when
+ * built: constants are propagated, and a & a = a, a & !a = false.
+ *
+ * An input stands for a proposition of a PL literal, i.e. a symbol or a
+ * subformula kept by to_pl, and keeps it alive. The nodes are only freed
+ * by rollback, in the reverse order of their creation, so that a search
+ * can drop the nodes built below a state when it leaves it.
+ */
+class Aig {
+public:
+  using Edge = uint32_t;
+  static constexpr Edge false_edge = 0;
+  static constexpr Edge true_edge = 1;
+
+  static Edge negate(Edge edge) { return edge ^ 1; }
+  static bool is_negated(Edge edge) { return (edge & 1) != 0; }
+
+  Aig();
+
+  Edge make_input(const ast_ptr &proposition);
+  Edge make_and(Edge left, Edge right);
+  Edge make_or(Edge left, Edge right) {
+    return negate(make_and(negate(left), negate(right)));
+  }
+
+  static bool is_constant(Edge edge) { return edge <= true_edge; }
+  bool is_input(Edge edge) const {
+    return nodes_[edge >> 1].left == input_marker_;
+  }
+  bool is_and(Edge edge) const {
+    return !is_constant(edge) and !is_input(edge);
+  }
+  /// the fanins of a conjunction, regardless of the negation of the edge
+  Edge left(Edge edge) const { return nodes_[edge >> 1].left; }
+  Edge right(Edge edge) const { return nodes_[edge >> 1].right; }
+  /// the proposition of an input, regardless of the negation of the edge
+  const ast_ptr &proposition(Edge edge) const {
+    return propositions_[nodes_[edge >> 1].right];
+  }
+
+  /**
+   * \brief The indices of the symbols of the inputs in the cone of the
+   * edge, as AtomSetVisitor does for the PL formula.
+   */
+  AtomSet support(Edge root);
+  /**
+   * \brief The edge with the input of the proposition replaced by a
+   * constant, in time linear in its cone.
+   */
+  Edge cofactor(Edge root, const AstNode &proposition, bool value);
+
+  /// number of nodes, including the constant
+  size_t nb_nodes() const { return nodes_.size(); }
+  /// free the nodes created after the graph had that many nodes
+  void rollback(size_t nb_nodes);
+  void clear() { rollback(1); }
+
+private:
+  // an input has this left fanin, and the index of its proposition as
+  // right fanin
+  static constexpr Edge input_marker_ = UINT32_MAX;
+  struct Node {
+    Edge left;
+    Edge right;
+  };
+  std::vector<Node> nodes_;
+  std::vector<ast_ptr> propositions_;
+  std::unordered_map<uint64_t, uint32_t> and_table_;
+  std::unordered_map<const AstNode *, uint32_t> input_table_;
+
+  // scratch of the traversals of a cone, kept across calls: the results
+  // are valid for the nodes marked with the current mark
+  std::vector<uint32_t> marks_;
+  std::vector<Edge> results_;
+  std::vector<uint32_t> stack_;
+  uint32_t mark_ = 0;
+
+  static uint64_t and_key_(Edge left, Edge right) {
+    return (uint64_t(left) << 32) | right;
+  }
+  void new_mark_();
+};
+
+/// the AIG edge of a PL formula
+Aig::Edge to_aig(Aig &aig, const PLFormula &formula);
+/**
+ * \brief The PL formula of an AIG edge, in negation normal form: the
+ * negations are pushed down to the literals.
+ */
+pl_ptr to_pl(Context &context, const Aig &aig, Aig::Edge root);
+
+} // namespace logic
+} // namespace nike
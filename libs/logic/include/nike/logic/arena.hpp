@@ -0,0 +1,134 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Slab allocator for the AST nodes of a context.
+ *
+ * Blocks are carved out of large chunks and grouped in size classes of
+ * `granularity` bytes; a freed block goes back to the free list of its
+ * class and is reused by the next node of similar size, e.g. the many
+ * temporary nodes that turn out to be already interned. Chunks are only
+ * returned to the system when the arena is destroyed, all at once.
+ * Requests larger than `max_block_size` bypass the arena.
+ *
+ * When synchronized, allocation and deallocation take a spinlock, so that
+ * nodes can be created and released from several threads; the context
+ * synchronizes its arena along with its table.
+ */
+class NodeArena {
+public:
+  static const size_t granularity = 16;
+  static const size_t max_block_size = 256;
+  static const size_t chunk_size = 64 * 1024;
+
+  NodeArena() = default;
+  NodeArena(const NodeArena &) = delete;
+  NodeArena &operator=(const NodeArena &) = delete;
+  ~NodeArena();
+
+  void *allocate(size_t size);
+  void deallocate(void *p, size_t size);
+
+  /// number of chunks obtained from the system
+  size_t nb_chunks() const { return chunks_.size(); }
+  /// number of blocks handed out and not yet released
+  size_t nb_live_blocks() const { return nb_live_blocks_; }
+  /// number of bytes obtained from the system
+  size_t nb_reserved_bytes() const { return chunks_.size() * chunk_size; }
+
+  /// must not be called while other threads use the arena
+  void set_synchronized(bool value) { synchronized_ = value; }
+  bool is_synchronized() const { return synchronized_; }
+
+private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+  static const size_t nb_classes = max_block_size / granularity;
+
+  std::array<FreeBlock *, nb_classes> free_lists_{};
+  std::vector<char *> chunks_;
+  char *cursor_ = nullptr;
+  char *chunk_end_ = nullptr;
+  size_t nb_live_blocks_ = 0;
+  std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+  bool synchronized_ = false;
+
+  static size_t class_of_(size_t size) {
+    return (size + granularity - 1) / granularity - 1;
+  }
+  void lock_acquire_() {
+    if (!synchronized_) {
+      return;
+    }
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+    }
+  }
+  void lock_release_() {
+    if (synchronized_) {
+      lock_.clear(std::memory_order_release);
+    }
+  }
+};
+
+/**
+ * \brief Standard allocator over a NodeArena.
+ *
+ * Meant for std::allocate_shared: the node and its control block share one
+ * arena block, and the control block keeps the arena alive, so a node
+ * that outlives its context still releases its memory safely.
+ */
+template <typename T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(std::shared_ptr<NodeArena> arena)
+      : arena_{std::move(arena)} {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_{other.arena_} {}
+
+  T *allocate(size_t n) {
+    static_assert(alignof(T) <= NodeArena::granularity,
+                  "arena blocks are not aligned enough");
+    return static_cast<T *>(arena_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) { arena_->deallocate(p, n * sizeof(T)); }
+
+  template <typename U> bool operator==(const ArenaAllocator<U> &o) const {
+    return arena_ == o.arena_;
+  }
+  template <typename U> bool operator!=(const ArenaAllocator<U> &o) const {
+    return arena_ != o.arena_;
+  }
+
+private:
+  template <typename U> friend class ArenaAllocator;
+  std::shared_ptr<NodeArena> arena_;
+};
+
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,177 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <nike/logic/traversal.hpp>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Set of symbols of a context, as a bitset over their indices.
+ *
+ * The first `nb_inline_bits` indices are stored inline, so that the sets
+ * of the usual specifications need no allocation; larger indices spill to
+ * a vector of words. Union, intersection and the smallest element take a
+ * few word operations each.
+ */
+class AtomSet {
+public:
+  static constexpr size_t npos = SIZE_MAX;
+  static constexpr size_t word_bits = 64;
+  static constexpr size_t nb_inline_words = 2;
+  static constexpr size_t nb_inline_bits = nb_inline_words * word_bits;
+
+  AtomSet() = default;
+
+  void insert(size_t index) {
+    auto w = index / word_bits;
+    if (w >= nb_words_()) {
+      heap_.resize(w + 1 - nb_inline_words, 0);
+    }
+    word_(w) |= uint64_t(1) << (index % word_bits);
+  }
+  bool contains(size_t index) const {
+    return (get_word_(index / word_bits) >> (index % word_bits)) & 1;
+  }
+  bool empty() const {
+    for (size_t w = 0; w < nb_words_(); ++w) {
+      if (get_word_(w) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+  size_t size() const {
+    size_t result = 0;
+    for (size_t w = 0; w < nb_words_(); ++w) {
+      result += __builtin_popcountll(get_word_(w));
+    }
+    return result;
+  }
+
+  /// the smallest element, or npos if the set is empty
+  size_t first() const { return next(0); }
+  /// the smallest element not less than index, or npos if there is none
+  size_t next(size_t index) const {
+    auto w = index / word_bits;
+    if (w >= nb_words_()) {
+      return npos;
+    }
+    auto bits = get_word_(w) & (~uint64_t(0) << (index % word_bits));
+    while (bits == 0) {
+      if (++w == nb_words_()) {
+        return npos;
+      }
+      bits = get_word_(w);
+    }
+    return w * word_bits + __builtin_ctzll(bits);
+  }
+
+  AtomSet &operator|=(const AtomSet &other) {
+    if (other.heap_.size() > heap_.size()) {
+      heap_.resize(other.heap_.size(), 0);
+    }
+    for (size_t w = 0; w < other.nb_words_(); ++w) {
+      word_(w) |= other.get_word_(w);
+    }
+    return *this;
+  }
+  AtomSet &operator&=(const AtomSet &other) {
+    if (other.heap_.size() < heap_.size()) {
+      heap_.resize(other.heap_.size());
+    }
+    for (size_t w = 0; w < nb_words_(); ++w) {
+      word_(w) &= other.get_word_(w);
+    }
+    return *this;
+  }
+  bool intersects(const AtomSet &other) const {
+    auto nb_words = std::min(nb_words_(), other.nb_words_());
+    for (size_t w = 0; w < nb_words; ++w) {
+      if ((get_word_(w) & other.get_word_(w)) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  friend AtomSet operator|(AtomSet a, const AtomSet &b) { return a |= b; }
+  friend AtomSet operator&(AtomSet a, const AtomSet &b) { return a &= b; }
+  /// missing words count as zero, whatever the capacity of the sets
+  friend bool operator==(const AtomSet &a, const AtomSet &b) {
+    auto nb_words = std::max(a.nb_words_(), b.nb_words_());
+    for (size_t w = 0; w < nb_words; ++w) {
+      if (a.get_word_(w) != b.get_word_(w)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  friend bool operator!=(const AtomSet &a, const AtomSet &b) {
+    return !(a == b);
+  }
+
+private:
+  std::array<uint64_t, nb_inline_words> inline_{};
+  // the words after the inline ones
+  std::vector<uint64_t> heap_;
+
+  size_t nb_words_() const { return nb_inline_words + heap_.size(); }
+  uint64_t get_word_(size_t w) const {
+    if (w < nb_inline_words) {
+      return inline_[w];
+    }
+    w -= nb_inline_words;
+    return w < heap_.size() ? heap_[w] : 0;
+  }
+  uint64_t &word_(size_t w) {
+    return w < nb_inline_words ? inline_[w] : heap_[w - nb_inline_words];
+  }
+};
+
+/**
+ * \brief The symbols of a formula, as a set of symbol indices.
+ *
+ * Same symbols as AtomsVisitor, except that the propositions of PL
+ * literals that are not symbols (e.g. the temporal subformulas kept by
+ * to_pl) are left out. The sets are cached per node until clear_cache().
+ */
+class AtomSetVisitor
+    : public PostOrderVisitor<AtomSetVisitor, AstNode, AtomSet, 2> {
+public:
+  /// memoized on the nodes of the formula
+  AtomSet apply(const LTLfFormula &formula);
+  AtomSet apply(const PLFormula &formula);
+
+  void expand(const AstNode &f, size_t tag);
+  AtomSet combine(const AstNode &f, size_t tag, const AtomSet *args);
+
+private:
+  static constexpr size_t ltlf = 0;
+  static constexpr size_t pl = 1;
+};
+
+AtomSet find_atom_set(const LTLfFormula &);
+AtomSet find_atom_set(const PLFormula &);
+
+} // namespace logic
+} // namespace nike
@@ -17,45 +17,23 @@
  */
 
 #include <nike/logic/utils.hpp>
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/traversal.hpp>
 
 namespace nike {
 namespace logic {
 
-class AtomsVisitor : public Visitor {
-protected:
-  set_ast_ptr result;
-
+class AtomsVisitor
+    : public PostOrderVisitor<AtomsVisitor, AstNode, set_ast_ptr, 2> {
 public:
-  void visit(const PLTrue &) override;
-  void visit(const PLFalse &) override;
-  void visit(const PLLiteral &) override;
-  void visit(const PLAnd &) override;
-  void visit(const PLOr &) override;
-
-  void visit(const LTLfTrue &) override;
-  void visit(const LTLfFalse &) override;
-  void visit(const LTLfPropTrue &) override;
-  void visit(const LTLfPropFalse &) override;
-  void visit(const LTLfAtom &) override;
-  void visit(const LTLfNot &) override;
-  void visit(const LTLfPropositionalNot &) override;
-  void visit(const LTLfAnd &) override;
-  void visit(const LTLfOr &) override;
-  void visit(const LTLfImplies &) override;
-  void visit(const LTLfEquivalent &) override;
-  void visit(const LTLfXor &) override;
-  void visit(const LTLfNext &) override;
-  void visit(const LTLfWeakNext &) override;
-  void visit(const LTLfUntil &) override;
-  void visit(const LTLfRelease &) override;
-  void visit(const LTLfEventually &) override;
-  void visit(const LTLfAlways &) override;
-
   set_ast_ptr apply(const LTLfFormula &b);
   set_ast_ptr apply(const PLFormula &b);
-  void visit_binary_op(const LTLfBinaryOp &f);
-  void visit_unary_op(const LTLfUnaryOp &f);
+
+  void expand(const AstNode &f, size_t tag);
+  set_ast_ptr combine(const AstNode &f, size_t tag, const set_ast_ptr *args);
+
+private:
+  static constexpr size_t ltlf = 0;
+  static constexpr size_t pl = 1;
 };
 
 set_ast_ptr find_atoms(const LTLfFormula &);
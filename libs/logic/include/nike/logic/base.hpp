@@ -18,10 +18,14 @@
 
 #include "metadata.hpp"
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include <nike/logic/arena.hpp>
 #include <nike/logic/comparable.hpp>
 #include <nike/logic/hashable.hpp>
 #include <nike/logic/hashtable.hpp>
+#include <nike/logic/memo.hpp>
+#include <nike/logic/simplify.hpp>
 #include <nike/logic/visitable.hpp>
 #include <nike/utils.hpp>
 #include <utility>
@@ -37,20 +41,82 @@ class AstNode : public Visitable,
                 public std::enable_shared_from_this<const AstNode> {
 private:
   Context *m_ctx_;
+  // assigned by the hash table when the node is interned
+  mutable uint32_t id_ = no_id;
+  // cache of get_type_code(), negative until the first call of type_code()
+  mutable int8_t type_code_ = -1;
+  // the pointer of the hash table entry, set while the node is interned
+  mutable const ast_ptr *owner_ = nullptr;
   friend Context;
+  friend HashTable;
 
 protected:
   Metadata metadata_;
 
 public:
+  static const uint32_t no_id = UINT32_MAX;
+
   explicit AstNode(Context &ctx) : m_ctx_{&ctx} {}
   Context &ctx() const { return *m_ctx_; }
   Metadata metadata() const { return metadata_; }
+  /**
+   * \brief Dense identifier of the node in its context.
+   *
+   * Interned nodes are numbered from 0 in creation order; the others have
+   * no_id.
+   */
+  uint32_t id() const { return id_; }
+  bool has_id() const { return id_ != no_id; }
+  /**
+   * \brief Borrowed reference to the shared pointer that owns the node in
+   * the hash table of its context.
+   *
+   * Unlike shared_from_this(), no reference count is touched. The pointer
+   * stays valid as long as the node is alive and its context exists; it is
+   * nullptr for the nodes that are not interned, and once the context is
+   * destroyed.
+   */
+  const ast_ptr *owner() const { return owner_; }
+  /// same as get_type_code(), without the virtual call once cached
+  TypeID type_code() const {
+    if (type_code_ < 0) {
+      type_code_ = static_cast<int8_t>(get_type_code());
+    }
+    return static_cast<TypeID>(type_code_);
+  }
+
+  /*
+   * Interned nodes of the same context are equal only if they are the same
+   * node, and they are ordered by id. Nodes that are not interned, or that
+   * belong to different contexts, are compared structurally.
+   */
+  bool compare_identity_(const Comparable &o, int &result) const override {
+    const auto &other = static_cast<const AstNode &>(o);
+    if (m_ctx_ != other.m_ctx_ or !has_id() or !other.has_id()) {
+      return false;
+    }
+    result = id_ == other.id_ ? 0 : id_ < other.id_ ? -1 : 1;
+    return true;
+  }
   friend void check_context(AstNode const &a, AstNode const &b) {
     assert(a.m_ctx_ == b.m_ctx_);
   };
 };
 
+/**
+ * \brief Shared pointer to a node, typed as the node.
+ *
+ * For an interned node, this copies the pointer of the hash table: one
+ * increment of the reference count, where casting shared_from_this() locks
+ * a weak reference and copies the result once more.
+ */
+template <typename T> std::shared_ptr<const T> shared_from(const T &node) {
+  if (const auto *owner = node.owner()) {
+    return std::shared_ptr<const T>(*owner, &node);
+  }
+  return std::static_pointer_cast<const T>(node.shared_from_this());
+}
+
 class StringSymbol : public AstNode {
 public:
   const std::string name;
@@ -63,10 +129,25 @@ public:
   inline hash_t compute_hash_() const override;
   bool is_equal(const Comparable &o) const override;
   int compare_(const Comparable &o) const override;
+
+  /**
+   * \brief Dense index of the symbol among the symbols of its context.
+   *
+   * Interned symbols are numbered from 0 in creation order, like ids but
+   * without the other nodes in between; the others have no_id. As for ids,
+   * the indices of freed symbols are not reused.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  // assigned by the hash table when the symbol is interned
+  mutable uint32_t index_ = no_id;
+  friend HashTable;
 };
 
 class Context {
 private:
+  std::shared_ptr<NodeArena> arena_;
   std::unique_ptr<HashTable> table_;
 
   ltlf_ptr tt;
@@ -79,8 +160,103 @@ private:
   pl_ptr true_;
   pl_ptr false_;
 
+  bool simplifying_ = false;
+  SimplificationStats simplification_stats_;
+  // after the hash table: the results are released before the nodes
+  std::array<MemoTable, nb_transformations> memo_tables_;
+
+  template <typename T, typename Predicate, typename... Args>
+  std::shared_ptr<const T> intern_(hash_t hash, Predicate matches,
+                                   Args &&...args);
+  template <typename T> ltlf_ptr make_unary_(const ltlf_ptr &arg);
+
 public:
   Context();
+
+  /**
+   * \brief Allow node creation from several threads at once.
+   *
+   * Off by default: interning then takes no lock. It must not be switched
+   * while other threads create nodes in this context.
+   */
+  void set_thread_safe(bool value);
+  bool is_thread_safe() const;
+
+  /**
+   * \brief Rewrite the nodes built by the LTLf factories with the rules of
+   * simplify.hpp, except next_distribution.
+   *
+   * Off by default: the factories then only flatten and drop constants.
+   * Equivalent formulas that the rules bring to the same form are then
+   * the same node, e.g. the same state of the search. It must not be
+   * switched while other threads create nodes in this context.
+   */
+  void set_simplification(bool value);
+  bool is_simplifying() const;
+  /// number of times each rewrite rule fired in this context
+  SimplificationStats &simplification_stats();
+
+  /**
+   * \brief The memo table of a transformation of the formulas of this
+   * context, shared by its passes.
+   *
+   * The tables are kept across passes and garbage collections, and
+   * emptied when the simplification is switched, since the results depend
+   * on it.
+   */
+  MemoTable &memo_table(Transformation transformation);
+
+  /**
+   * \brief Allocate a new, not interned, node in the arena of the context.
+   */
+  template <typename T, typename... Args>
+  std::shared_ptr<const T> make_node(Args &&...args) {
+    auto node = std::allocate_shared<T>(ArenaAllocator<T>(arena_), *this,
+                                        std::forward<Args>(args)...);
+    // hash eagerly: once the node is shared, its cached hash and type code
+    // are read-only
+    node->hash();
+    node->type_code();
+    return node;
+  }
+  const NodeArena &arena() const { return *arena_; }
+  /// upper bound on the ids of the nodes of this context
+  uint32_t nb_ids() const;
+  /// number of interned nodes whose hash equals the one of another node
+  size_t nb_hash_collisions() const;
+  /// number of interned nodes
+  size_t nb_nodes() const;
+  /// number of interned symbols, i.e. upper bound on their indices
+  uint32_t nb_symbols() const;
+  /// the interned symbol with the given index, or nullptr if it was freed
+  ast_ptr symbol(uint32_t index) const;
+
+  /**
+   * \brief Free the interned nodes that are not referenced anymore.
+   *
+   * The roots are the nodes held by a shared pointer outside of the
+   * context: a node survives if it is reachable from one of them. Code
+   * that keeps nodes by raw pointer or reference only must not call it.
+   * Ids of freed nodes are not reused, hence NodeMap entries of dead
+   * nodes are never looked up again. The memory of the freed nodes goes
+   * back to the arena of the context, for the next nodes: it is not
+   * returned to the system.
+   *
+   * \return the number of freed nodes.
+   */
+  size_t collect_garbage();
+
+  /**
+   * \brief The interned node of type T on the given arguments.
+   *
+   * The table is probed by the signature of the node (its type and its
+   * arguments), so that the node is only allocated if it is new. The
+   * arguments are taken in order: commutative operators expect them
+   * already sorted.
+   */
+  template <typename T, typename Container>
+  std::shared_ptr<const T> make_nary_node(const Container &args);
+
   ast_ptr make_string_symbol(const std::string &);
   ltlf_ptr make_tt();
   ltlf_ptr make_ff();
@@ -121,7 +297,10 @@ template <typename T, typename caller, typename True, typename False,
 std::shared_ptr<T>
 and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
        bool op_x_notx, std::shared_ptr<T> (Context::*const &fun_ptr)(bool x)) {
-  std::set<std::shared_ptr<const T>, utils::Deref::Less> args;
+  // collected in a vector and sorted once: inserting in a set the
+  // flattened arguments of long conjunctions built pairwise is quadratic
+  std::vector<std::shared_ptr<const T>> args;
+  args.reserve(s.size());
   for (auto &a : s) {
     // handle the case when a subformula is true
     if (is_a<True>(*a)) {
@@ -141,17 +320,19 @@ and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
     else if (is_a<caller>(*a)) {
       const auto &to_insert = dynamic_cast<const caller &>(*a);
       const auto &container = to_insert.args;
-      args.insert(container.begin(), container.end());
+      args.insert(args.end(), container.begin(), container.end());
       continue;
     } else {
-      args.insert(a);
+      args.push_back(a);
     }
   }
+  args = utils::setify<std::shared_ptr<const T>, utils::EqualOrDeref,
+                       utils::Deref::Less>(std::move(args));
   if (args.size() == 1)
     return *(args.begin());
   if (args.empty())
     return (context.*fun_ptr)(not op_x_notx);
-  return std::make_shared<caller>(context, args);
+  return context.template make_nary_node<caller>(args);
 }
 
 template <typename T, typename caller, typename True, typename False,
@@ -161,7 +342,9 @@ std::shared_ptr<T>
 ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
             bool op_x_notx,
             std::shared_ptr<T> (Context::*const &fun_ptr)(bool x)) {
-  std::set<std::shared_ptr<const T>, utils::Deref::Less> args;
+  // sorted once, as in and_or
+  std::vector<std::shared_ptr<const T>> args;
+  args.reserve(s.size());
   for (auto &a : s) {
     // handle the case when a subformula is true
     if (is_a<True>(*a)) {
@@ -181,12 +364,14 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
     else if (is_a<caller>(*a)) {
       const auto &to_insert = dynamic_cast<const caller &>(*a);
       const auto &container = to_insert.args;
-      args.insert(container.begin(), container.end());
+      args.insert(args.end(), container.begin(), container.end());
       continue;
     } else {
-      args.insert(a);
+      args.push_back(a);
     }
   }
+  args = utils::setify<std::shared_ptr<const T>, utils::EqualOrDeref,
+                       utils::Deref::Less>(std::move(args));
   if (args.size() == 1)
     return *(args.begin());
   if (args.empty())
@@ -198,17 +383,24 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
   auto end = context.make_end();
   auto not_end = context.make_not_end();
 
+  auto find = [&args](const std::shared_ptr<const T> &formula) {
+    auto it = std::lower_bound(args.begin(), args.end(), formula,
+                               utils::Deref::Less());
+    return it != args.end() and **it == *formula ? it : args.end();
+  };
   bool end_found = false;
-  if (args.find(end) != args.end()) {
+  auto end_it = find(end);
+  if (end_it != args.end()) {
     // end found
     end_found = true;
-    args.erase(end);
+    args.erase(end_it);
   }
   bool not_end_found = false;
-  if (args.find(not_end) != args.end()) {
+  auto not_end_it = find(not_end);
+  if (not_end_it != args.end()) {
     // not-end found
     not_end_found = true;
-    args.erase(not_end);
+    args.erase(not_end_it);
   }
 
   if (end_found and not_end_found) {
@@ -216,7 +408,7 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
   }
 
   if (not end_found and not not_end_found) {
-    return std::make_shared<caller>(context, args);
+    return context.template make_nary_node<caller>(args);
   }
 
   // one of F(tt) and G(ff) is in args
@@ -246,7 +438,7 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
     return not_end;
   // F(tt) &  accepts_empty = F(tt) & accepts_empty
   if (not op_x_notx and not_end_found and global_accept_empty)
-    args.insert(not_end);
+    utils::insert_sorted(args, not_end, utils::Deref::Less());
   // F(tt) & !accepts_empty = !accepts_empty
   if (not op_x_notx and not_end_found and not global_accept_empty) {
   }
@@ -256,7 +448,7 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
   }
   // G(ff) | !accepts_empty = G(ff) | !accepts_empty
   if (op_x_notx and end_found and not global_accept_empty)
-    args.insert(end);
+    utils::insert_sorted(args, end, utils::Deref::Less());
   // G(ff) &  accepts_empty = G(ff)
   if (not op_x_notx and end_found and global_accept_empty)
     return end;
@@ -269,7 +461,7 @@ ltlf_and_or(Context &context, const std::vector<std::shared_ptr<const T>> &s,
   if (args.empty())
     return (context.*fun_ptr)(not op_x_notx);
 
-  return std::make_shared<caller>(context, args);
+  return context.template make_nary_node<caller>(args);
 }
 
 inline TypeID StringSymbol::get_type_code() const {
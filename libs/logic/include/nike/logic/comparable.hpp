@@ -78,10 +78,27 @@ public:
    * */
   virtual int compare_(const Comparable &o) const = 0;
 
+  /*! Comparison that does not look at the structure of the objects
+   * \param o - Object to be compared with
+   * \param result - set to the order of the objects, if known
+   * \return whether the order is known
+   * */
+  virtual bool compare_identity_(const Comparable & /*o*/,
+                                 int & /*result*/) const {
+    return false;
+  }
+
   int compare(const Comparable &o) const {
+    if (this == &o) {
+      return 0;
+    }
     auto a = this->get_type_code();
     auto b = o.get_type_code();
     if (a == b) {
+      int result;
+      if (compare_identity_(o, result)) {
+        return result;
+      }
       return this->compare_(o);
     } else {
       // We return the order given by the numerical value of the TypeID enum
@@ -92,7 +109,16 @@ public:
     }
   }
 
-  bool operator==(const Comparable &o) const { return this->is_equal(o); };
+  bool operator==(const Comparable &o) const {
+    if (this == &o) {
+      return true;
+    }
+    int result;
+    if (compare_identity_(o, result)) {
+      return result == 0;
+    }
+    return this->is_equal(o);
+  };
 
   bool operator!=(const Comparable &o) const { return !(*this == o); };
 
@@ -16,47 +16,46 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <nike/logic/traversal.hpp>
 #include <nike/logic/utils.hpp>
-#include <nike/logic/visitor.hpp>
 
 namespace nike {
 namespace logic {
 
-class CopyVisitor : public Visitor {
+class CopyVisitor
+    : public PostOrderVisitor<CopyVisitor, LTLfFormula, ltlf_ptr> {
 protected:
   logic::Context &context;
-  ltlf_ptr result;
 
 public:
   explicit CopyVisitor(Context &context) : context{context} {};
 
-  void visit(const LTLfTrue &) override;
-  void visit(const LTLfFalse &) override;
-  void visit(const LTLfPropTrue &) override;
-  void visit(const LTLfPropFalse &) override;
-  void visit(const LTLfAtom &) override;
-  void visit(const LTLfNot &) override;
-  void visit(const LTLfPropositionalNot &) override;
-  void visit(const LTLfAnd &) override;
-  void visit(const LTLfOr &) override;
-  void visit(const LTLfImplies &) override;
-  void visit(const LTLfEquivalent &) override;
-  void visit(const LTLfXor &) override;
-  void visit(const LTLfNext &) override;
-  void visit(const LTLfWeakNext &) override;
-  void visit(const LTLfUntil &) override;
-  void visit(const LTLfRelease &) override;
-  void visit(const LTLfEventually &) override;
-  void visit(const LTLfAlways &) override;
+  void expand(const LTLfFormula &f, size_t tag);
+  ltlf_ptr combine(const LTLfFormula &f, size_t tag, const ltlf_ptr *args);
 
-  ltlf_ptr apply(const LTLfFormula &b);
-  ltlf_ptr apply(const PLFormula &b);
-  void visit_binary_op(ltlf_ptr (Context::*fun)(const vec_ptr &),
-                       const LTLfBinaryOp &f);
-  void visit_unary_op(ltlf_ptr (Context::*fun)(const ltlf_ptr &),
-                      const LTLfUnaryOp &f);
+private:
+  ltlf_ptr combine_(const LTLfTrue &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfFalse &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropTrue &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropFalse &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAtom &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfNot &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropositionalNot &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAnd &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfOr &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfImplies &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfEquivalent &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfXor &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfNext &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfWeakNext &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfUntil &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfRelease &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfEventually &f, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAlways &f, const ltlf_ptr *args);
+  ltlf_ptr combine_binary_op_(ltlf_ptr (Context::*fun)(const vec_ptr &),
+                              const LTLfBinaryOp &f, const ltlf_ptr *args);
 };
 ltlf_ptr copy_ltlf_formula(Context &context, const LTLfFormula &f);
 ltlf_ptr copy_ltlf_formula(const LTLfFormula &f);
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
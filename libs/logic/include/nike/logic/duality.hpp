@@ -16,10 +16,7 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <cstdint>
-#include <memory>
-
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/nnf.hpp>
 
 namespace nike {
 namespace logic {
@@ -29,33 +26,11 @@ namespace logic {
  * - in case of boolean or temporal operator, apply the
  *   duality of negation to push a negation down;
  * - in case of atomic formula, return the negation of it
+ *
+ * The result is in Negation Normal Form: it is the one of NNFTransformer
+ * on the negated tag.
  */
-class NegationTransformer : public Visitor {
-public:
-  ltlf_ptr result;
-  void visit(const LTLfTrue &) override;
-  void visit(const LTLfFalse &) override;
-  void visit(const LTLfPropTrue &) override;
-  void visit(const LTLfPropFalse &) override;
-  void visit(const LTLfAtom &) override;
-  void visit(const LTLfNot &) override;
-  void visit(const LTLfPropositionalNot &) override;
-  void visit(const LTLfAnd &) override;
-  void visit(const LTLfOr &) override;
-  void visit(const LTLfImplies &) override;
-  void visit(const LTLfEquivalent &) override;
-  void visit(const LTLfXor &) override;
-  void visit(const LTLfNext &) override;
-  void visit(const LTLfWeakNext &) override;
-  void visit(const LTLfUntil &) override;
-  void visit(const LTLfRelease &) override;
-  void visit(const LTLfEventually &) override;
-  void visit(const LTLfAlways &) override;
-
-  ltlf_ptr apply(const LTLfFormula &f);
-};
-
 ltlf_ptr apply_negation(const LTLfFormula &f);
 
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <nike/logic/comparable.hpp>
+#include <nike/logic/types.hpp>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Compiled, read-only layout of an LTLf formula: its distinct
+ * subformulas in post order, in one contiguous array of records.
+ *
+ * A record holds the type code of the subformula, the range of its
+ * arguments in a shared array of record indices, and the index of the
+ * symbol of an atom or of a propositional negation. The arguments of a
+ * record come before it and the root is the last record, so a pass is a
+ * single loop over the records, with no virtual call and no pointer to
+ * chase. The layout does not keep the formula alive.
+ */
+class FlatFormula {
+public:
+  static constexpr uint32_t no_symbol = UINT32_MAX;
+
+  struct Node {
+    TypeID type;
+    uint32_t nb_args;
+    // index in the array of arguments of the first one
+    uint32_t first_arg;
+    // the index of the StringSymbol of an atom or of its negation
+    uint32_t symbol;
+  };
+
+  FlatFormula() = default;
+  /// the layout of the formula; shared subformulas get one record
+  explicit FlatFormula(const LTLfFormula &formula);
+
+  const std::vector<Node> &nodes() const { return nodes_; }
+  size_t nb_nodes() const { return nodes_.size(); }
+  bool empty() const { return nodes_.empty(); }
+  const Node &node(uint32_t index) const { return nodes_[index]; }
+  /// the index of the root, i.e. of the last record
+  uint32_t root() const { return static_cast<uint32_t>(nodes_.size() - 1); }
+  /// the indices of the records of the arguments of the node
+  const uint32_t *args(const Node &node) const {
+    return args_.data() + node.first_arg;
+  }
+
+private:
+  friend class FlatFormulaBuilder;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> args_;
+};
+
+/**
+ * \brief Size of the formula, counted as a tree, as size() of the formula
+ * it was built from.
+ */
+size_t size(const FlatFormula &formula);
+
+} // namespace logic
+} // namespace nike
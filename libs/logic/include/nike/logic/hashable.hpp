@@ -16,9 +16,85 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <nike/logic/types.hpp>
+#include <string>
+
 namespace nike {
 namespace logic {
 
+/*
+ * 64-bit mixing in the style of wyhash: multiply two words to 128 bits and
+ * fold the halves together.
+ */
+namespace hashing {
+
+const uint64_t p0 = 0xa0761d6478bd642full;
+const uint64_t p1 = 0xe7037ed1a0b428dbull;
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+  uint64_t ha = a >> 32, la = static_cast<uint32_t>(a);
+  uint64_t hb = b >> 32, lb = static_cast<uint32_t>(b);
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+  return lo ^ hi;
+#endif
+}
+
+inline uint64_t read_8(const char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+inline uint64_t read_4(const char *p) {
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+/*
+ * Hash a sequence of bytes, starting from the given seed.
+ */
+inline uint64_t bytes(const char *p, size_t len, uint64_t seed) {
+  seed ^= mix(seed ^ p0, p1);
+  uint64_t a = 0;
+  uint64_t b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      auto shift = (len >> 3) << 2;
+      a = (read_4(p) << 32) | read_4(p + shift);
+      b = (read_4(p + len - 4) << 32) | read_4(p + len - 4 - shift);
+    } else if (len > 0) {
+      a = (static_cast<uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+          (static_cast<uint64_t>(static_cast<unsigned char>(p[len >> 1]))
+           << 8) |
+          static_cast<unsigned char>(p[len - 1]);
+    }
+  } else {
+    auto i = len;
+    while (i > 16) {
+      seed = mix(read_8(p) ^ p1, read_8(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    a = read_8(p + i - 16);
+    b = read_8(p + i - 8);
+  }
+  return mix(p1 ^ len, mix(a ^ p1, b ^ seed));
+}
+
+} // namespace hashing
+
 /*
  * Abstract base class for generic hashable immutable objects.
  */
@@ -80,13 +156,11 @@ template <typename T>
 inline void hash_combine_impl(
     hash_t &seed, const T &v,
     typename std::enable_if<std::is_integral<T>::value>::type * = nullptr) {
-  seed ^= hash_t(v) + hash_t(0x9e3779b9) + (seed << 6) + (seed >> 2);
+  seed = hashing::mix(seed ^ hashing::p0, uint64_t(v) ^ hashing::p1);
 }
 
 inline void hash_combine_impl(hash_t &seed, const std::string &s) {
-  for (const auto &c : s) {
-    hash_combine<hash_t>(seed, static_cast<hash_t>(c));
-  }
+  seed = hashing::bytes(s.data(), s.size(), seed);
 }
 
 template <class T> void hash_combine(hash_t &seed, const T &v);
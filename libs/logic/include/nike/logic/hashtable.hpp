@@ -17,39 +17,149 @@
  */
 
 #include <memory>
+#include <mutex>
 #include <nike/logic/types.hpp>
 #include <nike/utils.hpp>
-#include <unordered_set>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace nike {
 namespace logic {
 
+class StringSymbol;
+
 /*
- * A hash table for AST nodes based on STL unordered_set.
+ * A hash table for AST nodes, bucketed by the hash of the nodes.
+ *
+ * Besides inserting a node, the table can be probed by signature: a hash
+ * and a predicate on the candidate nodes with that hash. This allows to
+ * look for a node without building it first.
+ *
+ * Every inserted node gets the next dense id, starting from 0. Symbols
+ * also get the next dense symbol index, and the table keeps a weak
+ * reference to them, so that indices can be mapped back to symbols.
+ *
+ * When synchronized, lookups and insertions are serialized by a mutex, so
+ * that several threads can create nodes in the same context. Since a
+ * node is hashed (and its hash cached) the first time it is looked up,
+ * this also makes the hash of interned nodes read-only.
+ *
+ * An interned node points to the shared pointer of its entry, which is
+ * the owner() of the node: entries are only erased with their node, and
+ * the table detaches the nodes that outlive it.
  */
 class HashTable {
 private:
-  std::unordered_set<ast_ptr, utils::Deref::Hash, utils::EqualOrDeref> m_table_;
+  std::unordered_multimap<hash_t, ast_ptr> m_table_;
+  std::mutex mutex_;
+  bool synchronized_ = false;
+  uint32_t next_id_ = 0;
+  std::vector<std::weak_ptr<const AstNode>> symbols_;
+  size_t nb_collisions_ = 0;
 
 public:
-  explicit HashTable() {
-    m_table_ =
-        std::unordered_set<ast_ptr, utils::Deref::Hash, utils::EqualOrDeref>{};
-  }
+  explicit HashTable() = default;
+  /*
+   * Release the nodes from the most recent, as in sweep(): a node is then
+   * never the last owner of its children when it is freed, so that
+   * freeing a deep formula does not recurse on its depth.
+   */
+  ~HashTable();
 
   template <typename T>
   std::shared_ptr<const T>
   insert_if_not_available(const std::shared_ptr<const T> &ptr) {
-    auto it = m_table_.find(ptr);
-    if (it == m_table_.end()) {
-      m_table_.insert(ptr);
-      return ptr;
-    } else {
-      return std::static_pointer_cast<const T>(*it);
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (synchronized_) {
+      lock.lock();
+    }
+    auto hash = ptr->hash();
+    auto range = m_table_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == ptr or *it->second == *ptr) {
+        return std::static_pointer_cast<const T>(it->second);
+      }
+    }
+    if (range.first != range.second) {
+      ++nb_collisions_;
+    }
+    ptr->id_ = next_id_++;
+    if constexpr (std::is_same<T, StringSymbol>::value) {
+      ptr->index_ = static_cast<uint32_t>(symbols_.size());
+      symbols_.push_back(ptr);
+    }
+    // entries are not moved by rehashing: the node can refer to its own
+    ptr->owner_ = &m_table_.emplace(hash, ptr)->second;
+    return ptr;
+  }
+
+  /*
+   * Find the node with the given hash that satisfies the predicate.
+   *
+   * Return nullptr if there is none. The node is cast to T: the predicate
+   * must only accept nodes of that type.
+   */
+  template <typename T, typename Predicate>
+  std::shared_ptr<const T> find(hash_t hash, Predicate matches) {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (synchronized_) {
+      lock.lock();
     }
+    auto range = m_table_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (matches(*it->second)) {
+        return std::static_pointer_cast<const T>(it->second);
+      }
+    }
+    return nullptr;
+  }
+
+  size_t size() {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (synchronized_) {
+      lock.lock();
+    }
+    return m_table_.size();
+  }
+
+  /*
+   * Remove the nodes that are referenced only by the table.
+   *
+   * One pass over the table finds the unreferenced nodes; the children of
+   * a removed node are then checked, and removed in turn if it was their
+   * last owner, so that a dead formula is removed in a single sweep
+   * whatever its depth. Ids are not reused. Return the number of removed
+   * nodes.
+   */
+  size_t sweep();
+
+  /// the id the next inserted node will get
+  uint32_t nb_ids() const { return next_id_; }
+
+  /// the index the next inserted symbol will get
+  uint32_t nb_symbols() {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (synchronized_) {
+      lock.lock();
+    }
+    return static_cast<uint32_t>(symbols_.size());
   }
+  /// nullptr if the symbol has been freed
+  ast_ptr symbol(uint32_t index) {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (synchronized_) {
+      lock.lock();
+    }
+    return symbols_.at(index).lock();
+  }
+
+  /// number of inserted nodes whose hash was already taken by another node
+  size_t nb_collisions() const { return nb_collisions_; }
 
-  size_t size() { return m_table_.size(); }
+  /// must not be called while other threads use the table
+  void set_synchronized(bool value) { synchronized_ = value; }
+  bool is_synchronized() const { return synchronized_; }
 };
 
 } // namespace logic
@@ -0,0 +1,93 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <nike/logic/types.hpp>
+#include <string>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/// the transformations whose results are memoized in the context
+enum class Transformation {
+  nnf,
+  xnf,
+  strip_next,
+};
+const size_t nb_transformations = 3;
+
+std::string transformation_to_string(Transformation transformation);
+
+/**
+ * \brief Bounded memo table of a pure transformation of the interned
+ * formulas of a context, kept across passes.
+ *
+ * The table is direct-mapped on the id of the formula and a tag, e.g. the
+ * polarity for the negation normal form: an entry evicts the one in its
+ * slot. Ids of freed nodes are not reused, so the table can be kept across
+ * garbage collections: the entries of dead nodes are never hit, until
+ * they are evicted. The results in the table are kept alive.
+ */
+class MemoTable {
+public:
+  static constexpr size_t default_capacity = size_t(1) << 16;
+
+  /// the result of the formula with the tag, if it is in the table
+  bool find(const LTLfFormula &formula, size_t tag, ltlf_ptr &result);
+  void insert(const LTLfFormula &formula, size_t tag, const ltlf_ptr &result);
+
+  /// number of entries, rounded up to a power of two; 0 disables the table
+  void set_capacity(size_t capacity);
+  size_t capacity() const { return capacity_; }
+  /// number of occupied entries
+  size_t size() const;
+  void clear();
+
+  size_t nb_hits() const { return nb_hits_.load(std::memory_order_relaxed); }
+  size_t nb_misses() const {
+    return nb_misses_.load(std::memory_order_relaxed);
+  }
+  /// ratio of the lookups that hit, 0 if there was none
+  double hit_rate() const;
+  void reset_counts();
+
+  /// lock the table on each access, as the hash table of a thread-safe
+  /// context
+  void set_synchronized(bool value) { synchronized_ = value; }
+
+private:
+  struct Entry {
+    uint32_t id;
+    uint32_t tag;
+    ltlf_ptr result;
+  };
+  std::vector<Entry> entries_;
+  size_t capacity_ = default_capacity;
+  size_t size_ = 0;
+  std::atomic<size_t> nb_hits_{0};
+  std::atomic<size_t> nb_misses_{0};
+  bool synchronized_ = false;
+  mutable std::mutex mutex_;
+
+  Entry *slot_(uint32_t id, size_t tag);
+};
+
+} // namespace logic
+} // namespace nike
@@ -19,39 +19,63 @@
 #include <cstdint>
 #include <memory>
 
+#include <nike/logic/traversal.hpp>
 #include <nike/logic/utils.hpp>
-#include <nike/logic/visitor.hpp>
 
 namespace nike {
 namespace logic {
 
-class NNFTransformer : public Visitor {
+/*
+ * Transform a formula in Negation Normal Form.
+ *
+ * The tag of a node tells whether the negation of the node is transformed:
+ * a negation is pushed down by visiting the argument with the opposite
+ * tag, and the operators of a negated node are replaced by their duals.
+ */
+class NNFTransformer : public MemoizedPostOrderVisitor<NNFTransformer, 2> {
 public:
-  ltlf_ptr result;
-
-  void visit(const LTLfTrue &) override;
-  void visit(const LTLfFalse &) override;
-  void visit(const LTLfPropTrue &) override;
-  void visit(const LTLfPropFalse &) override;
-  void visit(const LTLfAtom &) override;
-  void visit(const LTLfNot &) override;
-  void visit(const LTLfPropositionalNot &) override;
-  void visit(const LTLfAnd &) override;
-  void visit(const LTLfOr &) override;
-  void visit(const LTLfImplies &) override;
-  void visit(const LTLfEquivalent &) override;
-  void visit(const LTLfXor &) override;
-  void visit(const LTLfNext &) override;
-  void visit(const LTLfWeakNext &) override;
-  void visit(const LTLfUntil &) override;
-  void visit(const LTLfRelease &) override;
-  void visit(const LTLfEventually &) override;
-  void visit(const LTLfAlways &) override;
-
-  ltlf_ptr apply(const LTLfFormula &f);
+  static constexpr size_t positive = 0;
+  static constexpr size_t negated = 1;
+
+  explicit NNFTransformer(MemoTable *memo_table = nullptr)
+      : MemoizedPostOrderVisitor{memo_table} {}
+
+  void expand(const LTLfFormula &f, size_t tag);
+  ltlf_ptr combine(const LTLfFormula &f, size_t tag, const ltlf_ptr *args);
+
+private:
+  void expand_(const LTLfFormula &f, size_t tag);
+  void expand_(const LTLfPropositionalNot &f, size_t tag);
+  void expand_(const LTLfNot &f, size_t tag);
+  void expand_(const LTLfUnaryOp &f, size_t tag);
+  void expand_(const LTLfBinaryOp &f, size_t tag);
+  void expand_(const LTLfImplies &f, size_t tag);
+  void expand_(const LTLfEquivalent &f, size_t tag);
+  void expand_(const LTLfXor &f, size_t tag);
+
+  ltlf_ptr combine_(const LTLfTrue &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfFalse &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropTrue &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropFalse &f, bool negate,
+                    const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAtom &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfPropositionalNot &f, bool negate,
+                    const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAnd &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfOr &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfNext &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfWeakNext &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfUntil &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfRelease &f, bool negate, const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfEventually &f, bool negate,
+                    const ltlf_ptr *args);
+  ltlf_ptr combine_(const LTLfAlways &f, bool negate, const ltlf_ptr *args);
+  // the formulas rewritten by expand_ (Not, Implies, Equivalent, Xor)
+  ltlf_ptr combine_(const LTLfFormula &f, bool negate, const ltlf_ptr *args);
 };
 
+/// memoized in the context of the formula
 ltlf_ptr to_nnf(const LTLfFormula &f);
 
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
@@ -0,0 +1,266 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <nike/logic/base.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Map from the interned nodes of a context to values of type T.
+ *
+ * The values are stored in a vector indexed by the id of the node, so
+ * lookups take constant time and no comparison of formulas. All the keys
+ * must belong to the same context. The map does not keep its keys alive.
+ */
+template <typename T> class NodeMap {
+public:
+  NodeMap() = default;
+  /// reserve room for the ids of the nodes of a context
+  explicit NodeMap(const Context &context) { reserve(context.nb_ids()); }
+
+  void reserve(size_t nb_ids) {
+    values_.reserve(nb_ids);
+    present_.reserve(nb_ids);
+  }
+
+  /// the value of the node, or nullptr if there is none
+  T *find(const AstNode &node) {
+    return contains(node) ? &values_[node.id()] : nullptr;
+  }
+  const T *find(const AstNode &node) const {
+    return contains(node) ? &values_[node.id()] : nullptr;
+  }
+  bool contains(const AstNode &node) const {
+    return node.has_id() and node.id() < present_.size() and
+           present_[node.id()];
+  }
+
+  /// the value of the node, default-constructed if there is none
+  T &operator[](const AstNode &node) {
+    auto id = checked_id_(node);
+    if (!present_[id]) {
+      present_[id] = true;
+      ++size_;
+    }
+    return values_[id];
+  }
+  void insert_or_assign(const AstNode &node, T value) {
+    (*this)[node] = std::move(value);
+  }
+  bool erase(const AstNode &node) {
+    if (!contains(node)) {
+      return false;
+    }
+    values_[node.id()] = T();
+    present_[node.id()] = false;
+    --size_;
+    return true;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear() {
+    values_.clear();
+    present_.clear();
+    size_ = 0;
+  }
+
+private:
+  std::vector<T> values_;
+  std::vector<bool> present_;
+  size_t size_ = 0;
+
+  uint32_t checked_id_(const AstNode &node) {
+    if (!node.has_id()) {
+      throw std::invalid_argument("node is not interned");
+    }
+    auto id = node.id();
+    if (id >= present_.size()) {
+      values_.resize(id + 1);
+      present_.resize(id + 1, false);
+    }
+    return id;
+  }
+};
+
+/**
+ * \brief Set of interned nodes of a context, as a bitset over their ids.
+ */
+class NodeSet {
+public:
+  NodeSet() = default;
+  explicit NodeSet(const Context &context) { bits_.reserve(context.nb_ids()); }
+
+  /// false if the node was already in the set
+  bool insert(const AstNode &node) {
+    if (!node.has_id()) {
+      throw std::invalid_argument("node is not interned");
+    }
+    auto id = node.id();
+    if (id >= bits_.size()) {
+      bits_.resize(id + 1, false);
+    }
+    if (bits_[id]) {
+      return false;
+    }
+    bits_[id] = true;
+    ++size_;
+    return true;
+  }
+  bool contains(const AstNode &node) const {
+    return node.has_id() and node.id() < bits_.size() and bits_[node.id()];
+  }
+  bool erase(const AstNode &node) {
+    if (!contains(node)) {
+      return false;
+    }
+    bits_[node.id()] = false;
+    --size_;
+    return true;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear() {
+    bits_.clear();
+    size_ = 0;
+  }
+
+private:
+  std::vector<bool> bits_;
+  size_t size_ = 0;
+};
+
+/**
+ * \brief Cache of per-node results, e.g. for the duration of a pass.
+ *
+ * Unlike NodeMap, the storage grows with the number of cached nodes and
+ * not with the ids of the whole context, so that a short pass over a small
+ * formula of a large context stays cheap. Nodes that are not interned, or
+ * that do not belong to the context of the first node cached since
+ * construction or clear(), are not cached and are always recomputed.
+ * Ids are never reused, so the entries stay valid after a garbage
+ * collection of the context.
+ *
+ * The entries are kept in an open-addressing table with linear probing,
+ * so that a new entry costs no allocation of its own. The ids are mixed
+ * by a Fibonacci hash: the nodes cached by a pass are often evenly spaced
+ * in id order, which would otherwise pile up in a few slots.
+ */
+template <typename Result> class NodeCache {
+public:
+  /// the cached result of the node, or the result of compute(), cached
+  template <typename Compute>
+  Result get_or_compute(const AstNode &node, Compute compute) {
+    const auto *cached = find(node);
+    if (cached != nullptr) {
+      return *cached;
+    }
+    auto value = compute();
+    insert(node, value);
+    return value;
+  }
+
+  /// the cached result of the node, or nullptr if there is none
+  const Result *find(const AstNode &node) {
+    if (size_ == 0 or !cacheable_(node)) {
+      return nullptr;
+    }
+    auto slot = slot_(node.id());
+    return ids_[slot] == free_slot ? nullptr : &values_[slot];
+  }
+  /// cache the result of the node, if the node can be cached
+  void insert(const AstNode &node, const Result &value) {
+    if (!cacheable_(node)) {
+      return;
+    }
+    if (2 * (size_ + 1) > ids_.size()) {
+      grow_();
+    }
+    auto slot = slot_(node.id());
+    if (ids_[slot] == free_slot) {
+      ids_[slot] = node.id();
+      values_[slot] = value;
+      ++size_;
+    }
+  }
+
+  size_t size() const { return size_; }
+  void clear() {
+    std::fill(ids_.begin(), ids_.end(), free_slot);
+    std::fill(values_.begin(), values_.end(), Result());
+    size_ = 0;
+    context_ = nullptr;
+  }
+
+private:
+  static constexpr size_t initial_capacity = 16;
+  static constexpr uint32_t free_slot = AstNode::no_id;
+
+  // the ids of the entries, or free_slot; the capacity is a power of two,
+  // at least twice the number of entries
+  std::vector<uint32_t> ids_;
+  std::vector<Result> values_;
+  size_t size_ = 0;
+  // 64 - log2 of the capacity
+  unsigned shift_ = 64;
+  const Context *context_ = nullptr;
+
+  bool cacheable_(const AstNode &node) {
+    if (context_ == nullptr) {
+      context_ = &node.ctx();
+    }
+    return node.has_id() and &node.ctx() == context_;
+  }
+
+  // the slot of the id, or the free slot where it would be inserted
+  size_t slot_(uint32_t id) const {
+    const auto mask = ids_.size() - 1;
+    auto slot = static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+    while (ids_[slot] != free_slot and ids_[slot] != id) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  void grow_() {
+    auto ids = std::move(ids_);
+    auto values = std::move(values_);
+    auto capacity = std::max(initial_capacity, 2 * ids.size());
+    shift_ = 64;
+    for (auto c = capacity; c > 1; c /= 2) {
+      --shift_;
+    }
+    ids_.assign(capacity, free_slot);
+    values_.assign(capacity, Result());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (ids[i] != free_slot) {
+        auto slot = slot_(ids[i]);
+        ids_[slot] = ids[i];
+        values_[slot] = std::move(values[i]);
+      }
+    }
+  }
+};
+
+} // namespace logic
+} // namespace nike
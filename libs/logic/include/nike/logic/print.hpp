@@ -18,6 +18,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <ostream>
+#include <string>
 
 #include <nike/logic/utils.hpp>
 #include <nike/logic/visitor.hpp>
@@ -25,7 +27,7 @@
 namespace nike {
 namespace logic {
 
-class PrintVisitor : public Visitor {
+class PrintVisitor : public MemoizingVisitor<std::string> {
 private:
   void binary_op_to_string(const LTLfBinaryOp &formula,
                            const std::string &op_symbol);
@@ -33,8 +35,6 @@ private:
                           const std::string &op_symbol);
 
 public:
-  std::string result;
-
   void visit(const LTLfTrue &) override;
   void visit(const LTLfFalse &) override;
   void visit(const LTLfPropTrue &) override;
@@ -57,7 +57,36 @@ public:
   std::string apply(const LTLfFormula &f);
 };
 
+/**
+ * \brief Options of the streaming printer.
+ */
+struct PrintOptions {
+  /**
+   * Print each subformula that occurs more than once only once, as a
+   * binding of a let expression, e.g.
+   *   let s0 = (a) U (b), s1 = X[!](s0) in (s0) & (s1)
+   * Literals and constants are always printed in place.
+   */
+  bool share_subformulas = false;
+  /// stop after this many characters and end with "..."; 0 for no limit
+  size_t max_size = 0;
+};
+
+/**
+ * \brief Write the formula to the stream, as it is traversed.
+ *
+ * No string is built per subformula, and the traversal uses an explicit
+ * stack, so that large or deep formulas, e.g. expanded states, are
+ * printed in constant memory per node.
+ */
+void print(std::ostream &out, const LTLfFormula &f,
+           const PrintOptions &options = {});
+/// same as print, appending to the buffer
+void print(std::string &buffer, const LTLfFormula &f,
+           const PrintOptions &options = {});
+
 std::string to_string(const LTLfFormula &f);
+std::string to_string(const LTLfFormula &f, const PrintOptions &options);
 
 } // namespace logic
 } // namespace nike
\ No newline at end of file
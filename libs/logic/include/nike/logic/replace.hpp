@@ -17,15 +17,14 @@
  */
 
 #include <nike/logic/ltlf.hpp>
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/type_switch.hpp>
 #include <utility>
 
 namespace nike {
 namespace logic {
 
-class ReplaceVisitor : public Visitor {
+class ReplaceVisitor : public TypeSwitchVisitor<ReplaceVisitor, pl_ptr> {
 private:
-  pl_ptr result;
   std::map<ast_ptr, bool, utils::Deref::Less> replacements;
 
 public:
@@ -33,13 +32,11 @@ public:
       std::map<ast_ptr, bool, utils::Deref::Less> replacements)
       : replacements{std::move(replacements)} {}
 
-  void visit(const PLTrue &) override;
-  void visit(const PLFalse &) override;
-  void visit(const PLLiteral &) override;
-  void visit(const PLAnd &) override;
-  void visit(const PLOr &) override;
-
-  pl_ptr apply(const PLFormula &b);
+  pl_ptr visit(const PLTrue &);
+  pl_ptr visit(const PLFalse &);
+  pl_ptr visit(const PLLiteral &);
+  pl_ptr visit(const PLAnd &);
+  pl_ptr visit(const PLOr &);
 };
 
 pl_ptr replace(std::map<ast_ptr, bool, utils::Deref::Less> replacements,
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <nike/logic/types.hpp>
+#include <ostream>
+#include <string>
+
+namespace nike {
+namespace logic {
+
+/*
+ * Binary format of the DAG of LTLf formulas reachable from some roots.
+ *
+ * The file is a sequence of 32-bit words, in the byte order of the
+ * machine that wrote it, so that it can be read in place from a mapping
+ * of the file:
+ *
+ *   magic ("NIKE" "DAG\0"), version, number of symbols, of nodes, of roots
+ *   symbols: length in bytes, then the name, padded to a whole word
+ *   nodes:   type code, number of arguments, then the arguments
+ *   roots:   node indices
+ *
+ * Each node is shared, i.e. written once, and after its arguments: an
+ * argument is the index of an earlier node, or, for an atom, the index of
+ * its symbol. Reading the file back only interns the nodes in order.
+ */
+const uint32_t dag_format_version = 1;
+
+/**
+ * \brief Write the DAG of formulas reachable from the roots.
+ *
+ * The roots can share subformulas: each is written once. They must belong
+ * to the same context.
+ */
+void write_dag(std::ostream &out, const vec_ptr &roots);
+void write_dag_to_file(const std::string &filename, const vec_ptr &roots);
+
+/**
+ * \brief Intern in the context the formulas of a DAG written by
+ * write_dag, and return its roots, in the same order.
+ *
+ * The nodes are built with the factories of the context, whose
+ * simplification is suspended meanwhile, so that the formulas are read
+ * back as they were written. Throw std::runtime_error if the data is not
+ * a DAG of this version of the format.
+ */
+vec_ptr read_dag(Context &context, const char *data, size_t size);
+/// same as read_dag, on a read-only mapping of the file
+vec_ptr read_dag_from_file(Context &context, const std::string &filename);
+
+} // namespace logic
+} // namespace nike
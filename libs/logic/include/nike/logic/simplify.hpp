@@ -0,0 +1,91 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <atomic>
+#include <nike/logic/types.hpp>
+#include <string>
+
+namespace nike {
+namespace logic {
+
+/*
+ * The rewrite rules of the simplifier. Each preserves the LTLf semantics,
+ * including on the empty trace.
+ *
+ *   absorption             a & (a | b) = a,  a | (a & b) = a
+ *   complementary_literals a & !a = ff,  a | !a = true
+ *   idempotent_temporal    F F a = F a,  G G a = G a
+ *   temporal_constant      F ff = ff,  G tt = tt,  X ff = ff,  X[!] tt = tt
+ *   next_distribution      X a & X b = X(a & b),  X a | X b = X(a | b),
+ *                          and the same for the weak next
+ */
+enum class SimplificationRule {
+  absorption,
+  complementary_literals,
+  idempotent_temporal,
+  temporal_constant,
+  next_distribution,
+};
+const size_t nb_simplification_rules = 5;
+
+std::string simplification_rule_to_string(SimplificationRule rule);
+
+/**
+ * \brief Number of times each rewrite rule fired.
+ *
+ * The counters are atomic, so that the factories of a thread-safe context
+ * can update them concurrently.
+ */
+class SimplificationStats {
+public:
+  void record(SimplificationRule rule) {
+    counts_[static_cast<size_t>(rule)].fetch_add(1, std::memory_order_relaxed);
+  }
+  size_t count(SimplificationRule rule) const {
+    return counts_[static_cast<size_t>(rule)].load(std::memory_order_relaxed);
+  }
+  size_t total() const;
+  void reset();
+
+private:
+  std::array<std::atomic<size_t>, nb_simplification_rules> counts_{};
+};
+
+/**
+ * \brief Apply the rewrite rules at the root of the formula, until none
+ * applies.
+ *
+ * The arguments are assumed to be simplified already. This is what the
+ * factories of a context do on the nodes they build, when its
+ * simplification is on, with distribute_next false: next_distribution is
+ * the only rule that builds temporal subformulas the formula did not
+ * have, and the states of a search must be made of the subformulas of
+ * the closure computed beforehand.
+ */
+ltlf_ptr rewrite(const LTLfFormula &formula, bool distribute_next = false);
+
+/**
+ * \brief Apply all the rewrite rules to every subformula, bottom up.
+ *
+ * Works whether or not the simplification of the context is on.
+ */
+ltlf_ptr simplify(const LTLfFormula &formula);
+
+} // namespace logic
+} // namespace nike
@@ -16,42 +16,28 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <nike/logic/visitor.hpp>
+#include <nike/logic/traversal.hpp>
 
 namespace nike {
 namespace logic {
 
-class SizeVisitor : public logic::Visitor {
-private:
-  size_t result;
-
+/*
+ * Size of a formula, counted as a tree.
+ *
+ * The tag of a node tells whether it is an LTLf or a PL formula: the
+ * arguments of a formula are of the same kind as the formula.
+ */
+class SizeVisitor : public PostOrderVisitor<SizeVisitor, AstNode, size_t, 2> {
 public:
-  void visit(const logic::LTLfTrue &) override;
-  void visit(const logic::LTLfFalse &) override;
-  void visit(const logic::LTLfPropTrue &) override;
-  void visit(const logic::LTLfPropFalse &) override;
-  void visit(const logic::LTLfAtom &) override;
-  void visit(const logic::LTLfNot &) override;
-  void visit(const logic::LTLfPropositionalNot &) override;
-  void visit(const logic::LTLfAnd &) override;
-  void visit(const logic::LTLfOr &) override;
-  void visit(const logic::LTLfImplies &) override;
-  void visit(const logic::LTLfEquivalent &) override;
-  void visit(const logic::LTLfXor &) override;
-  void visit(const logic::LTLfNext &) override;
-  void visit(const logic::LTLfWeakNext &) override;
-  void visit(const logic::LTLfUntil &) override;
-  void visit(const logic::LTLfRelease &) override;
-  void visit(const logic::LTLfEventually &) override;
-  void visit(const logic::LTLfAlways &) override;
-  void visit(const logic::PLTrue &) override;
-  void visit(const logic::PLFalse &) override;
-  void visit(const logic::PLLiteral &) override;
-  void visit(const logic::PLAnd &) override;
-  void visit(const logic::PLOr &) override;
-
   size_t apply(const logic::LTLfFormula &formula);
   size_t apply(const logic::PLFormula &formula);
+
+  void expand(const AstNode &f, size_t tag);
+  size_t combine(const AstNode &f, size_t tag, const size_t *args);
+
+private:
+  static constexpr size_t ltlf = 0;
+  static constexpr size_t pl = 1;
 };
 
 size_t size(const logic::LTLfFormula &formula);
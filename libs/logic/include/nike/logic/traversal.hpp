@@ -0,0 +1,235 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <nike/logic/memo.hpp>
+#include <nike/logic/node_map.hpp>
+#include <nike/logic/type_switch.hpp>
+#include <utility>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Base of the passes run as a post-order traversal with an explicit
+ * stack.
+ *
+ * The top levels of a formula are visited by plain recursion, which is the
+ * fastest on shallow formulas. Below max_recursion_depth, the pending
+ * nodes are kept in a vector instead of the call stack, so that a pass
+ * runs in bounded stack space whatever the depth of the formula, e.g. on
+ * a chain of 10^6 Next. The vectors are kept across calls, so a visitor
+ * that is reused does not allocate. `Derived` defines, for the formulas
+ * it is applied to:
+ *
+ *   void expand(const Formula &f, size_t tag);
+ *   Result combine(const Formula &f, size_t tag, const Result *children);
+ *
+ * `expand` calls `push` once per child, in order, and `combine` gets the
+ * results of those children in the same order. Whether `push` visits the
+ * child right away or schedules it is up to the traversal: `expand` must
+ * not depend on it. A child can be a formula
+ * built by `expand`, e.g. a rewriting of `f`: it must be interned, so that
+ * the context keeps it alive until the end of the pass. `combine` must not
+ * apply the visitor again. `Result` must be default constructible, and
+ * cannot be bool, whose vector has no data().
+ *
+ * The tag, smaller than NbTags, tells apart several results of the same
+ * node, e.g. the negation normal form of the node and of its negation. As
+ * in MemoizingVisitor, results are cached per node and tag for as long as
+ * the visitor lives. `Derived` can also define `recall` and `remember`,
+ * to look the results up in a cache that outlives the visitor.
+ */
+template <typename Derived, typename Formula, typename Result,
+          size_t NbTags = 1>
+class PostOrderVisitor {
+public:
+  Result apply(const Formula &formula, size_t tag = 0) {
+    if (results_.capacity() == 0) {
+      // one allocation instead of a few reallocations on small formulas
+      results_.reserve(initial_capacity);
+    }
+    const auto frames_base = frames_.size();
+    const auto results_base = results_.size();
+    try {
+      return visit_(formula, tag);
+    } catch (...) {
+      frames_.resize(frames_base, Frame{});
+      results_.resize(results_base);
+      depth_ = 0;
+      iterating_ = false;
+      throw;
+    }
+  }
+
+  /// number of (node, tag) pairs whose result is cached
+  size_t nb_cached() const {
+    size_t result = 0;
+    for (const auto &cache : caches_) {
+      result += cache.size();
+    }
+    return result;
+  }
+  void clear_cache() {
+    for (auto &cache : caches_) {
+      cache.clear();
+    }
+  }
+
+protected:
+  /// a result computed by an earlier pass, e.g. in a memo table: none here
+  bool recall(const Formula & /*formula*/, size_t /*tag*/,
+              Result & /*result*/) {
+    return false;
+  }
+  /// called with the result of each formula the visitor combines
+  void remember(const Formula & /*formula*/, size_t /*tag*/,
+                const Result & /*result*/) {}
+
+  /// visit, or schedule, a child of the formula being expanded
+  void push(const Formula &formula, size_t tag = 0) {
+    if (iterating_) {
+      frames_.push_back(Frame{&formula, tag, false, 0});
+    } else {
+      results_.push_back(visit_(formula, tag));
+    }
+  }
+
+private:
+  static constexpr size_t initial_capacity = 32;
+  static constexpr size_t max_recursion_depth = 256;
+
+  struct Frame {
+    const Formula *formula = nullptr;
+    size_t tag = 0;
+    bool expanded = false;
+    // index in results_ of the result of the first child
+    size_t first_child = 0;
+  };
+  std::vector<Frame> frames_;
+  std::vector<Result> results_;
+  std::array<NodeCache<Result>, NbTags> caches_;
+  size_t depth_ = 0;
+  bool iterating_ = false;
+
+  Derived &derived_() { return static_cast<Derived &>(*this); }
+
+  // while recursing, push() visits the children right away; past
+  // max_recursion_depth, it schedules them on the explicit stack
+  Result visit_(const Formula &formula, size_t tag) {
+    const auto *cached = caches_[tag].find(formula);
+    if (cached != nullptr) {
+      return *cached;
+    }
+    Result recalled;
+    if (derived_().recall(formula, tag, recalled)) {
+      caches_[tag].insert(formula, recalled);
+      return recalled;
+    }
+    if (depth_ == max_recursion_depth) {
+      iterating_ = true;
+      auto result = iterate_(formula, tag);
+      iterating_ = false;
+      return result;
+    }
+    const auto first_child = results_.size();
+    ++depth_;
+    derived_().expand(formula, tag);
+    --depth_;
+    return combine_(formula, tag, first_child);
+  }
+
+  Result iterate_(const Formula &formula, size_t tag) {
+    const auto frames_base = frames_.size();
+    frames_.push_back(Frame{&formula, tag, false, 0});
+    while (frames_.size() > frames_base) {
+      const auto index = frames_.size() - 1;
+      if (!frames_[index].expanded) {
+        const auto &pending = frames_[index];
+        const auto *cached = caches_[pending.tag].find(*pending.formula);
+        if (cached != nullptr) {
+          results_.push_back(*cached);
+          frames_.pop_back();
+          continue;
+        }
+        Result recalled;
+        if (derived_().recall(*pending.formula, pending.tag, recalled)) {
+          caches_[pending.tag].insert(*pending.formula, recalled);
+          results_.push_back(std::move(recalled));
+          frames_.pop_back();
+          continue;
+        }
+        frames_[index].expanded = true;
+        frames_[index].first_child = results_.size();
+        derived_().expand(*pending.formula, pending.tag);
+        // the children were pushed in order: pop them in the same order
+        std::reverse(frames_.begin() + index + 1, frames_.end());
+        continue;
+      }
+      const auto frame = frames_[index];
+      frames_.pop_back();
+      results_.push_back(
+          combine_(*frame.formula, frame.tag, frame.first_child));
+    }
+    auto result = std::move(results_.back());
+    results_.pop_back();
+    return result;
+  }
+
+  // combine the results of the children, from first_child to the top of
+  // the result stack, pop them and cache the result of the formula
+  Result combine_(const Formula &formula, size_t tag, size_t first_child) {
+    auto value =
+        derived_().combine(formula, tag, results_.data() + first_child);
+    results_.resize(first_child);
+    caches_[tag].insert(formula, value);
+    derived_().remember(formula, tag, value);
+    return value;
+  }
+};
+
+/**
+ * \brief Post-order pass on LTLf formulas whose results are also kept in
+ * a memo table that outlives the visitor, e.g. the one of the context for
+ * the transformation. Without a table, it is a plain PostOrderVisitor.
+ */
+template <typename Derived, size_t NbTags = 1>
+class MemoizedPostOrderVisitor
+    : public PostOrderVisitor<Derived, LTLfFormula, ltlf_ptr, NbTags> {
+public:
+  explicit MemoizedPostOrderVisitor(MemoTable *memo_table = nullptr)
+      : memo_table_{memo_table} {}
+
+  bool recall(const LTLfFormula &formula, size_t tag, ltlf_ptr &result) {
+    return memo_table_ != nullptr and memo_table_->find(formula, tag, result);
+  }
+  void remember(const LTLfFormula &formula, size_t tag,
+                const ltlf_ptr &result) {
+    if (memo_table_ != nullptr) {
+      memo_table_->insert(formula, tag, result);
+    }
+  }
+
+private:
+  MemoTable *memo_table_;
+};
+
+} // namespace logic
+} // namespace nike
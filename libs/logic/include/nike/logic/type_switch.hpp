@@ -0,0 +1,154 @@
+#pragma once
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/pl.hpp>
+#include <nike/logic/visitor.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace nike {
+namespace logic {
+
+/**
+ * \brief Call the handler on the formula, cast to its concrete type.
+ *
+ * The concrete type is found with a switch on the cached type code: unlike
+ * accept/visit there is no virtual call, the handler (typically a generic
+ * lambda) can be inlined, and its result is returned by value.
+ */
+template <typename Handler>
+inline auto dispatch(const LTLfFormula &formula, Handler &&handler)
+    -> decltype(handler(std::declval<const LTLfTrue &>())) {
+  switch (formula.type_code()) {
+  case TypeID::t_LTLfTrue:
+    return handler(static_cast<const LTLfTrue &>(formula));
+  case TypeID::t_LTLfFalse:
+    return handler(static_cast<const LTLfFalse &>(formula));
+  case TypeID::t_LTLfPropTrue:
+    return handler(static_cast<const LTLfPropTrue &>(formula));
+  case TypeID::t_LTLfPropFalse:
+    return handler(static_cast<const LTLfPropFalse &>(formula));
+  case TypeID::t_LTLfAtom:
+    return handler(static_cast<const LTLfAtom &>(formula));
+  case TypeID::t_LTLfPropNot:
+    return handler(static_cast<const LTLfPropositionalNot &>(formula));
+  case TypeID::t_LTLfNot:
+    return handler(static_cast<const LTLfNot &>(formula));
+  case TypeID::t_LTLfAnd:
+    return handler(static_cast<const LTLfAnd &>(formula));
+  case TypeID::t_LTLfOr:
+    return handler(static_cast<const LTLfOr &>(formula));
+  case TypeID::t_LTLfImplies:
+    return handler(static_cast<const LTLfImplies &>(formula));
+  case TypeID::t_LTLfEquivalent:
+    return handler(static_cast<const LTLfEquivalent &>(formula));
+  case TypeID::t_LTLfXor:
+    return handler(static_cast<const LTLfXor &>(formula));
+  case TypeID::t_LTLfNext:
+    return handler(static_cast<const LTLfNext &>(formula));
+  case TypeID::t_LTLfWeakNext:
+    return handler(static_cast<const LTLfWeakNext &>(formula));
+  case TypeID::t_LTLfUntil:
+    return handler(static_cast<const LTLfUntil &>(formula));
+  case TypeID::t_LTLfRelease:
+    return handler(static_cast<const LTLfRelease &>(formula));
+  case TypeID::t_LTLfEventually:
+    return handler(static_cast<const LTLfEventually &>(formula));
+  case TypeID::t_LTLfAlways:
+    return handler(static_cast<const LTLfAlways &>(formula));
+  default:
+    throw_not_supported_error();
+  }
+}
+
+template <typename Handler>
+inline auto dispatch(const PLFormula &formula, Handler &&handler)
+    -> decltype(handler(std::declval<const PLTrue &>())) {
+  switch (formula.type_code()) {
+  case TypeID::t_PLTrue:
+    return handler(static_cast<const PLTrue &>(formula));
+  case TypeID::t_PLFalse:
+    return handler(static_cast<const PLFalse &>(formula));
+  case TypeID::t_PLLiteral:
+    return handler(static_cast<const PLLiteral &>(formula));
+  case TypeID::t_PLAnd:
+    return handler(static_cast<const PLAnd &>(formula));
+  case TypeID::t_PLOr:
+    return handler(static_cast<const PLOr &>(formula));
+  default:
+    throw_not_supported_error();
+  }
+}
+
+/**
+ * \brief Call the function on each argument of the formula, in order.
+ *
+ * Atoms and constants have no arguments; the argument of a propositional
+ * not is its atom.
+ */
+template <typename Function>
+inline void for_each_argument(const LTLfFormula &formula, Function &&function) {
+  dispatch(formula, [&function](const auto &f) {
+    using T = typename std::decay<decltype(f)>::type;
+    if constexpr (std::is_base_of<LTLfUnaryOp, T>::value) {
+      function(*f.arg);
+    } else if constexpr (std::is_base_of<LTLfBinaryOp, T>::value) {
+      for (const auto &arg : f.args) {
+        function(*arg);
+      }
+    }
+  });
+}
+
+template <typename Function>
+inline void for_each_argument(const PLFormula &formula, Function &&function) {
+  dispatch(formula, [&function](const auto &f) {
+    using T = typename std::decay<decltype(f)>::type;
+    if constexpr (std::is_base_of<PLBinaryOp, T>::value) {
+      for (const auto &arg : f.args) {
+        function(*arg);
+      }
+    }
+  });
+}
+
+/**
+ * \brief Base of the passes dispatched with a switch on the type code.
+ *
+ * `Derived` defines `Result visit(const T &)` for every concrete type T of
+ * the formulas it is applied to, and recurses with `apply`. Only the
+ * overloads of `apply` that are used get instantiated, so an LTLf pass
+ * needs no handler for the PL types and vice versa.
+ */
+template <typename Derived, typename Result> class TypeSwitchVisitor {
+public:
+  Result apply(const LTLfFormula &formula) {
+    return dispatch(formula, [this](const auto &f) -> Result {
+      return static_cast<Derived &>(*this).visit(f);
+    });
+  }
+  Result apply(const PLFormula &formula) {
+    return dispatch(formula, [this](const auto &f) -> Result {
+      return static_cast<Derived &>(*this).visit(f);
+    });
+  }
+};
+
+} // namespace logic
+} // namespace nike
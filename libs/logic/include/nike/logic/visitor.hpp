@@ -17,21 +17,22 @@
  */
 
 #include <nike/logic/ltlf.hpp>
+#include <nike/logic/node_map.hpp>
 #include <nike/logic/pl.hpp>
 
 namespace nike {
 namespace logic {
 
-inline void throw_not_implemented_error() {
+[[noreturn]] inline void throw_not_implemented_error() {
   throw std::logic_error("handler not implemented");
 }
-inline void throw_not_supported_error() {
+[[noreturn]] inline void throw_not_supported_error() {
   throw std::logic_error("this case is not supported");
 }
-inline void throw_expected_nnf() {
+[[noreturn]] inline void throw_expected_nnf() {
   throw std::logic_error("expected formula in Negation-Normal Form");
 }
-inline void throw_expected_xnf() {
+[[noreturn]] inline void throw_expected_xnf() {
   throw std::logic_error("expected formula in Next-Normal Form");
 }
 
@@ -70,6 +71,41 @@ public:
   virtual void visit(const LTLfAlways &) { throw_not_implemented_error(); };
 };
 
+/**
+ * \brief Visitor that computes one result per node of a formula DAG.
+ *
+ * The visit methods set `result`, and recurse on the children through
+ * `apply_`; the result of an interned node is computed only the first
+ * time the node is reached and then served from a NodeCache. A pass over
+ * a hash-consed formula thus takes time linear in the number of distinct
+ * nodes, instead of the size of the unfolded tree.
+ *
+ * The cache lives as long as the visitor. The free functions build a new
+ * visitor per call, so they cache for the duration of the pass; a caller
+ * can keep a visitor around to reuse the cache across calls when the
+ * result only depends on the node.
+ */
+template <typename Result> class MemoizingVisitor : public Visitor {
+public:
+  /// number of nodes whose result is cached
+  size_t nb_cached() const { return cache_.size(); }
+  void clear_cache() { cache_.clear(); }
+
+protected:
+  Result result{};
+
+  Result apply_(const AstNode &node) {
+    result = cache_.get_or_compute(node, [this, &node]() {
+      node.accept(*this);
+      return result;
+    });
+    return result;
+  }
+
+private:
+  NodeCache<Result> cache_;
+};
+
 template <typename VisitorClass>
 inline void apply_to_ltlf_binary_op_(VisitorClass &visitor,
                                      const logic::LTLfBinaryOp &formula) {
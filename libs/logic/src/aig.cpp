@@ -0,0 +1,247 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <nike/logic/aig.hpp>
+#include <nike/logic/traversal.hpp>
+#include <stdexcept>
+
+namespace nike {
+namespace logic {
+
+Aig::Aig() : nodes_{{false_edge, false_edge}} {}
+
+Aig::Edge Aig::make_input(const ast_ptr &proposition) {
+  auto found = input_table_.find(proposition.get());
+  if (found != input_table_.end()) {
+    return found->second << 1;
+  }
+  auto index = static_cast<uint32_t>(nodes_.size());
+  nodes_.push_back({input_marker_, static_cast<Edge>(propositions_.size())});
+  propositions_.push_back(proposition);
+  input_table_.emplace(proposition.get(), index);
+  return index << 1;
+}
+
+Aig::Edge Aig::make_and(Edge left, Edge right) {
+  if (left > right) {
+    std::swap(left, right);
+  }
+  if (left == false_edge or left == negate(right)) {
+    return false_edge;
+  }
+  if (left == true_edge or left == right) {
+    return right;
+  }
+  auto key = and_key_(left, right);
+  auto found = and_table_.find(key);
+  if (found != and_table_.end()) {
+    return found->second << 1;
+  }
+  auto index = static_cast<uint32_t>(nodes_.size());
+  if (index >= (UINT32_MAX >> 1)) {
+    throw std::length_error("too many nodes in the AIG");
+  }
+  nodes_.push_back({left, right});
+  and_table_.emplace(key, index);
+  return index << 1;
+}
+
+void Aig::new_mark_() {
+  marks_.resize(nodes_.size(), 0);
+  results_.resize(nodes_.size());
+  if (++mark_ == 0) {
+    std::fill(marks_.begin(), marks_.end(), 0);
+    mark_ = 1;
+  }
+}
+
+AtomSet Aig::support(Edge root) {
+  AtomSet result;
+  new_mark_();
+  stack_.assign(1, root >> 1);
+  while (!stack_.empty()) {
+    auto index = stack_.back();
+    stack_.pop_back();
+    if (marks_[index] == mark_) {
+      continue;
+    }
+    marks_[index] = mark_;
+    const auto &node = nodes_[index];
+    if (node.left != input_marker_) {
+      stack_.push_back(node.left >> 1);
+      stack_.push_back(node.right >> 1);
+      continue;
+    }
+    const auto &proposition = *propositions_[node.right];
+    if (is_a<StringSymbol>(proposition)) {
+      auto symbol = static_cast<const StringSymbol &>(proposition).index();
+      if (symbol != AstNode::no_id) {
+        result.insert(symbol);
+      }
+    }
+  }
+  return result;
+}
+
+Aig::Edge Aig::cofactor(Edge root, const AstNode &proposition, bool value) {
+  auto input = input_table_.find(&proposition);
+  if (input == input_table_.end()) {
+    return root;
+  }
+  new_mark_();
+  marks_[input->second] = mark_;
+  results_[input->second] = value ? true_edge : false_edge;
+  auto result_of = [this](Edge edge) {
+    return results_[edge >> 1] ^ (edge & 1);
+  };
+
+  // post order on the cone: a conjunction is rebuilt once both of its
+  // fanins are
+  stack_.assign(1, root >> 1);
+  while (!stack_.empty()) {
+    auto index = stack_.back();
+    if (marks_[index] == mark_) {
+      stack_.pop_back();
+      continue;
+    }
+    // copied, since building a conjunction can grow the nodes
+    const auto node = nodes_[index];
+    if (index == 0 or node.left == input_marker_) {
+      marks_[index] = mark_;
+      results_[index] = index << 1;
+      stack_.pop_back();
+      continue;
+    }
+    bool is_ready = true;
+    for (auto fanin : {node.left, node.right}) {
+      if (marks_[fanin >> 1] != mark_) {
+        stack_.push_back(fanin >> 1);
+        is_ready = false;
+      }
+    }
+    if (!is_ready) {
+      continue;
+    }
+    stack_.pop_back();
+    results_[index] = make_and(result_of(node.left), result_of(node.right));
+    marks_[index] = mark_;
+  }
+  return result_of(root);
+}
+
+void Aig::rollback(size_t nb_nodes) {
+  nb_nodes = std::max<size_t>(nb_nodes, 1);
+  while (nodes_.size() > nb_nodes) {
+    const auto &node = nodes_.back();
+    if (node.left == input_marker_) {
+      input_table_.erase(propositions_.back().get());
+      propositions_.pop_back();
+    } else {
+      and_table_.erase(and_key_(node.left, node.right));
+    }
+    nodes_.pop_back();
+  }
+}
+
+namespace {
+
+class AigBuilder
+    : public PostOrderVisitor<AigBuilder, PLFormula, Aig::Edge> {
+public:
+  explicit AigBuilder(Aig &aig) : aig_{aig} {}
+
+  void expand(const PLFormula &f, size_t) {
+    for_each_argument(f, [this](const PLFormula &arg) { push(arg); });
+  }
+  Aig::Edge combine(const PLFormula &f, size_t, const Aig::Edge *args) {
+    switch (f.type_code()) {
+    case TypeID::t_PLTrue:
+      return Aig::true_edge;
+    case TypeID::t_PLFalse:
+      return Aig::false_edge;
+    case TypeID::t_PLLiteral: {
+      const auto &literal = static_cast<const PLLiteral &>(f);
+      auto input = aig_.make_input(literal.proposition);
+      return literal.negated ? Aig::negate(input) : input;
+    }
+    default:
+      break;
+    }
+    const auto &operands = static_cast<const PLBinaryOp &>(f).args;
+    bool is_or = f.type_code() == TypeID::t_PLOr;
+    auto result = is_or ? Aig::false_edge : Aig::true_edge;
+    for (size_t i = 0; i < operands.size(); ++i) {
+      result = is_or ? aig_.make_or(result, args[i])
+                     : aig_.make_and(result, args[i]);
+    }
+    return result;
+  }
+
+private:
+  Aig &aig_;
+};
+
+} // namespace
+
+Aig::Edge to_aig(Aig &aig, const PLFormula &formula) {
+  AigBuilder builder{aig};
+  return builder.apply(formula);
+}
+
+pl_ptr to_pl(Context &context, const Aig &aig, Aig::Edge root) {
+  std::unordered_map<Aig::Edge, pl_ptr> results;
+  std::vector<Aig::Edge> stack{root};
+  while (!stack.empty()) {
+    auto edge = stack.back();
+    if (results.find(edge) != results.end()) {
+      stack.pop_back();
+      continue;
+    }
+    if (Aig::is_constant(edge)) {
+      results.emplace(edge, edge == Aig::true_edge ? context.make_true()
+                                                   : context.make_false());
+      stack.pop_back();
+      continue;
+    }
+    bool negated = Aig::is_negated(edge);
+    if (aig.is_input(edge)) {
+      results.emplace(edge,
+                      context.make_literal(aig.proposition(edge), negated));
+      stack.pop_back();
+      continue;
+    }
+    // !(a & b) = !a | !b
+    auto left = negated ? Aig::negate(aig.left(edge)) : aig.left(edge);
+    auto right = negated ? Aig::negate(aig.right(edge)) : aig.right(edge);
+    auto left_result = results.find(left);
+    auto right_result = results.find(right);
+    if (left_result == results.end() or right_result == results.end()) {
+      stack.push_back(left);
+      stack.push_back(right);
+      continue;
+    }
+    vec_pl_ptr args{left_result->second, right_result->second};
+    results.emplace(edge, negated ? context.make_prop_or(args)
+                                  : context.make_prop_and(args));
+    stack.pop_back();
+  }
+  return results[root];
+}
+
+} // namespace logic
+} // namespace nike
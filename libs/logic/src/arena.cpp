@@ -0,0 +1,80 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/logic/arena.hpp>
+#include <new>
+
+namespace nike {
+namespace logic {
+
+NodeArena::~NodeArena() {
+  for (auto chunk : chunks_) {
+    ::operator delete(chunk);
+  }
+}
+
+void *NodeArena::allocate(size_t size) {
+  if (size > max_block_size) {
+    return ::operator new(size);
+  }
+  auto c = class_of_(size);
+  auto block_size = (c + 1) * granularity;
+  lock_acquire_();
+  void *result;
+  if (free_lists_[c] != nullptr) {
+    auto block = free_lists_[c];
+    free_lists_[c] = block->next;
+    result = block;
+  } else {
+    if (cursor_ + block_size > chunk_end_) {
+      char *chunk;
+      try {
+        chunks_.reserve(chunks_.size() + 1);
+        chunk = static_cast<char *>(::operator new(chunk_size));
+      } catch (...) {
+        lock_release_();
+        throw;
+      }
+      chunks_.push_back(chunk);
+      // the tail of the previous chunk is lost: it is at most one block
+      cursor_ = chunk;
+      chunk_end_ = chunk + chunk_size;
+    }
+    result = cursor_;
+    cursor_ += block_size;
+  }
+  ++nb_live_blocks_;
+  lock_release_();
+  return result;
+}
+
+void NodeArena::deallocate(void *p, size_t size) {
+  if (size > max_block_size) {
+    ::operator delete(p);
+    return;
+  }
+  auto block = static_cast<FreeBlock *>(p);
+  auto c = class_of_(size);
+  lock_acquire_();
+  block->next = free_lists_[c];
+  free_lists_[c] = block;
+  --nb_live_blocks_;
+  lock_release_();
+}
+
+} // namespace logic
+} // namespace nike
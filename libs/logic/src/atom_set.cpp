@@ -0,0 +1,84 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/logic/atom_set.hpp>
+
+namespace nike {
+namespace logic {
+
+namespace {
+AtomSet symbol_set(const AstNode &node) {
+  AtomSet result;
+  if (is_a<StringSymbol>(node)) {
+    auto index = static_cast<const StringSymbol &>(node).index();
+    if (index != AstNode::no_id) {
+      result.insert(index);
+    }
+  }
+  return result;
+}
+} // namespace
+
+void AtomSetVisitor::expand(const AstNode &f, size_t tag) {
+  auto push_argument = [this, tag](const AstNode &arg) { push(arg, tag); };
+  if (tag == pl) {
+    for_each_argument(static_cast<const PLFormula &>(f), push_argument);
+  } else {
+    for_each_argument(static_cast<const LTLfFormula &>(f), push_argument);
+  }
+}
+
+AtomSet AtomSetVisitor::combine(const AstNode &f, size_t tag,
+                                const AtomSet *args) {
+  switch (f.type_code()) {
+  case TypeID::t_LTLfAtom:
+    return symbol_set(*static_cast<const LTLfAtom &>(f).symbol);
+  case TypeID::t_PLLiteral:
+    return symbol_set(*static_cast<const PLLiteral &>(f).proposition);
+  default:
+    break;
+  }
+  AtomSet result;
+  auto add_argument = [&result, &args](const AstNode &) {
+    result |= *args++;
+  };
+  if (tag == pl) {
+    for_each_argument(static_cast<const PLFormula &>(f), add_argument);
+  } else {
+    for_each_argument(static_cast<const LTLfFormula &>(f), add_argument);
+  }
+  return result;
+}
+
+AtomSet AtomSetVisitor::apply(const LTLfFormula &formula) {
+  return PostOrderVisitor::apply(formula, ltlf);
+}
+AtomSet AtomSetVisitor::apply(const PLFormula &formula) {
+  return PostOrderVisitor::apply(formula, pl);
+}
+
+AtomSet find_atom_set(const LTLfFormula &f) {
+  AtomSetVisitor visitor;
+  return visitor.apply(f);
+}
+AtomSet find_atom_set(const PLFormula &f) {
+  AtomSetVisitor visitor;
+  return visitor.apply(f);
+}
+
+} // namespace logic
+} // namespace nike
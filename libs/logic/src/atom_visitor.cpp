@@ -21,67 +21,43 @@
 namespace nike {
 namespace logic {
 
-void AtomsVisitor::visit(const PLTrue &) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const PLFalse &) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const PLLiteral &f) {
-  result = set_ast_ptr{f.proposition};
-}
-void AtomsVisitor::visit(const PLAnd &f) {
-  set_ast_ptr atoms_result, tmp;
-  for (auto &a : f.args) {
-    tmp = apply(*a);
-    atoms_result.insert(tmp.begin(), tmp.end());
-  }
-  result = atoms_result;
-}
-void AtomsVisitor::visit(const PLOr &f) {
-  set_ast_ptr atoms_result, tmp;
-  for (auto &a : f.args) {
-    tmp = apply(*a);
-    atoms_result.insert(tmp.begin(), tmp.end());
+void AtomsVisitor::expand(const AstNode &f, size_t tag) {
+  auto push_argument = [this, tag](const AstNode &arg) { push(arg, tag); };
+  if (tag == pl) {
+    for_each_argument(static_cast<const PLFormula &>(f), push_argument);
+  } else {
+    for_each_argument(static_cast<const LTLfFormula &>(f), push_argument);
   }
-  result = atoms_result;
 }
 
-void AtomsVisitor::visit(const LTLfTrue &f) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const LTLfFalse &f) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const LTLfPropTrue &f) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const LTLfPropFalse &f) { result = set_ast_ptr{}; }
-void AtomsVisitor::visit(const LTLfAtom &f) { result = set_ast_ptr{f.symbol}; }
-void AtomsVisitor::visit(const LTLfNot &f) { visit_unary_op(f); }
-void AtomsVisitor::visit(const LTLfPropositionalNot &f) { visit_unary_op(f); }
-void AtomsVisitor::visit(const LTLfAnd &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfOr &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfImplies &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfEquivalent &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfXor &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfNext &f) { visit_unary_op(f); }
-void AtomsVisitor::visit(const LTLfWeakNext &f) { visit_unary_op(f); }
-void AtomsVisitor::visit(const LTLfUntil &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfRelease &f) { visit_binary_op(f); }
-void AtomsVisitor::visit(const LTLfEventually &f) { visit_unary_op(f); }
-void AtomsVisitor::visit(const LTLfAlways &f) { visit_unary_op(f); }
-
-void AtomsVisitor::visit_binary_op(const LTLfBinaryOp &f) {
-  set_ast_ptr atoms_result, tmp;
-  for (auto &a : f.args) {
-    tmp = apply(*a);
-    atoms_result.insert(tmp.begin(), tmp.end());
+set_ast_ptr AtomsVisitor::combine(const AstNode &f, size_t tag,
+                                  const set_ast_ptr *args) {
+  switch (f.type_code()) {
+  case TypeID::t_LTLfAtom:
+    return set_ast_ptr{static_cast<const LTLfAtom &>(f).symbol};
+  case TypeID::t_PLLiteral:
+    return set_ast_ptr{static_cast<const PLLiteral &>(f).proposition};
+  default:
+    break;
   }
-  result = atoms_result;
-}
-
-void AtomsVisitor::visit_unary_op(const LTLfUnaryOp &f) {
-  result = apply(*f.arg);
+  set_ast_ptr result;
+  auto add_argument = [&result, &args](const AstNode &) {
+    result.insert(args->begin(), args->end());
+    ++args;
+  };
+  if (tag == pl) {
+    for_each_argument(static_cast<const PLFormula &>(f), add_argument);
+  } else {
+    for_each_argument(static_cast<const LTLfFormula &>(f), add_argument);
+  }
+  return result;
 }
 
 set_ast_ptr AtomsVisitor::apply(const LTLfFormula &b) {
-  b.accept(*this);
-  return result;
+  return PostOrderVisitor::apply(b, ltlf);
 }
 set_ast_ptr AtomsVisitor::apply(const PLFormula &b) {
-  b.accept(*this);
-  return result;
+  return PostOrderVisitor::apply(b, pl);
 }
 
 set_ast_ptr find_atoms(const LTLfFormula &f) {
@@ -15,17 +15,44 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <nike/logic/base.hpp>
 #include <nike/logic/ltlf.hpp>
 #include <nike/logic/pl.hpp>
 #include <stdexcept>
 
-// TODO instead of make_shared, use "signature" of object to instantiate
-//        so to avoid heap allocation.
-
 namespace nike {
 namespace logic {
 
+namespace {
+
+// The signature of a node is its type and its direct children, compared
+// as in is_equal. Signature hashes must match compute_hash_ of the nodes.
+
+template <typename Container>
+hash_t nary_hash(TypeID type, const Container &args) {
+  hash_t result = type;
+  for (const auto &arg : args) {
+    hash_combine(result, arg->hash());
+  }
+  return result;
+}
+
+template <typename T, typename Container>
+auto nary_matches(const Container &args) {
+  return [&args](const AstNode &node) {
+    if (node.get_type_code() != T::type_code_id) {
+      return false;
+    }
+    const auto &other = static_cast<const T &>(node).args;
+    return other.size() == args.size() and
+           std::equal(args.begin(), args.end(), other.begin(),
+                      utils::EqualOrDeref());
+  };
+}
+
+} // namespace
+
 bool StringSymbol::is_equal(const Comparable &o) const {
   if (is_a<StringSymbol>(o))
     return name == dynamic_cast<const StringSymbol &>(o).name;
@@ -40,36 +67,190 @@ int StringSymbol::compare_(const Comparable &o) const {
 }
 
 Context::Context() {
+  arena_ = std::make_shared<NodeArena>();
   table_ = utils::make_unique<HashTable>();
 
-  tt = std::make_shared<const LTLfTrue>(*this);
+  tt = make_node<LTLfTrue>();
   table_->insert_if_not_available(tt);
 
-  ff = std::make_shared<const LTLfFalse>(*this);
+  ff = make_node<LTLfFalse>();
   table_->insert_if_not_available(ff);
 
-  prop_true = std::make_shared<const LTLfPropTrue>(*this);
+  prop_true = make_node<LTLfPropTrue>();
   table_->insert_if_not_available(prop_true);
 
-  prop_false = std::make_shared<const LTLfPropFalse>(*this);
+  prop_false = make_node<LTLfPropFalse>();
   table_->insert_if_not_available(prop_false);
 
-  end = std::make_shared<const LTLfAlways>(*this, ff);
+  end = make_node<LTLfAlways>(ff);
   table_->insert_if_not_available(end);
 
-  not_end = std::make_shared<const LTLfEventually>(*this, tt);
+  not_end = make_node<LTLfEventually>(tt);
   table_->insert_if_not_available(not_end);
 
-  last = std::make_shared<const LTLfWeakNext>(*this, ff);
+  last = make_node<LTLfWeakNext>(ff);
   table_->insert_if_not_available(last);
 
-  true_ = std::make_shared<const PLTrue>(*this);
+  true_ = make_node<PLTrue>();
   table_->insert_if_not_available(true_);
 
-  false_ = std::make_shared<const PLFalse>(*this);
+  false_ = make_node<PLFalse>();
   table_->insert_if_not_available(false_);
 }
 
+HashTable::~HashTable() {
+  std::vector<ast_ptr *> nodes;
+  nodes.reserve(m_table_.size());
+  for (auto &entry : m_table_) {
+    nodes.push_back(&entry.second);
+  }
+  std::sort(nodes.begin(), nodes.end(), [](const auto *a, const auto *b) {
+    return (*a)->id() > (*b)->id();
+  });
+  for (auto *node : nodes) {
+    // the node might be kept alive by someone else
+    (*node)->owner_ = nullptr;
+    node->reset();
+  }
+}
+
+namespace {
+// call the function on the nodes the node holds a reference to
+template <typename Function>
+void for_each_child(const AstNode &node, Function &&function) {
+  if (const auto *atom = dynamic_cast<const LTLfAtom *>(&node)) {
+    function(*atom->symbol);
+  } else if (const auto *unary = dynamic_cast<const LTLfUnaryOp *>(&node)) {
+    function(*unary->arg);
+  } else if (const auto *binary = dynamic_cast<const LTLfBinaryOp *>(&node)) {
+    for (const auto &arg : binary->args) {
+      function(*arg);
+    }
+  } else if (const auto *literal = dynamic_cast<const PLLiteral *>(&node)) {
+    function(*literal->proposition);
+  } else if (const auto *pl_binary = dynamic_cast<const PLBinaryOp *>(&node)) {
+    for (const auto &arg : pl_binary->args) {
+      function(*arg);
+    }
+  }
+}
+} // namespace
+
+size_t HashTable::sweep() {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  using iterator = decltype(m_table_)::iterator;
+  std::vector<iterator> garbage;
+  for (auto it = m_table_.begin(); it != m_table_.end(); ++it) {
+    if (it->second.use_count() == 1) {
+      garbage.push_back(it);
+    }
+  }
+  size_t nb_removed = 0;
+  std::vector<const AstNode *> children;
+  while (!garbage.empty()) {
+    auto entry = garbage.back();
+    garbage.pop_back();
+    children.clear();
+    for_each_child(*entry->second, [&children](const AstNode &child) {
+      children.push_back(&child);
+    });
+    // the children are interned: they outlive their parent
+    m_table_.erase(entry);
+    ++nb_removed;
+    for (const auto *child : children) {
+      if (child->owner_ == nullptr || child->owner_->use_count() != 1) {
+        continue;
+      }
+      auto range = m_table_.equal_range(child->hash());
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.get() == child) {
+          garbage.push_back(it);
+          break;
+        }
+      }
+    }
+  }
+  return nb_removed;
+}
+
+template <typename T, typename Predicate, typename... Args>
+std::shared_ptr<const T> Context::intern_(hash_t hash, Predicate matches,
+                                          Args &&...args) {
+  auto found = table_->find<T>(hash, matches);
+  if (found) {
+    return found;
+  }
+  auto node = make_node<T>(std::forward<Args>(args)...);
+  assert(node->hash() == hash);
+  // another thread might have interned the same node in the meantime
+  return table_->insert_if_not_available(node);
+}
+
+template <typename T> ltlf_ptr Context::make_unary_(const ltlf_ptr &arg) {
+  hash_t hash = T::type_code_id;
+  hash_combine(hash, arg->hash());
+  auto matches = [&arg](const AstNode &node) {
+    if (node.get_type_code() != T::type_code_id) {
+      return false;
+    }
+    const auto &other = static_cast<const LTLfUnaryOp &>(node).arg;
+    return other == arg or *other == *arg;
+  };
+  return intern_<T>(hash, matches, arg);
+}
+
+template <typename T, typename Container>
+std::shared_ptr<const T> Context::make_nary_node(const Container &args) {
+  return intern_<T>(nary_hash(T::type_code_id, args),
+                    nary_matches<T>(args), args);
+}
+
+template std::shared_ptr<const LTLfAnd>
+Context::make_nary_node<LTLfAnd>(const set_ptr &args);
+template std::shared_ptr<const LTLfOr>
+Context::make_nary_node<LTLfOr>(const set_ptr &args);
+template std::shared_ptr<const PLAnd>
+Context::make_nary_node<PLAnd>(const set_pl_ptr &args);
+template std::shared_ptr<const PLOr>
+Context::make_nary_node<PLOr>(const set_pl_ptr &args);
+
+void Context::set_thread_safe(bool value) {
+  table_->set_synchronized(value);
+  arena_->set_synchronized(value);
+  for (auto &memo_table : memo_tables_) {
+    memo_table.set_synchronized(value);
+  }
+}
+bool Context::is_thread_safe() const { return table_->is_synchronized(); }
+void Context::set_simplification(bool value) {
+  if (value != simplifying_) {
+    for (auto &memo_table : memo_tables_) {
+      memo_table.clear();
+    }
+  }
+  simplifying_ = value;
+}
+bool Context::is_simplifying() const { return simplifying_; }
+SimplificationStats &Context::simplification_stats() {
+  return simplification_stats_;
+}
+MemoTable &Context::memo_table(Transformation transformation) {
+  return memo_tables_[static_cast<size_t>(transformation)];
+}
+uint32_t Context::nb_ids() const { return table_->nb_ids(); }
+size_t Context::nb_nodes() const { return table_->size(); }
+uint32_t Context::nb_symbols() const { return table_->nb_symbols(); }
+ast_ptr Context::symbol(uint32_t index) const {
+  return table_->symbol(index);
+}
+size_t Context::collect_garbage() { return table_->sweep(); }
+size_t Context::nb_hash_collisions() const {
+  return table_->nb_collisions();
+}
+
 ltlf_ptr Context::make_tt() { return tt; }
 ltlf_ptr Context::make_ff() { return ff; }
 ltlf_ptr Context::make_prop_true() { return prop_true; }
@@ -85,15 +266,19 @@ pl_ptr Context::make_prop_bool(bool value) {
 }
 
 ltlf_ptr Context::make_atom(const std::string &name) {
-  auto atom = std::make_shared<const LTLfAtom>(*this, name);
-  auto actual_atom = table_->insert_if_not_available(atom);
-  return actual_atom;
+  return make_atom(make_string_symbol(name));
 }
 
 ltlf_ptr Context::make_atom(const ast_ptr &symbol) {
-  auto atom = std::make_shared<const LTLfAtom>(*this, symbol);
-  auto actual_atom = table_->insert_if_not_available(atom);
-  return actual_atom;
+  hash_t hash = LTLfAtom::type_code_id;
+  hash_combine(hash, symbol->hash());
+  return intern_<LTLfAtom>(
+      hash,
+      [&symbol](const AstNode &node) {
+        return is_a<LTLfAtom>(node) and
+               static_cast<const LTLfAtom &>(node).symbol == symbol;
+      },
+      symbol);
 }
 
 ltlf_ptr Context::make_not_unified(const ltlf_ptr &arg) {
@@ -105,9 +290,7 @@ ltlf_ptr Context::make_not_unified(const ltlf_ptr &arg) {
   return make_not(arg);
 }
 ltlf_ptr Context::make_not(const ltlf_ptr &arg) {
-  auto negation = std::make_shared<const LTLfNot>(*this, arg);
-  auto actual = table_->insert_if_not_available(negation);
-  return actual;
+  return make_unary_<LTLfNot>(arg);
 }
 
 ltlf_ptr Context::make_prop_not(const ltlf_ptr &arg) {
@@ -120,9 +303,7 @@ ltlf_ptr Context::make_prop_not(const ltlf_ptr &arg) {
   if (!is_a<LTLfAtom>(*arg)) {
     throw std::invalid_argument("argument must be an atom");
   }
-  auto negation = std::make_shared<const LTLfPropositionalNot>(*this, arg);
-  auto actual = table_->insert_if_not_available(negation);
-  return actual;
+  return make_unary_<LTLfPropositionalNot>(arg);
 }
 
 ltlf_ptr Context::make_and(const vec_ptr &args) {
@@ -130,7 +311,7 @@ ltlf_ptr Context::make_and(const vec_ptr &args) {
   auto tmp = ltlf_and_or<const LTLfFormula, LTLfAnd, LTLfTrue, LTLfFalse>(
       *this, args, false, fun);
   auto actual = table_->insert_if_not_available(tmp);
-  return actual;
+  return simplifying_ ? rewrite(*actual) : actual;
 }
 
 ltlf_ptr Context::make_or(const vec_ptr &args) {
@@ -138,75 +319,79 @@ ltlf_ptr Context::make_or(const vec_ptr &args) {
   auto tmp = ltlf_and_or<const LTLfFormula, LTLfOr, LTLfTrue, LTLfFalse>(
       *this, args, true, fun);
   auto actual = table_->insert_if_not_available(tmp);
-  return actual;
+  return simplifying_ ? rewrite(*actual) : actual;
 }
 
 ltlf_ptr Context::make_implies(const vec_ptr &args) {
-  auto implies = std::make_shared<const LTLfImplies>(*this, args);
-  auto actual = table_->insert_if_not_available(implies);
-  return actual;
+  return make_nary_node<LTLfImplies>(args);
 }
 
 ltlf_ptr Context::make_equivalent(const vec_ptr &args) {
-  auto equivalent = std::make_shared<const LTLfEquivalent>(*this, args);
-  auto actual = table_->insert_if_not_available(equivalent);
-  return actual;
+  // the node sorts its arguments
+  return make_nary_node<LTLfEquivalent>(utils::sort(args));
 }
 
 ltlf_ptr Context::make_xor(const vec_ptr &args) {
-  auto equivalent = std::make_shared<const LTLfXor>(*this, args);
-  auto actual = table_->insert_if_not_available(equivalent);
-  return actual;
+  // the node sorts its arguments
+  return make_nary_node<LTLfXor>(utils::sort(args));
 }
 
 ltlf_ptr Context::make_next(const ltlf_ptr &arg) {
-  auto next = std::make_shared<const LTLfNext>(*this, arg);
-  auto actual = table_->insert_if_not_available(next);
-  return actual;
+  auto result = make_unary_<LTLfNext>(arg);
+  return simplifying_ ? rewrite(*result) : result;
 }
 
 ltlf_ptr Context::make_weak_next(const ltlf_ptr &arg) {
-  auto next = std::make_shared<const LTLfWeakNext>(*this, arg);
-  auto actual = table_->insert_if_not_available(next);
-  return actual;
+  auto result = make_unary_<LTLfWeakNext>(arg);
+  return simplifying_ ? rewrite(*result) : result;
 }
 
 ltlf_ptr Context::make_until(const vec_ptr &args) {
-  auto until = std::make_shared<const LTLfUntil>(*this, args);
-  auto actual = table_->insert_if_not_available(until);
-  return actual;
+  return make_nary_node<LTLfUntil>(args);
 }
 
 ltlf_ptr Context::make_release(const vec_ptr &args) {
-  auto release = std::make_shared<const LTLfRelease>(*this, args);
-  auto actual = table_->insert_if_not_available(release);
-  return actual;
+  return make_nary_node<LTLfRelease>(args);
 }
 
 ltlf_ptr Context::make_eventually(const ltlf_ptr &arg) {
-  auto eventually = std::make_shared<const LTLfEventually>(*this, arg);
-  auto actual = table_->insert_if_not_available(eventually);
-  return actual;
+  auto result = make_unary_<LTLfEventually>(arg);
+  return simplifying_ ? rewrite(*result) : result;
 }
 
 ltlf_ptr Context::make_always(const ltlf_ptr &arg) {
-  auto always = std::make_shared<const LTLfAlways>(*this, arg);
-  auto actual = table_->insert_if_not_available(always);
-  return actual;
+  auto result = make_unary_<LTLfAlways>(arg);
+  return simplifying_ ? rewrite(*result) : result;
 }
 
 ast_ptr Context::make_string_symbol(const std::string &arg) {
-  auto stringSymbol = std::make_shared<const StringSymbol>(*this, arg);
-  auto actual = table_->insert_if_not_available(stringSymbol);
-  return actual;
+  hash_t hash = StringSymbol::type_code_id;
+  hash_combine(hash, arg);
+  return intern_<StringSymbol>(
+      hash,
+      [&arg](const AstNode &node) {
+        return is_a<StringSymbol>(node) and
+               static_cast<const StringSymbol &>(node).name == arg;
+      },
+      arg);
 }
 
 pl_ptr Context::make_true() { return true_; }
 pl_ptr Context::make_false() { return false_; }
 pl_ptr Context::make_literal(const ast_ptr &symbol, bool negated) {
-  auto literal = std::make_shared<const PLLiteral>(*this, symbol, negated);
-  auto actual = table_->insert_if_not_available(literal);
-  return literal;
+  hash_t hash = PLLiteral::type_code_id;
+  hash_combine(hash, negated);
+  hash_combine(hash, symbol->hash());
+  return intern_<PLLiteral>(
+      hash,
+      [&symbol, negated](const AstNode &node) {
+        if (!is_a<PLLiteral>(node)) {
+          return false;
+        }
+        const auto &literal = static_cast<const PLLiteral &>(node);
+        return literal.negated == negated and literal.proposition == symbol;
+      },
+      symbol, negated);
 }
 pl_ptr Context::make_prop_and(const vec_pl_ptr &args) {
   pl_ptr (Context::*fun)(bool) = &Context::make_prop_bool;
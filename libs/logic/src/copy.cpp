@@ -15,90 +15,85 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <functional>
 #include <nike/logic/copy.hpp>
 #include <nike/logic/ltlf.hpp>
+#include <nike/logic/type_switch.hpp>
 
 namespace nike {
 namespace logic {
 
-void CopyVisitor::visit(const LTLfTrue &f) { result = context.make_tt(); }
-void CopyVisitor::visit(const LTLfFalse &f) { result = context.make_ff(); }
-void CopyVisitor::visit(const LTLfPropTrue &f) {
-  result = context.make_prop_true();
+void CopyVisitor::expand(const LTLfFormula &f, size_t) {
+  for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
 }
-void CopyVisitor::visit(const LTLfPropFalse &f) {
-  result = context.make_prop_false();
+
+ltlf_ptr CopyVisitor::combine(const LTLfFormula &f, size_t,
+                              const ltlf_ptr *args) {
+  return dispatch(
+      f, [this, args](const auto &formula) { return combine_(formula, args); });
 }
-void CopyVisitor::visit(const LTLfAtom &f) {
-  auto symbol_name =
-      std::static_pointer_cast<const StringSymbol>(f.symbol)->name;
-  result = context.make_atom(symbol_name);
+
+ltlf_ptr CopyVisitor::combine_(const LTLfTrue &, const ltlf_ptr *) {
+  return context.make_tt();
 }
-void CopyVisitor::visit(const LTLfNot &f) {
-  visit_unary_op(&Context::make_not, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfFalse &, const ltlf_ptr *) {
+  return context.make_ff();
 }
-void CopyVisitor::visit(const LTLfPropositionalNot &f) {
-  visit_unary_op(&Context::make_prop_not, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfPropTrue &, const ltlf_ptr *) {
+  return context.make_prop_true();
 }
-void CopyVisitor::visit(const LTLfAnd &f) {
-  visit_binary_op(&Context::make_and, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfPropFalse &, const ltlf_ptr *) {
+  return context.make_prop_false();
 }
-void CopyVisitor::visit(const LTLfOr &f) {
-  visit_binary_op(&Context::make_or, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfAtom &f, const ltlf_ptr *) {
+  auto symbol_name =
+      std::static_pointer_cast<const StringSymbol>(f.symbol)->name;
+  return context.make_atom(symbol_name);
 }
-void CopyVisitor::visit(const LTLfImplies &f) {
-  visit_binary_op(&Context::make_implies, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfNot &, const ltlf_ptr *args) {
+  return context.make_not(args[0]);
 }
-void CopyVisitor::visit(const LTLfEquivalent &f) {
-  visit_binary_op(&Context::make_equivalent, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfPropositionalNot &,
+                               const ltlf_ptr *args) {
+  return context.make_prop_not(args[0]);
 }
-void CopyVisitor::visit(const LTLfXor &f) {
-  visit_binary_op(&Context::make_xor, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfAnd &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_and, f, args);
 }
-void CopyVisitor::visit(const LTLfNext &f) {
-  visit_unary_op(&Context::make_next, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfOr &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_or, f, args);
 }
-void CopyVisitor::visit(const LTLfWeakNext &f) {
-  visit_unary_op(&Context::make_weak_next, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfImplies &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_implies, f, args);
 }
-void CopyVisitor::visit(const LTLfUntil &f) {
-  visit_binary_op(&Context::make_until, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfEquivalent &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_equivalent, f, args);
 }
-void CopyVisitor::visit(const LTLfRelease &f) {
-  visit_binary_op(&Context::make_release, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfXor &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_xor, f, args);
 }
-void CopyVisitor::visit(const LTLfEventually &f) {
-  visit_unary_op(&Context::make_eventually, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfNext &, const ltlf_ptr *args) {
+  return context.make_next(args[0]);
 }
-void CopyVisitor::visit(const LTLfAlways &f) {
-  visit_unary_op(&Context::make_always, f);
+ltlf_ptr CopyVisitor::combine_(const LTLfWeakNext &, const ltlf_ptr *args) {
+  return context.make_weak_next(args[0]);
 }
-
-void CopyVisitor::visit_binary_op(ltlf_ptr (Context::*fun)(const vec_ptr &v),
-                                  const LTLfBinaryOp &f) {
-  std::vector<ltlf_ptr> new_args;
-  auto bind_function = std::bind(fun, &context, std::placeholders::_1);
-  for (auto &a : f.args) {
-    new_args.push_back(apply(*a));
-  }
-  result = bind_function(new_args);
+ltlf_ptr CopyVisitor::combine_(const LTLfUntil &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_until, f, args);
 }
-
-void CopyVisitor::visit_unary_op(ltlf_ptr (Context::*fun)(const ltlf_ptr &),
-                                 const LTLfUnaryOp &f) {
-  ltlf_ptr arg = apply(*f.arg);
-  auto bind_function = std::bind(fun, &context, std::placeholders::_1);
-  result = bind_function(arg);
+ltlf_ptr CopyVisitor::combine_(const LTLfRelease &f, const ltlf_ptr *args) {
+  return combine_binary_op_(&Context::make_release, f, args);
 }
-
-ltlf_ptr CopyVisitor::apply(const LTLfFormula &b) {
-  b.accept(*this);
-  return result;
+ltlf_ptr CopyVisitor::combine_(const LTLfEventually &, const ltlf_ptr *args) {
+  return context.make_eventually(args[0]);
 }
-ltlf_ptr CopyVisitor::apply(const PLFormula &b) {
-  b.accept(*this);
-  return result;
+ltlf_ptr CopyVisitor::combine_(const LTLfAlways &, const ltlf_ptr *args) {
+  return context.make_always(args[0]);
+}
+
+ltlf_ptr
+CopyVisitor::combine_binary_op_(ltlf_ptr (Context::*fun)(const vec_ptr &),
+                                const LTLfBinaryOp &f, const ltlf_ptr *args) {
+  return (context.*fun)(vec_ptr(args, args + f.args.size()));
 }
 
 ltlf_ptr copy_ltlf_formula(Context &context, const LTLfFormula &f) {
@@ -113,4 +108,4 @@ ltlf_ptr copy_ltlf_formula(const LTLfFormula &f) {
 }
 
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
@@ -0,0 +1,111 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/logic/flat.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/traversal.hpp>
+
+namespace nike {
+namespace logic {
+
+namespace {
+uint32_t symbol_index(const LTLfFormula &formula) {
+  const auto *atom = &formula;
+  if (is_a<LTLfPropositionalNot>(formula)) {
+    atom = static_cast<const LTLfPropositionalNot &>(formula).arg.get();
+  }
+  if (!is_a<LTLfAtom>(*atom)) {
+    return FlatFormula::no_symbol;
+  }
+  const auto &symbol = *static_cast<const LTLfAtom &>(*atom).symbol;
+  if (!is_a<StringSymbol>(symbol)) {
+    return FlatFormula::no_symbol;
+  }
+  return static_cast<const StringSymbol &>(symbol).index();
+}
+
+// the unfolded size of a DAG can exceed the range of size_t: saturate
+size_t saturating_add(size_t a, size_t b) {
+  return a > SIZE_MAX - b ? SIZE_MAX : a + b;
+}
+} // namespace
+
+/*
+ * Appends the record of a formula once the records of its arguments are
+ * appended: the result of a formula is the index of its record, cached
+ * by the traversal, so a shared subformula is laid out once.
+ */
+class FlatFormulaBuilder
+    : public PostOrderVisitor<FlatFormulaBuilder, LTLfFormula, uint32_t> {
+public:
+  explicit FlatFormulaBuilder(FlatFormula &result) : result_{result} {}
+
+  void expand(const LTLfFormula &f, size_t) {
+    for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
+  }
+  uint32_t combine(const LTLfFormula &f, size_t, const uint32_t *args) {
+    auto &nodes = result_.nodes_;
+    auto &all_args = result_.args_;
+    FlatFormula::Node node{f.type_code(), 0,
+                           static_cast<uint32_t>(all_args.size()),
+                           symbol_index(f)};
+    for_each_argument(f, [&node, &all_args, &args](const LTLfFormula &) {
+      all_args.push_back(*args++);
+      ++node.nb_args;
+    });
+    nodes.push_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+  }
+
+private:
+  FlatFormula &result_;
+};
+
+FlatFormula::FlatFormula(const LTLfFormula &formula) {
+  FlatFormulaBuilder builder{*this};
+  builder.apply(formula);
+}
+
+size_t size(const FlatFormula &formula) {
+  const auto &nodes = formula.nodes();
+  std::vector<size_t> sizes(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto &node = nodes[i];
+    switch (node.type) {
+    case TypeID::t_LTLfNot:
+    case TypeID::t_LTLfImplies:
+    case TypeID::t_LTLfEquivalent:
+    case TypeID::t_LTLfXor:
+      throw_expected_nnf();
+    case TypeID::t_LTLfPropNot:
+      // a literal counts as one
+      sizes[i] = 1;
+      break;
+    default:
+      size_t total = 1;
+      const auto *args = formula.args(node);
+      for (uint32_t j = 0; j < node.nb_args; ++j) {
+        total = saturating_add(total, sizes[args[j]]);
+      }
+      sizes[i] = total;
+    }
+  }
+  return sizes.empty() ? 0 : sizes.back();
+}
+
+} // namespace logic
+} // namespace nike
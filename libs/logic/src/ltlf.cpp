@@ -111,8 +111,7 @@ ltlf_ptr simplify(const LTLfNot &formula) {
   if (is_a<LTLfPropTrue>(*formula.arg)) {
     return formula.ctx().make_end();
   }
-  return std::static_pointer_cast<const LTLfFormula>(
-      formula.shared_from_this());
+  return shared_from(formula);
 }
 ltlf_ptr simplify(const LTLfImplies &formula) {
   auto new_container = vec_ptr(formula.args.size());
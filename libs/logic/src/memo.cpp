@@ -0,0 +1,130 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/memo.hpp>
+
+namespace nike {
+namespace logic {
+
+std::string transformation_to_string(Transformation transformation) {
+  switch (transformation) {
+  case Transformation::nnf:
+    return "nnf";
+  case Transformation::xnf:
+    return "xnf";
+  case Transformation::strip_next:
+    return "strip_next";
+  }
+  return "unknown";
+}
+
+MemoTable::Entry *MemoTable::slot_(uint32_t id, size_t tag) {
+  // the ids are dense: consecutive formulas go to consecutive slots
+  return &entries_[(size_t(id) * 2 + tag) & (entries_.size() - 1)];
+}
+
+bool MemoTable::find(const LTLfFormula &formula, size_t tag,
+                     ltlf_ptr &result) {
+  if (capacity_ == 0 or !formula.has_id()) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  if (!entries_.empty()) {
+    auto *entry = slot_(formula.id(), tag);
+    if (entry->id == formula.id() and entry->tag == tag) {
+      result = entry->result;
+      nb_hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  nb_misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void MemoTable::insert(const LTLfFormula &formula, size_t tag,
+                       const ltlf_ptr &result) {
+  if (capacity_ == 0 or !formula.has_id()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  if (entries_.empty()) {
+    entries_.resize(capacity_, Entry{AstNode::no_id, 0, nullptr});
+  }
+  auto *entry = slot_(formula.id(), tag);
+  if (entry->id == AstNode::no_id) {
+    ++size_;
+  }
+  entry->id = formula.id();
+  entry->tag = static_cast<uint32_t>(tag);
+  entry->result = result;
+}
+
+void MemoTable::set_capacity(size_t capacity) {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  capacity_ = 0;
+  if (capacity > 0) {
+    capacity_ = 1;
+    while (capacity_ < capacity) {
+      capacity_ *= 2;
+    }
+  }
+  // allocated again on the next insertion
+  entries_ = std::vector<Entry>();
+  size_ = 0;
+}
+
+size_t MemoTable::size() const {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  return size_;
+}
+
+void MemoTable::clear() {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (synchronized_) {
+    lock.lock();
+  }
+  for (auto &entry : entries_) {
+    entry = Entry{AstNode::no_id, 0, nullptr};
+  }
+  size_ = 0;
+}
+
+double MemoTable::hit_rate() const {
+  auto nb_lookups = nb_hits() + nb_misses();
+  return nb_lookups == 0 ? 0.0 : double(nb_hits()) / double(nb_lookups);
+}
+
+void MemoTable::reset_counts() {
+  nb_hits_.store(0, std::memory_order_relaxed);
+  nb_misses_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace logic
+} // namespace nike
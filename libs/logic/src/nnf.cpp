@@ -15,119 +15,140 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <nike/logic/duality.hpp>
 #include <nike/logic/ltlf.hpp>
 #include <nike/logic/nnf.hpp>
+#include <nike/logic/type_switch.hpp>
 
 namespace nike {
 namespace logic {
 
-void NNFTransformer::visit(const LTLfTrue &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
+namespace {
+ltlf_ptr self(const LTLfFormula &formula) {
+  return shared_from(formula);
 }
+vec_ptr arguments(const LTLfBinaryOp &formula, const ltlf_ptr *args) {
+  return vec_ptr(args, args + formula.args.size());
+}
+} // namespace
 
-void NNFTransformer::visit(const LTLfFalse &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
-}
+void NNFTransformer::expand(const LTLfFormula &f, size_t tag) {
+  dispatch(f, [this, tag](const auto &formula) { expand_(formula, tag); });
+}
 
-void NNFTransformer::visit(const LTLfPropTrue &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
+ltlf_ptr NNFTransformer::combine(const LTLfFormula &f, size_t tag,
+                                 const ltlf_ptr *args) {
+  return dispatch(f, [this, tag, args](const auto &formula) {
+    return combine_(formula, tag == negated, args);
+  });
+}
+
+void NNFTransformer::expand_(const LTLfFormula &, size_t) {}
+void NNFTransformer::expand_(const LTLfPropositionalNot &, size_t) {}
+void NNFTransformer::expand_(const LTLfNot &f, size_t tag) {
+  push(*f.arg, tag == negated ? positive : negated);
 }
-
-void NNFTransformer::visit(const LTLfPropFalse &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
+void NNFTransformer::expand_(const LTLfUnaryOp &f, size_t tag) {
+  push(*f.arg, tag);
 }
-
-void NNFTransformer::visit(const LTLfAtom &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
+void NNFTransformer::expand_(const LTLfBinaryOp &f, size_t tag) {
+  for (const auto &arg : f.args) {
+    push(*arg, tag);
+  }
 }
-
-void NNFTransformer::visit(const LTLfNot &formula) {
-  result = apply_negation(*formula.arg);
+void NNFTransformer::expand_(const LTLfImplies &f, size_t tag) {
+  push(*simplify(f), tag);
 }
-
-void NNFTransformer::visit(const LTLfPropositionalNot &formula) {
-  result =
-      std::static_pointer_cast<const LTLfFormula>(formula.shared_from_this());
+void NNFTransformer::expand_(const LTLfEquivalent &f, size_t tag) {
+  push(*simplify(f), tag);
 }
-
-void NNFTransformer::visit(const LTLfAnd &formula) {
-  result = forward_call_to_arguments(
-      formula, [this](const ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const vec_ptr &container) {
-        return formula.ctx().make_and(container);
-      });
+void NNFTransformer::expand_(const LTLfXor &f, size_t tag) {
+  push(*simplify(f), tag);
 }
 
-void NNFTransformer::visit(const LTLfOr &formula) {
-  result = forward_call_to_arguments(
-      formula, [this](const ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const vec_ptr &container) {
-        return formula.ctx().make_or(container);
-      });
+ltlf_ptr NNFTransformer::combine_(const LTLfTrue &f, bool negate,
+                                  const ltlf_ptr *) {
+  return negate ? f.ctx().make_ff() : self(f);
 }
-
-void NNFTransformer::visit(const LTLfImplies &formula) {
-  auto simplified_formula = simplify(formula);
-  result = apply(*simplified_formula);
+ltlf_ptr NNFTransformer::combine_(const LTLfFalse &f, bool negate,
+                                  const ltlf_ptr *) {
+  return negate ? f.ctx().make_tt() : self(f);
 }
-
-void NNFTransformer::visit(const LTLfEquivalent &formula) {
-  auto simplified_formula = simplify(formula);
-  result = apply(*simplified_formula);
+ltlf_ptr NNFTransformer::combine_(const LTLfPropTrue &f, bool negate,
+                                  const ltlf_ptr *) {
+  //  nnf(~true) = end
+  return negate ? f.ctx().make_end() : self(f);
 }
-
-void NNFTransformer::visit(const LTLfXor &formula) {
-  auto simplified_formula = simplify(formula);
-  result = apply(*simplified_formula);
+ltlf_ptr NNFTransformer::combine_(const LTLfPropFalse &f, bool negate,
+                                  const ltlf_ptr *) {
+  //  nnf(~false) = tt
+  return negate ? f.ctx().make_tt() : self(f);
 }
-
-void NNFTransformer::visit(const LTLfNext &formula) {
-  result = formula.ctx().make_next(apply(*formula.arg));
+ltlf_ptr NNFTransformer::combine_(const LTLfAtom &f, bool negate,
+                                  const ltlf_ptr *) {
+  if (!negate) {
+    return self(f);
+  }
+  //  nnf(~a) = !a | end
+  auto &context = f.ctx();
+  auto prop_not_atom = context.make_prop_not(self(f));
+  return context.make_or(vec_ptr{prop_not_atom, context.make_end()});
 }
-
-void NNFTransformer::visit(const LTLfWeakNext &formula) {
-  result = formula.ctx().make_weak_next(apply(*formula.arg));
+ltlf_ptr NNFTransformer::combine_(const LTLfPropositionalNot &f, bool negate,
+                                  const ltlf_ptr *) {
+  if (!negate) {
+    return self(f);
+  }
+  //  nnf(~!a) = a | end
+  auto &context = f.ctx();
+  return context.make_or(vec_ptr{f.arg, context.make_end()});
 }
-
-void NNFTransformer::visit(const LTLfUntil &formula) {
-  result = forward_call_to_arguments(
-      formula, [this](const ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const vec_ptr &container) {
-        return formula.ctx().make_until(container);
-      });
+ltlf_ptr NNFTransformer::combine_(const LTLfAnd &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_or(arguments(f, args))
+                : f.ctx().make_and(arguments(f, args));
 }
-
-void NNFTransformer::visit(const LTLfRelease &formula) {
-  result = forward_call_to_arguments(
-      formula, [this](const ltlf_ptr &formula) { return apply(*formula); },
-      [formula](const vec_ptr &container) {
-        return formula.ctx().make_release(container);
-      });
+ltlf_ptr NNFTransformer::combine_(const LTLfOr &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_and(arguments(f, args))
+                : f.ctx().make_or(arguments(f, args));
 }
-
-void NNFTransformer::visit(const LTLfEventually &formula) {
-  result = formula.ctx().make_eventually(apply(*formula.arg));
+ltlf_ptr NNFTransformer::combine_(const LTLfNext &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_weak_next(args[0]) : f.ctx().make_next(args[0]);
 }
-
-void NNFTransformer::visit(const LTLfAlways &formula) {
-  result = formula.ctx().make_always(apply(*formula.arg));
+ltlf_ptr NNFTransformer::combine_(const LTLfWeakNext &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_next(args[0]) : f.ctx().make_weak_next(args[0]);
 }
-
-ltlf_ptr NNFTransformer::apply(const LTLfFormula &f) {
-  f.accept(*this);
-  return result;
+ltlf_ptr NNFTransformer::combine_(const LTLfUntil &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_release(arguments(f, args))
+                : f.ctx().make_until(arguments(f, args));
+}
+ltlf_ptr NNFTransformer::combine_(const LTLfRelease &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_until(arguments(f, args))
+                : f.ctx().make_release(arguments(f, args));
+}
+ltlf_ptr NNFTransformer::combine_(const LTLfEventually &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_always(args[0])
+                : f.ctx().make_eventually(args[0]);
+}
+ltlf_ptr NNFTransformer::combine_(const LTLfAlways &f, bool negate,
+                                  const ltlf_ptr *args) {
+  return negate ? f.ctx().make_eventually(args[0])
+                : f.ctx().make_always(args[0]);
+}
+ltlf_ptr NNFTransformer::combine_(const LTLfFormula &, bool,
+                                  const ltlf_ptr *args) {
+  return args[0];
 }
 
 ltlf_ptr to_nnf(const LTLfFormula &f) {
-  auto visitor = NNFTransformer{};
+  auto visitor = NNFTransformer{&f.ctx().memo_table(Transformation::nnf)};
   return visitor.apply(f);
 }
 
 } // namespace logic
-} // namespace nike
\ No newline at end of file
+} // namespace nike
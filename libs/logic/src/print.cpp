@@ -15,8 +15,14 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <nike/logic/ltlf.hpp>
 #include <nike/logic/print.hpp>
+#include <nike/logic/type_switch.hpp>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace nike {
 namespace logic {
@@ -73,10 +79,7 @@ void PrintVisitor::visit(const LTLfAlways &formula) {
   unary_op_to_string(formula, "G");
 }
 
-std::string PrintVisitor::apply(const LTLfFormula &f) {
-  f.accept(*this);
-  return result;
-}
+std::string PrintVisitor::apply(const LTLfFormula &f) { return apply_(f); }
 
 void PrintVisitor::binary_op_to_string(const LTLfBinaryOp &formula,
                                        const std::string &op_symbol) {
@@ -97,9 +100,232 @@ void PrintVisitor::unary_op_to_string(const LTLfUnaryOp &formula,
   result = ss.str();
 }
 
+namespace {
+
+class StreamSink {
+public:
+  explicit StreamSink(std::ostream &out) : out_{out} {}
+  void write(const char *text, size_t length) {
+    out_.write(text, static_cast<std::streamsize>(length));
+  }
+
+private:
+  std::ostream &out_;
+};
+
+class StringSink {
+public:
+  explicit StringSink(std::string &buffer) : buffer_{buffer} {}
+  void write(const char *text, size_t length) { buffer_.append(text, length); }
+
+private:
+  std::string &buffer_;
+};
+
+/*
+ * Print a formula in the notation of PrintVisitor, from an explicit stack
+ * of pending items: a subformula to print, or the text that follows an
+ * argument of an operator.
+ */
+template <typename Sink> class StreamingPrinter {
+public:
+  StreamingPrinter(Sink sink, const PrintOptions &options)
+      : sink_{sink}, options_{options} {}
+
+  void print(const LTLfFormula &formula) {
+    if (options_.share_subformulas) {
+      bind_shared_subformulas_(formula);
+    }
+    if (!bindings_.empty()) {
+      write_("let ");
+      for (size_t i = 0; i < bindings_.size(); ++i) {
+        if (i > 0) {
+          write_(", ");
+        }
+        write_name_(i);
+        write_(" = ");
+        print_(*bindings_[i]);
+      }
+      write_(" in ");
+    }
+    print_(formula);
+  }
+
+private:
+  struct Item {
+    const LTLfFormula *formula;
+    const char *text;
+  };
+
+  Sink sink_;
+  const PrintOptions &options_;
+  size_t size_ = 0;
+  bool full_ = false;
+  std::vector<Item> stack_;
+  std::unordered_map<const LTLfFormula *, size_t> names_;
+  std::vector<const LTLfFormula *> bindings_;
+
+  void write_(const char *text, size_t length) {
+    if (full_) {
+      return;
+    }
+    if (options_.max_size != 0 and size_ + length > options_.max_size) {
+      sink_.write(text, options_.max_size - size_);
+      sink_.write("...", 3);
+      full_ = true;
+      return;
+    }
+    sink_.write(text, length);
+    size_ += length;
+  }
+  void write_(const char *text) { write_(text, std::strlen(text)); }
+  void write_name_(size_t index) {
+    auto name = "s" + std::to_string(index);
+    write_(name.data(), name.size());
+  }
+
+  // the root is printed in full even if it is bound, for its binding
+  void print_(const LTLfFormula &root) {
+    stack_.push_back({&root, nullptr});
+    bool is_root = true;
+    while (!stack_.empty() and !full_) {
+      auto item = stack_.back();
+      stack_.pop_back();
+      if (item.text != nullptr) {
+        write_(item.text);
+        continue;
+      }
+      if (!is_root) {
+        auto name = names_.find(item.formula);
+        if (name != names_.end()) {
+          write_name_(name->second);
+          continue;
+        }
+      }
+      is_root = false;
+      dispatch(*item.formula,
+               [this](const auto &formula) { print_node_(formula); });
+    }
+    stack_.clear();
+  }
+
+  void print_node_(const LTLfTrue &) { write_("tt"); }
+  void print_node_(const LTLfFalse &) { write_("ff"); }
+  void print_node_(const LTLfPropTrue &) { write_("true"); }
+  void print_node_(const LTLfPropFalse &) { write_("false"); }
+  void print_node_(const LTLfAtom &formula) {
+    const auto &name =
+        std::static_pointer_cast<const StringSymbol>(formula.symbol)->name;
+    write_(name.data(), name.size());
+  }
+  void print_node_(const LTLfPropositionalNot &formula) {
+    write_("!");
+    stack_.push_back({formula.arg.get(), nullptr});
+  }
+  void print_node_(const LTLfNot &formula) { unary_(formula, "~("); }
+  void print_node_(const LTLfNext &formula) { unary_(formula, "X[!]("); }
+  void print_node_(const LTLfWeakNext &formula) { unary_(formula, "X("); }
+  void print_node_(const LTLfEventually &formula) { unary_(formula, "F("); }
+  void print_node_(const LTLfAlways &formula) { unary_(formula, "G("); }
+  void print_node_(const LTLfAnd &formula) { binary_(formula, ") & ("); }
+  void print_node_(const LTLfOr &formula) { binary_(formula, ") | ("); }
+  void print_node_(const LTLfImplies &formula) { binary_(formula, ") -> ("); }
+  void print_node_(const LTLfEquivalent &formula) {
+    binary_(formula, ") <-> (");
+  }
+  void print_node_(const LTLfXor &formula) { binary_(formula, ") ^ ("); }
+  void print_node_(const LTLfUntil &formula) { binary_(formula, ") U ("); }
+  void print_node_(const LTLfRelease &formula) { binary_(formula, ") R ("); }
+
+  void unary_(const LTLfUnaryOp &formula, const char *prefix) {
+    write_(prefix);
+    stack_.push_back({nullptr, ")"});
+    stack_.push_back({formula.arg.get(), nullptr});
+  }
+  // (a0) op (a1) op ... (an), the arguments pushed from the last one
+  void binary_(const LTLfBinaryOp &formula, const char *separator) {
+    write_("(");
+    stack_.push_back({nullptr, ")"});
+    for (auto it = formula.args.rbegin(); it != formula.args.rend(); ++it) {
+      if (it != formula.args.rbegin()) {
+        stack_.push_back({nullptr, separator});
+      }
+      stack_.push_back({it->get(), nullptr});
+    }
+  }
+
+  static bool is_leaf_(const LTLfFormula &formula) {
+    switch (formula.type_code()) {
+    case TypeID::t_LTLfTrue:
+    case TypeID::t_LTLfFalse:
+    case TypeID::t_LTLfPropTrue:
+    case TypeID::t_LTLfPropFalse:
+    case TypeID::t_LTLfAtom:
+    case TypeID::t_LTLfPropNot:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // name the subformulas with more than one occurrence, in post order, so
+  // that a binding only refers to earlier ones
+  void bind_shared_subformulas_(const LTLfFormula &formula) {
+    std::unordered_map<const LTLfFormula *, size_t> nb_references;
+    std::vector<const LTLfFormula *> pending{&formula};
+    while (!pending.empty()) {
+      const auto *current = pending.back();
+      pending.pop_back();
+      for_each_argument(*current, [&](const LTLfFormula &arg) {
+        if (++nb_references[&arg] == 1 and !is_leaf_(arg)) {
+          pending.push_back(&arg);
+        }
+      });
+    }
+
+    std::unordered_set<const LTLfFormula *> reached{&formula};
+    std::vector<std::pair<const LTLfFormula *, bool>> frames{{&formula, false}};
+    while (!frames.empty()) {
+      auto &frame = frames.back();
+      const auto *current = frame.first;
+      if (frame.second) {
+        frames.pop_back();
+        if (nb_references[current] > 1) {
+          names_.emplace(current, bindings_.size());
+          bindings_.push_back(current);
+        }
+        continue;
+      }
+      frame.second = true;
+      for_each_argument(*current, [&](const LTLfFormula &arg) {
+        if (!is_leaf_(arg) and reached.insert(&arg).second) {
+          frames.push_back({&arg, false});
+        }
+      });
+    }
+  }
+};
+
+} // namespace
+
+void print(std::ostream &out, const LTLfFormula &f,
+           const PrintOptions &options) {
+  StreamingPrinter<StreamSink>(StreamSink{out}, options).print(f);
+}
+
+void print(std::string &buffer, const LTLfFormula &f,
+           const PrintOptions &options) {
+  StreamingPrinter<StringSink>(StringSink{buffer}, options).print(f);
+}
+
 std::string to_string(const LTLfFormula &f) {
-  PrintVisitor visitor{};
-  return visitor.apply(f);
+  return to_string(f, PrintOptions());
+}
+
+std::string to_string(const LTLfFormula &f, const PrintOptions &options) {
+  std::string result;
+  print(result, f, options);
+  return result;
 }
 
 } // namespace logic
@@ -23,37 +23,34 @@
 namespace nike {
 namespace logic {
 
-void ReplaceVisitor::visit(const PLTrue &f) { result = f.ctx().make_true(); }
-void ReplaceVisitor::visit(const PLFalse &f) { result = f.ctx().make_false(); }
-void ReplaceVisitor::visit(const PLLiteral &f) {
+pl_ptr ReplaceVisitor::visit(const PLTrue &f) { return f.ctx().make_true(); }
+pl_ptr ReplaceVisitor::visit(const PLFalse &f) {
+  return f.ctx().make_false();
+}
+pl_ptr ReplaceVisitor::visit(const PLLiteral &f) {
   auto replacement = replacements.find(f.proposition);
   if (replacement == replacements.end()) {
-    result = std::static_pointer_cast<const PLFormula>(f.shared_from_this());
-    return;
+    return shared_from(f);
   }
 
-  result = replacement->second != f.negated ? f.ctx().make_true()
-                                            : f.ctx().make_false();
+  return replacement->second != f.negated ? f.ctx().make_true()
+                                          : f.ctx().make_false();
 }
 
-void ReplaceVisitor::visit(const PLAnd &f) {
-  result = forward_call_to_arguments(
+pl_ptr ReplaceVisitor::visit(const PLAnd &f) {
+  return forward_call_to_arguments(
       f, [this](const pl_ptr &formula) { return apply(*formula); },
-      [f](const vec_pl_ptr &container) {
+      [&f](const vec_pl_ptr &container) {
         return f.ctx().make_prop_and(container);
       });
 }
-void ReplaceVisitor::visit(const PLOr &f) {
-  result = forward_call_to_arguments(
+pl_ptr ReplaceVisitor::visit(const PLOr &f) {
+  return forward_call_to_arguments(
       f, [this](const pl_ptr &formula) { return apply(*formula); },
-      [f](const vec_pl_ptr &container) {
+      [&f](const vec_pl_ptr &container) {
         return f.ctx().make_prop_or(container);
       });
 }
-pl_ptr ReplaceVisitor::apply(const PLFormula &b) {
-  b.accept(*this);
-  return result;
-}
 
 pl_ptr replace(std::map<ast_ptr, bool, utils::Deref::Less> replacements,
                const PLFormula &formula) {
@@ -0,0 +1,350 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/serialize.hpp>
+#include <nike/logic/traversal.hpp>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace nike {
+namespace logic {
+
+namespace {
+
+const uint32_t magic[2] = {0x454b494e, 0x00474144}; // "NIKE" "DAG\0"
+const size_t header_size = 6;
+
+/*
+ * Number the nodes in post order, and append them to the words of the
+ * node section; the result of a node is its index.
+ */
+class DagWriter : public PostOrderVisitor<DagWriter, LTLfFormula, uint32_t> {
+public:
+  std::vector<uint32_t> nodes;
+  std::vector<const StringSymbol *> symbols;
+  uint32_t nb_nodes = 0;
+
+  void expand(const LTLfFormula &f, size_t) {
+    for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
+  }
+  uint32_t combine(const LTLfFormula &f, size_t, const uint32_t *args) {
+    nodes.push_back(static_cast<uint32_t>(f.type_code()));
+    if (f.type_code() == TypeID::t_LTLfAtom) {
+      nodes.push_back(1);
+      nodes.push_back(symbol_index_(static_cast<const LTLfAtom &>(f)));
+      return nb_nodes++;
+    }
+    uint32_t nb_args = 0;
+    for_each_argument(f, [&nb_args](const LTLfFormula &) { ++nb_args; });
+    nodes.push_back(nb_args);
+    nodes.insert(nodes.end(), args, args + nb_args);
+    return nb_nodes++;
+  }
+
+private:
+  std::unordered_map<const AstNode *, uint32_t> symbol_indices_;
+
+  uint32_t symbol_index_(const LTLfAtom &atom) {
+    auto inserted = symbol_indices_.emplace(
+        atom.symbol.get(), static_cast<uint32_t>(symbols.size()));
+    if (inserted.second) {
+      symbols.push_back(static_cast<const StringSymbol *>(atom.symbol.get()));
+    }
+    return inserted.first->second;
+  }
+};
+
+void write_words(std::ostream &out, const uint32_t *words, size_t nb_words) {
+  out.write(reinterpret_cast<const char *>(words),
+            static_cast<std::streamsize>(nb_words * sizeof(uint32_t)));
+}
+
+/*
+ * Bounds-checked reads of the words of the data.
+ */
+class WordReader {
+public:
+  WordReader(const char *data, size_t size)
+      : data_{data}, nb_words_{size / sizeof(uint32_t)} {}
+
+  uint32_t next() {
+    check_(1);
+    uint32_t word;
+    std::memcpy(&word, data_ + position_ * sizeof(uint32_t), sizeof(word));
+    ++position_;
+    return word;
+  }
+  /// the next bytes, rounded up to whole words
+  std::string next_string(uint32_t nb_bytes) {
+    auto nb_words = (nb_bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    check_(nb_words);
+    std::string result(data_ + position_ * sizeof(uint32_t), nb_bytes);
+    position_ += nb_words;
+    return result;
+  }
+  /// the number of words left to read
+  size_t nb_remaining() const { return nb_words_ - position_; }
+
+private:
+  const char *data_;
+  size_t nb_words_;
+  size_t position_ = 0;
+
+  void check_(size_t nb_words) const {
+    if (position_ + nb_words > nb_words_) {
+      throw std::runtime_error("truncated formula DAG");
+    }
+  }
+};
+
+/*
+ * Suspend the simplification of a context for the lifetime of the object.
+ */
+class SimplificationPause {
+public:
+  explicit SimplificationPause(Context &context)
+      : context_{context}, previous_{context.is_simplifying()} {
+    context_.set_simplification(false);
+  }
+  ~SimplificationPause() { context_.set_simplification(previous_); }
+
+private:
+  Context &context_;
+  bool previous_;
+};
+
+ltlf_ptr build_node(Context &context, TypeID type, const vec_ptr &args,
+                    const ast_ptr &symbol) {
+  auto arity = [&args](size_t expected) {
+    if (expected == 0 ? !args.empty() : args.size() < expected) {
+      throw std::runtime_error("bad number of arguments in formula DAG");
+    }
+  };
+  switch (type) {
+  case TypeID::t_LTLfTrue:
+    arity(0);
+    return context.make_tt();
+  case TypeID::t_LTLfFalse:
+    arity(0);
+    return context.make_ff();
+  case TypeID::t_LTLfPropTrue:
+    arity(0);
+    return context.make_prop_true();
+  case TypeID::t_LTLfPropFalse:
+    arity(0);
+    return context.make_prop_false();
+  case TypeID::t_LTLfAtom:
+    return context.make_atom(symbol);
+  case TypeID::t_LTLfNot:
+    arity(1);
+    return context.make_not(args[0]);
+  case TypeID::t_LTLfPropNot:
+    arity(1);
+    return context.make_prop_not(args[0]);
+  case TypeID::t_LTLfAnd:
+    arity(2);
+    return context.make_and(args);
+  case TypeID::t_LTLfOr:
+    arity(2);
+    return context.make_or(args);
+  case TypeID::t_LTLfImplies:
+    arity(2);
+    return context.make_implies(args);
+  case TypeID::t_LTLfEquivalent:
+    arity(2);
+    return context.make_equivalent(args);
+  case TypeID::t_LTLfXor:
+    arity(2);
+    return context.make_xor(args);
+  case TypeID::t_LTLfNext:
+    arity(1);
+    return context.make_next(args[0]);
+  case TypeID::t_LTLfWeakNext:
+    arity(1);
+    return context.make_weak_next(args[0]);
+  case TypeID::t_LTLfUntil:
+    arity(2);
+    return context.make_until(args);
+  case TypeID::t_LTLfRelease:
+    arity(2);
+    return context.make_release(args);
+  case TypeID::t_LTLfEventually:
+    arity(1);
+    return context.make_eventually(args[0]);
+  case TypeID::t_LTLfAlways:
+    arity(1);
+    return context.make_always(args[0]);
+  default:
+    throw std::runtime_error("unknown node type in formula DAG");
+  }
+}
+
+} // namespace
+
+void write_dag(std::ostream &out, const vec_ptr &roots) {
+  DagWriter writer;
+  std::vector<uint32_t> root_indices;
+  root_indices.reserve(roots.size());
+  for (const auto &root : roots) {
+    root_indices.push_back(writer.apply(*root));
+  }
+
+  const uint32_t header[header_size] = {
+      magic[0],
+      magic[1],
+      dag_format_version,
+      static_cast<uint32_t>(writer.symbols.size()),
+      writer.nb_nodes,
+      static_cast<uint32_t>(roots.size())};
+  write_words(out, header, header_size);
+  for (const auto *symbol : writer.symbols) {
+    const auto &name = symbol->name;
+    const auto length = static_cast<uint32_t>(name.size());
+    write_words(out, &length, 1);
+    out.write(name.data(), static_cast<std::streamsize>(length));
+    const auto padding = (sizeof(uint32_t) - length % sizeof(uint32_t)) %
+                         sizeof(uint32_t);
+    out.write("\0\0\0", static_cast<std::streamsize>(padding));
+  }
+  write_words(out, writer.nodes.data(), writer.nodes.size());
+  write_words(out, root_indices.data(), root_indices.size());
+}
+
+void write_dag_to_file(const std::string &filename, const vec_ptr &roots) {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out.good()) {
+    throw std::runtime_error("cannot open file " + filename);
+  }
+  write_dag(out, roots);
+  if (!out.good()) {
+    throw std::runtime_error("cannot write file " + filename);
+  }
+}
+
+vec_ptr read_dag(Context &context, const char *data, size_t size) {
+  WordReader reader{data, size};
+  if (reader.next() != magic[0] or reader.next() != magic[1]) {
+    throw std::runtime_error("not a formula DAG");
+  }
+  auto version = reader.next();
+  if (version != dag_format_version) {
+    throw std::runtime_error("unsupported formula DAG version " +
+                             std::to_string(version));
+  }
+  const auto nb_symbols = reader.next();
+  const auto nb_nodes = reader.next();
+  const auto nb_roots = reader.next();
+  // a symbol takes at least one word, a node two and a root one: the
+  // counts are checked against the data before memory is reserved for them
+  if (size_t(nb_symbols) + 2 * size_t(nb_nodes) + size_t(nb_roots) >
+      reader.nb_remaining()) {
+    throw std::runtime_error("truncated formula DAG");
+  }
+
+  SimplificationPause pause{context};
+  std::vector<ast_ptr> symbols;
+  symbols.reserve(nb_symbols);
+  for (uint32_t i = 0; i < nb_symbols; ++i) {
+    symbols.push_back(
+        context.make_string_symbol(reader.next_string(reader.next())));
+  }
+
+  // the arguments are the indices of earlier nodes: no fix-up is needed
+  // beyond looking them up
+  vec_ptr nodes;
+  nodes.reserve(nb_nodes);
+  vec_ptr args;
+  for (uint32_t i = 0; i < nb_nodes; ++i) {
+    const auto type = static_cast<TypeID>(reader.next());
+    const auto nb_args = reader.next();
+    args.clear();
+    ast_ptr symbol;
+    if (type == TypeID::t_LTLfAtom) {
+      auto index = nb_args == 1 ? reader.next() : nb_symbols;
+      if (index >= nb_symbols) {
+        throw std::runtime_error("bad symbol index in formula DAG");
+      }
+      symbol = symbols[index];
+    } else {
+      for (uint32_t j = 0; j < nb_args; ++j) {
+        auto index = reader.next();
+        if (index >= i) {
+          throw std::runtime_error("bad node index in formula DAG");
+        }
+        args.push_back(nodes[index]);
+      }
+    }
+    nodes.push_back(build_node(context, type, args, symbol));
+  }
+
+  vec_ptr roots;
+  roots.reserve(nb_roots);
+  for (uint32_t i = 0; i < nb_roots; ++i) {
+    auto index = reader.next();
+    if (index >= nb_nodes) {
+      throw std::runtime_error("bad root index in formula DAG");
+    }
+    roots.push_back(nodes[index]);
+  }
+  return roots;
+}
+
+vec_ptr read_dag_from_file(Context &context, const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("cannot open file " + filename + ": " +
+                             std::strerror(errno));
+  }
+  struct stat status {};
+  if (fstat(fd, &status) != 0) {
+    auto error = errno;
+    close(fd);
+    throw std::runtime_error("cannot stat file " + filename + ": " +
+                             std::strerror(error));
+  }
+  const auto size = static_cast<size_t>(status.st_size);
+  if (size == 0) {
+    close(fd);
+    throw std::runtime_error("not a formula DAG");
+  }
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(std::string("mmap failed: ") +
+                             std::strerror(errno));
+  }
+  try {
+    auto result = read_dag(context, static_cast<const char *>(mapping), size);
+    munmap(mapping, size);
+    return result;
+  } catch (...) {
+    munmap(mapping, size);
+    throw;
+  }
+}
+
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,243 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <nike/logic/copy.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/simplify.hpp>
+
+namespace nike {
+namespace logic {
+
+std::string simplification_rule_to_string(SimplificationRule rule) {
+  switch (rule) {
+  case SimplificationRule::absorption:
+    return "absorption";
+  case SimplificationRule::complementary_literals:
+    return "complementary_literals";
+  case SimplificationRule::idempotent_temporal:
+    return "idempotent_temporal";
+  case SimplificationRule::temporal_constant:
+    return "temporal_constant";
+  case SimplificationRule::next_distribution:
+    return "next_distribution";
+  }
+  return "unknown";
+}
+
+size_t SimplificationStats::total() const {
+  size_t result = 0;
+  for (const auto &count : counts_) {
+    result += count.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+void SimplificationStats::reset() {
+  for (auto &count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+namespace {
+
+// the nodes are interned: they are found by identity
+bool contains(const vec_ptr &args, const LTLfFormula &formula) {
+  return std::any_of(args.begin(), args.end(), [&formula](const ltlf_ptr &arg) {
+    return arg.get() == &formula;
+  });
+}
+
+// the factories rewrite the nodes they build only when the simplification
+// of the context is on, and without distributing the next operators; the
+// rules build new nodes that must be rewritten in any case
+ltlf_ptr rewritten(const ltlf_ptr &formula, bool distribute_next) {
+  if (formula->ctx().is_simplifying() and !distribute_next) {
+    return formula;
+  }
+  return rewrite(*formula, distribute_next);
+}
+
+ltlf_ptr fired(SimplificationRule rule, Context &context, ltlf_ptr result) {
+  context.simplification_stats().record(rule);
+  return result;
+}
+
+// the rules on the argument of a temporal operator: the operator is
+// dropped if it is idempotent and applied to itself, or if its argument is
+// the given constant; nullptr if none applies
+ltlf_ptr rewrite_unary(const LTLfUnaryOp &formula, bool idempotent,
+                       TypeID absorbing) {
+  auto &context = formula.ctx();
+  auto type = formula.arg->type_code();
+  if (idempotent and type == formula.type_code()) {
+    return fired(SimplificationRule::idempotent_temporal, context,
+                 formula.arg);
+  }
+  if (type == absorbing) {
+    return fired(SimplificationRule::temporal_constant, context, formula.arg);
+  }
+  return nullptr;
+}
+
+// the rules on the arguments of a conjunction or of a disjunction; nullptr
+// if none applies
+ltlf_ptr rewrite_and_or(const LTLfBinaryOp &formula, bool is_or,
+                        bool distribute_next) {
+  auto &context = formula.ctx();
+  const auto &args = formula.args;
+  auto rebuild = [&context, is_or, distribute_next](const vec_ptr &new_args) {
+    return rewritten(is_or ? context.make_or(new_args)
+                           : context.make_and(new_args),
+                     distribute_next);
+  };
+
+  // a & !a = ff, a | !a = true
+  for (const auto &arg : args) {
+    if (arg->type_code() != TypeID::t_LTLfPropNot) {
+      continue;
+    }
+    const auto &atom = *static_cast<const LTLfPropositionalNot &>(*arg).arg;
+    if (!contains(args, atom)) {
+      continue;
+    }
+    if (!is_or) {
+      return fired(SimplificationRule::complementary_literals, context,
+                   context.make_ff());
+    }
+    vec_ptr new_args{context.make_prop_true()};
+    std::copy_if(args.begin(), args.end(), std::back_inserter(new_args),
+                 [&arg, &atom](const ltlf_ptr &other) {
+                   return other != arg and other.get() != &atom;
+                 });
+    return fired(SimplificationRule::complementary_literals, context,
+                 rebuild(new_args));
+  }
+
+  // a & (a | b) = a, a | (a & b) = a
+  auto dual = is_or ? TypeID::t_LTLfAnd : TypeID::t_LTLfOr;
+  vec_ptr kept;
+  for (const auto &arg : args) {
+    bool absorbed = false;
+    if (arg->type_code() == dual) {
+      const auto &dual_args = static_cast<const LTLfBinaryOp &>(*arg).args;
+      absorbed = std::any_of(dual_args.begin(), dual_args.end(),
+                             [&args](const ltlf_ptr &dual_arg) {
+                               return contains(args, *dual_arg);
+                             });
+    }
+    if (!absorbed) {
+      kept.push_back(arg);
+    }
+  }
+  if (kept.size() < args.size()) {
+    return fired(SimplificationRule::absorption, context, rebuild(kept));
+  }
+
+  if (!distribute_next) {
+    return nullptr;
+  }
+  // X a & X b = X(a & b), and the same for |, and for the weak next
+  for (auto next : {TypeID::t_LTLfNext, TypeID::t_LTLfWeakNext}) {
+    vec_ptr next_args;
+    vec_ptr others;
+    for (const auto &arg : args) {
+      if (arg->type_code() == next) {
+        next_args.push_back(static_cast<const LTLfUnaryOp &>(*arg).arg);
+      } else {
+        others.push_back(arg);
+      }
+    }
+    if (next_args.size() < 2) {
+      continue;
+    }
+    auto merged = rebuild(next_args);
+    others.push_back(rewritten(next == TypeID::t_LTLfNext
+                                   ? context.make_next(merged)
+                                   : context.make_weak_next(merged),
+                               distribute_next));
+    return fired(SimplificationRule::next_distribution, context,
+                 rebuild(others));
+  }
+  return nullptr;
+}
+
+ltlf_ptr rewrite_root(const LTLfFormula &formula, bool distribute_next) {
+  switch (formula.type_code()) {
+  case TypeID::t_LTLfAnd:
+    return rewrite_and_or(static_cast<const LTLfBinaryOp &>(formula), false,
+                          distribute_next);
+  case TypeID::t_LTLfOr:
+    return rewrite_and_or(static_cast<const LTLfBinaryOp &>(formula), true,
+                          distribute_next);
+  case TypeID::t_LTLfEventually:
+    // F F a = F a, F ff = ff
+    return rewrite_unary(static_cast<const LTLfUnaryOp &>(formula), true,
+                         TypeID::t_LTLfFalse);
+  case TypeID::t_LTLfAlways:
+    // G G a = G a, G tt = tt
+    return rewrite_unary(static_cast<const LTLfUnaryOp &>(formula), true,
+                         TypeID::t_LTLfTrue);
+  case TypeID::t_LTLfNext:
+    // X ff = ff; X tt is not valid, it requires a next instant
+    return rewrite_unary(static_cast<const LTLfUnaryOp &>(formula), false,
+                         TypeID::t_LTLfFalse);
+  case TypeID::t_LTLfWeakNext:
+    // X[!] tt = tt
+    return rewrite_unary(static_cast<const LTLfUnaryOp &>(formula), false,
+                         TypeID::t_LTLfTrue);
+  default:
+    return nullptr;
+  }
+}
+
+/*
+ * Rebuild every node with the factories of its context, then rewrite it.
+ */
+class SimplifyVisitor
+    : public PostOrderVisitor<SimplifyVisitor, LTLfFormula, ltlf_ptr> {
+public:
+  explicit SimplifyVisitor(Context &context) : copy_{context} {}
+
+  void expand(const LTLfFormula &f, size_t) {
+    for_each_argument(f, [this](const LTLfFormula &arg) { push(arg); });
+  }
+  ltlf_ptr combine(const LTLfFormula &f, size_t tag, const ltlf_ptr *args) {
+    return rewrite(*copy_.combine(f, tag, args), true);
+  }
+
+private:
+  CopyVisitor copy_;
+};
+
+} // namespace
+
+ltlf_ptr rewrite(const LTLfFormula &formula, bool distribute_next) {
+  auto result = shared_from(formula);
+  while (auto step = rewrite_root(*result, distribute_next)) {
+    result = step;
+  }
+  return result;
+}
+
+ltlf_ptr simplify(const LTLfFormula &formula) {
+  SimplifyVisitor visitor{formula.ctx()};
+  return visitor.apply(formula);
+}
+
+} // namespace logic
+} // namespace nike
@@ -15,74 +15,59 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstdint>
 #include <nike/logic/size.hpp>
 
 namespace nike {
 namespace logic {
 
-void SizeVisitor::visit(const logic::LTLfTrue &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfFalse &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfPropTrue &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfPropFalse &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfAtom &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfNot &f) { throw_expected_nnf(); }
-void SizeVisitor::visit(const logic::LTLfPropositionalNot &f) { result += 1; }
-void SizeVisitor::visit(const logic::LTLfAnd &f) {
-  result += 1;
-  apply_to_ltlf_binary_op_(*this, f);
+namespace {
+// the unfolded size of a DAG can exceed the range of size_t: saturate
+size_t saturating_add(size_t a, size_t b) {
+  return a > SIZE_MAX - b ? SIZE_MAX : a + b;
 }
-void SizeVisitor::visit(const logic::LTLfOr &f) {
-  result += 1;
-  apply_to_ltlf_binary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfImplies &f) { throw_expected_nnf(); }
-void SizeVisitor::visit(const logic::LTLfEquivalent &f) {
-  throw_expected_nnf();
-}
-void SizeVisitor::visit(const logic::LTLfXor &f) { throw_expected_nnf(); }
-void SizeVisitor::visit(const logic::LTLfNext &f) {
-  result += 1;
-  apply_to_ltlf_unary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfWeakNext &f) {
-  result += 1;
-  apply_to_ltlf_unary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfUntil &f) {
-  result += 1;
-  apply_to_ltlf_binary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfRelease &f) {
-  result += 1;
-  apply_to_ltlf_binary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfEventually &f) {
-  result += 1;
-  apply_to_ltlf_unary_op_(*this, f);
-}
-void SizeVisitor::visit(const logic::LTLfAlways &f) {
-  result += 1;
-  apply_to_ltlf_unary_op_(*this, f);
+
+// call the function on the arguments counted in the size of the formula
+template <typename Function>
+void for_each_sized_argument(const AstNode &f, size_t is_pl,
+                             Function function) {
+  if (is_pl) {
+    for_each_argument(static_cast<const PLFormula &>(f), function);
+    return;
+  }
+  switch (f.type_code()) {
+  case TypeID::t_LTLfNot:
+  case TypeID::t_LTLfImplies:
+  case TypeID::t_LTLfEquivalent:
+  case TypeID::t_LTLfXor:
+    throw_expected_nnf();
+  case TypeID::t_LTLfPropNot:
+    // a literal counts as one
+    return;
+  default:
+    for_each_argument(static_cast<const LTLfFormula &>(f), function);
+  }
 }
-void SizeVisitor::visit(const logic::PLTrue &f) { result += 1; }
-void SizeVisitor::visit(const logic::PLFalse &f) { result += 1; }
-void SizeVisitor::visit(const logic::PLLiteral &f) { result += 1; }
-void SizeVisitor::visit(const logic::PLAnd &f) {
-  result += 1;
-  apply_to_pl_binary_op_(*this, f);
+} // namespace
+
+void SizeVisitor::expand(const AstNode &f, size_t tag) {
+  for_each_sized_argument(f, tag == pl,
+                          [this, tag](const AstNode &arg) { push(arg, tag); });
 }
-void SizeVisitor::visit(const logic::PLOr &f) {
-  result += 1;
-  apply_to_pl_binary_op_(*this, f);
+
+size_t SizeVisitor::combine(const AstNode &f, size_t tag, const size_t *args) {
+  size_t total = 1;
+  for_each_sized_argument(f, tag == pl, [&total, &args](const AstNode &) {
+    total = saturating_add(total, *args++);
+  });
+  return total;
 }
 
 size_t SizeVisitor::apply(const logic::LTLfFormula &formula) {
-  formula.accept(*this);
-  return result;
+  return PostOrderVisitor::apply(formula, ltlf);
 }
 size_t SizeVisitor::apply(const logic::PLFormula &formula) {
-  formula.accept(*this);
-  return result;
+  return PostOrderVisitor::apply(formula, pl);
 }
 
 size_t size(const logic::LTLfFormula &formula) {
@@ -0,0 +1,136 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/aig.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/replace.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("structural hashing and constant propagation", "[logic][aig]") {
+  auto context = Context();
+  Aig aig;
+  auto a = aig.make_input(context.make_string_symbol("a"));
+  auto b = aig.make_input(context.make_string_symbol("b"));
+  REQUIRE(aig.make_input(context.make_string_symbol("a")) == a);
+  REQUIRE(aig.is_input(a));
+  REQUIRE(Aig::is_negated(Aig::negate(a)));
+
+  auto a_and_b = aig.make_and(a, b);
+  REQUIRE(aig.is_and(a_and_b));
+  REQUIRE(aig.make_and(b, a) == a_and_b);
+  REQUIRE(aig.nb_nodes() == 4);
+
+  REQUIRE(aig.make_and(a, Aig::true_edge) == a);
+  REQUIRE(aig.make_and(a, Aig::false_edge) == Aig::false_edge);
+  REQUIRE(aig.make_and(a, a) == a);
+  REQUIRE(aig.make_and(a, Aig::negate(a)) == Aig::false_edge);
+  REQUIRE(aig.make_or(a, Aig::negate(a)) == Aig::true_edge);
+  REQUIRE(aig.make_or(a, Aig::false_edge) == a);
+  REQUIRE(aig.nb_nodes() == 4);
+}
+
+TEST_CASE("cofactors and support", "[logic][aig]") {
+  auto context = Context();
+  auto a = context.make_string_symbol("a");
+  auto b = context.make_string_symbol("b");
+  auto next = context.make_next(context.make_atom("c"));
+  // (a & X[!]c) | (!a & b)
+  auto formula = context.make_prop_or(
+      {context.make_prop_and(
+           {context.make_literal(a, false), context.make_literal(next, false)}),
+       context.make_prop_and(
+           {context.make_literal(a, true), context.make_literal(b, false)})});
+  Aig aig;
+  auto edge = to_aig(aig, *formula);
+
+  auto support = aig.support(edge);
+  REQUIRE(support.size() == 2);
+  REQUIRE(support.contains(static_cast<const StringSymbol &>(*a).index()));
+  REQUIRE(support.contains(static_cast<const StringSymbol &>(*b).index()));
+
+  auto a_true = aig.cofactor(edge, *a, true);
+  REQUIRE(a_true == aig.make_input(next));
+  auto a_false = aig.cofactor(edge, *a, false);
+  REQUIRE(a_false == aig.make_input(b));
+  REQUIRE(aig.cofactor(a_false, *b, false) == Aig::false_edge);
+  // no input for the proposition
+  REQUIRE(aig.cofactor(edge, *context.make_string_symbol("d"), true) == edge);
+
+  SECTION("same result as the PL replacement") {
+    for (bool value : {true, false}) {
+      auto expected = replace({{a, value}}, *formula);
+      auto actual = to_pl(context, aig, aig.cofactor(edge, *a, value));
+      REQUIRE(actual == expected);
+    }
+    REQUIRE(to_pl(context, aig, Aig::true_edge) == context.make_true());
+  }
+  SECTION("negations are pushed to the literals") {
+    auto negation = to_pl(context, aig, Aig::negate(edge));
+    auto not_a_or_not_next = context.make_prop_or(
+        {context.make_literal(a, true), context.make_literal(next, true)});
+    auto a_or_not_b = context.make_prop_or(
+        {context.make_literal(a, false), context.make_literal(b, true)});
+    REQUIRE(negation ==
+            context.make_prop_and({not_a_or_not_next, a_or_not_b}));
+  }
+}
+
+TEST_CASE("rollback of an AIG", "[logic][aig]") {
+  auto context = Context();
+  Aig aig;
+  auto a = aig.make_input(context.make_string_symbol("a"));
+  auto nb_nodes = aig.nb_nodes();
+  auto c = context.make_string_symbol("c");
+  auto b_and_c = aig.make_and(aig.make_input(context.make_string_symbol("b")),
+                              aig.make_input(c));
+  auto conjunction = aig.make_and(a, b_and_c);
+  REQUIRE(aig.cofactor(conjunction, *c, true) != conjunction);
+
+  aig.rollback(nb_nodes);
+  REQUIRE(aig.nb_nodes() == nb_nodes);
+  REQUIRE(aig.make_input(context.make_string_symbol("a")) == a);
+  // the freed nodes are built again
+  auto c_edge = aig.make_input(c);
+  REQUIRE(c_edge >> 1 == nb_nodes);
+  REQUIRE(aig.make_and(a, c_edge) >> 1 == nb_nodes + 1);
+
+  aig.clear();
+  REQUIRE(aig.nb_nodes() == 1);
+}
+
+TEST_CASE("cofactor of a deep AIG", "[logic][aig]") {
+  auto context = Context();
+  Aig aig;
+  auto a = context.make_string_symbol("a");
+  auto edge = aig.make_input(a);
+  for (int i = 0; i < 100000; ++i) {
+    auto input =
+        aig.make_input(context.make_string_symbol("p" + std::to_string(i)));
+    edge = aig.make_or(aig.make_and(edge, input), Aig::negate(input));
+  }
+  REQUIRE(aig.support(edge).size() == 100001);
+  auto cofactor = aig.cofactor(edge, *a, false);
+  REQUIRE(aig.support(cofactor).size() == 100000);
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,96 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/arena.hpp>
+#include <nike/logic/ltlf.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("Node arena reuses freed blocks", "[logic][arena]") {
+  NodeArena arena;
+  REQUIRE(arena.nb_chunks() == 0);
+  auto p = arena.allocate(40);
+  auto q = arena.allocate(40);
+  REQUIRE(p != q);
+  REQUIRE(arena.nb_live_blocks() == 2);
+  REQUIRE(arena.nb_chunks() == 1);
+  arena.deallocate(p, 40);
+  REQUIRE(arena.nb_live_blocks() == 1);
+  // same size class
+  auto r = arena.allocate(33);
+  REQUIRE(r == p);
+  arena.deallocate(q, 40);
+  arena.deallocate(r, 33);
+  REQUIRE(arena.nb_live_blocks() == 0);
+
+  // large blocks bypass the arena
+  auto large = arena.allocate(NodeArena::max_block_size + 1);
+  REQUIRE(arena.nb_live_blocks() == 0);
+  arena.deallocate(large, NodeArena::max_block_size + 1);
+
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 2 * NodeArena::chunk_size / 64; ++i) {
+    blocks.push_back(arena.allocate(64));
+  }
+  REQUIRE(arena.nb_chunks() >= 2);
+  for (auto block : blocks) {
+    arena.deallocate(block, 64);
+  }
+}
+
+TEST_CASE("Context allocates nodes in its arena", "[logic][arena]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto live_blocks = context.arena().nb_live_blocks();
+
+  // temporary duplicates are released to the arena
+  for (int i = 0; i < 100; ++i) {
+    context.make_and({a, b});
+  }
+  REQUIRE(context.arena().nb_live_blocks() == live_blocks + 1);
+  REQUIRE(context.arena().nb_chunks() == 1);
+}
+
+TEST_CASE("Arena of a thread-safe context", "[logic][arena]") {
+  auto context = Context();
+  REQUIRE(!context.arena().is_synchronized());
+  context.set_thread_safe(true);
+  REQUIRE(context.arena().is_synchronized());
+  auto a = context.make_atom("a");
+  context.set_thread_safe(false);
+  REQUIRE(!context.arena().is_synchronized());
+  REQUIRE(context.make_atom("a") == a);
+}
+
+TEST_CASE("Nodes can outlive their context", "[logic][arena]") {
+  ltlf_ptr formula;
+  {
+    auto context = Context();
+    formula = context.make_until(
+        {context.make_atom("a"), context.make_atom("b")});
+  }
+  REQUIRE(is_a<LTLfUntil>(*formula));
+  formula.reset();
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
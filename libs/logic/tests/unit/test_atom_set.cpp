@@ -0,0 +1,121 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/atom_set.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/pl.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("Atom set operations", "[logic][atom_set]") {
+  AtomSet a, b;
+  REQUIRE(a.empty());
+  REQUIRE(a.first() == AtomSet::npos);
+  a.insert(3);
+  a.insert(70);
+  b.insert(70);
+  b.insert(200);
+  REQUIRE(a.size() == 2);
+  REQUIRE(b.contains(200));
+  REQUIRE(!a.contains(200));
+  REQUIRE(a.intersects(b));
+
+  auto u = a | b;
+  REQUIRE(u.size() == 3);
+  REQUIRE(u.first() == 3);
+  REQUIRE(u.next(4) == 70);
+  REQUIRE(u.next(71) == 200);
+  REQUIRE(u.next(201) == AtomSet::npos);
+
+  auto i = a & b;
+  REQUIRE(i.size() == 1);
+  REQUIRE(i.first() == 70);
+  // the heap words of b do not matter once they are cleared
+  auto expected = AtomSet();
+  expected.insert(70);
+  REQUIRE(i == expected);
+  REQUIRE((b & expected) == expected);
+  REQUIRE((a & AtomSet()).empty());
+  REQUIRE(a != b);
+}
+
+TEST_CASE("Symbols are indexed in creation order", "[logic][atom_set]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  context.make_and({a, context.make_atom("b")});
+  auto c = context.make_string_symbol("c");
+  REQUIRE(context.nb_symbols() == 3);
+  REQUIRE(static_cast<const StringSymbol &>(*c).index() == 2);
+  REQUIRE(context.symbol(0) == context.make_string_symbol("a"));
+  REQUIRE(context.make_string_symbol("c") == c);
+  REQUIRE(context.nb_symbols() == 3);
+
+  // indices of freed symbols are not reused
+  context.collect_garbage();
+  REQUIRE(context.symbol(1) == nullptr);
+  auto b = context.make_string_symbol("b");
+  REQUIRE(static_cast<const StringSymbol &>(*b).index() == 3);
+}
+
+TEST_CASE("Atom set of formulas", "[logic][atom_set]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto c = context.make_atom("c");
+  auto formula =
+      context.make_until({context.make_next(a), context.make_or({b, a})});
+  auto visitor = AtomSetVisitor();
+  auto result = visitor.apply(*formula);
+  REQUIRE(result.size() == 2);
+  REQUIRE(result.contains(0));
+  REQUIRE(result.contains(1));
+  REQUIRE(!result.contains(2));
+  REQUIRE(find_atom_set(*context.make_tt()).empty());
+  REQUIRE(find_atom_set(*c).first() == 2);
+
+  // the temporal propositions of PL literals are not symbols
+  auto b_symbol = context.make_string_symbol("b");
+  auto pl_formula = context.make_prop_and(
+      {context.make_literal(b_symbol, true),
+       context.make_literal(formula, false)});
+  result = visitor.apply(*pl_formula);
+  REQUIRE(result.size() == 1);
+  REQUIRE(result.first() == 1);
+  REQUIRE(visitor.nb_cached() > 0);
+  visitor.clear_cache();
+  REQUIRE(visitor.nb_cached() == 0);
+}
+
+TEST_CASE("Atom sets beyond the inline bits", "[logic][atom_set]") {
+  auto context = Context();
+  vec_pl_ptr literals;
+  for (size_t i = 0; i < AtomSet::nb_inline_bits + 10; ++i) {
+    literals.push_back(context.make_literal(
+        context.make_string_symbol("p" + std::to_string(i)), false));
+  }
+  auto formula = context.make_prop_or(literals);
+  auto result = find_atom_set(*formula);
+  REQUIRE(result.size() == literals.size());
+  REQUIRE(result.next(AtomSet::nb_inline_bits) == AtomSet::nb_inline_bits);
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,91 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/flat.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/size.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("flat layout of a formula", "[logic][flat]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto not_a = context.make_prop_not(a);
+  // (X[!]!a & b) | G(X[!]!a)
+  auto next = context.make_next(not_a);
+  auto formula = context.make_or(
+      {context.make_and({next, b}), context.make_always(next)});
+  auto flat = FlatFormula(*formula);
+
+  // a, !a, X[!]!a, b, the conjunction, G and the disjunction: the shared
+  // subformulas are laid out once
+  REQUIRE(flat.nb_nodes() == 7);
+  const auto &root = flat.node(flat.root());
+  REQUIRE(root.type == TypeID::t_LTLfOr);
+  REQUIRE(root.nb_args == 2);
+  for (uint32_t i = 0; i < flat.nb_nodes(); ++i) {
+    const auto &node = flat.node(i);
+    for (uint32_t j = 0; j < node.nb_args; ++j) {
+      REQUIRE(flat.args(node)[j] < i);
+    }
+  }
+  // G comes after the conjunction, and its argument is shared with it
+  const auto &always = flat.node(flat.root() - 1);
+  REQUIRE(always.type == TypeID::t_LTLfAlways);
+  const auto &next_node = flat.node(flat.args(always)[0]);
+  REQUIRE(next_node.type == TypeID::t_LTLfNext);
+  REQUIRE(flat.node(flat.args(next_node)[0]).symbol ==
+          static_cast<const StringSymbol &>(*context.make_string_symbol("a"))
+              .index());
+  REQUIRE(root.symbol == FlatFormula::no_symbol);
+  REQUIRE(size(flat) == size(*formula));
+}
+
+TEST_CASE("size of a flat formula", "[logic][flat]") {
+  auto context = Context();
+  ltlf_ptr formula = context.make_atom("a");
+  for (int i = 0; i < 100; ++i) {
+    auto atom = context.make_atom("b" + std::to_string(i));
+    formula = context.make_or({context.make_and({atom, formula}),
+                               context.make_weak_next(formula)});
+  }
+  auto flat = FlatFormula(*formula);
+  REQUIRE(flat.nb_nodes() == 1 + 4 * 100);
+  // the tree is too large for size_t
+  REQUIRE(size(flat) == SIZE_MAX);
+  REQUIRE(size(flat) == size(*formula));
+
+  SECTION("deep chain") {
+    ltlf_ptr chain = context.make_atom("a");
+    for (int i = 0; i < 1000000; ++i) {
+      chain = context.make_next(chain);
+    }
+    REQUIRE(size(FlatFormula(*chain)) == 1000001);
+  }
+  SECTION("not in negation normal form") {
+    auto negation = context.make_not(context.make_next(formula));
+    REQUIRE_THROWS_AS(size(FlatFormula(*negation)), std::logic_error);
+  }
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
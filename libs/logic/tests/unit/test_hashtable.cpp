@@ -18,6 +18,9 @@
 #include <catch.hpp>
 #include <nike/logic/hashtable.hpp>
 #include <nike/logic/ltlf.hpp>
+#include <set>
+#include <thread>
+#include <vector>
 
 namespace nike {
 namespace logic {
@@ -43,6 +46,160 @@ TEST_CASE("Create hash table", "[logic][hashtable]") {
   REQUIRE(*actual_element_1_ptr_b == *expected_element_1_ptr);
   REQUIRE(actual_element_1_ptr_b == expected_element_1_ptr);
 }
+
+TEST_CASE("Probe hash table by signature", "[logic][hashtable]") {
+  auto context = Context();
+  auto table = HashTable{};
+  auto atom = std::make_shared<const LTLfAtom>(context, "a");
+  table.insert_if_not_available(atom);
+  auto is_atom = [](const AstNode &node) { return is_a<LTLfAtom>(node); };
+  REQUIRE(table.find<LTLfAtom>(atom->hash(), is_atom) == atom);
+  REQUIRE(table.find<LTLfAtom>(atom->hash() + 1, is_atom) == nullptr);
+  auto is_not = [](const AstNode &node) { return is_a<LTLfNot>(node); };
+  REQUIRE(table.find<LTLfNot>(atom->hash(), is_not) == nullptr);
+}
+
+TEST_CASE("Existing nodes are not allocated again", "[logic][hashtable]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto formulas = vec_ptr{context.make_not(a),
+                          context.make_next(b),
+                          context.make_until({a, b}),
+                          context.make_and({a, b}),
+                          context.make_or({b, a})};
+  auto literal = context.make_literal(a, true);
+  auto live_blocks = context.arena().nb_live_blocks();
+
+  REQUIRE(context.make_atom("a") == a);
+  REQUIRE(context.make_not(a) == formulas[0]);
+  REQUIRE(context.make_next(b) == formulas[1]);
+  REQUIRE(context.make_until({a, b}) == formulas[2]);
+  REQUIRE(context.make_and({b, a}) == formulas[3]);
+  REQUIRE(context.make_or({a, b, a}) == formulas[4]);
+  REQUIRE(context.make_literal(a, true) == literal);
+  REQUIRE(context.make_literal(a, false) != literal);
+  REQUIRE(context.arena().nb_live_blocks() == live_blocks + 1);
+}
+
+TEST_CASE("Hash of generated names", "[logic][hashtable]") {
+  auto context = Context();
+  std::set<hash_t> hashes;
+  std::set<hash_t> low_bits;
+  const size_t nb_atoms = 10000;
+  for (size_t i = 0; i < nb_atoms; ++i) {
+    auto atom = context.make_atom("p_" + std::to_string(i));
+    hashes.insert(atom->hash());
+    low_bits.insert(atom->hash() & 0xffff);
+  }
+  REQUIRE(hashes.size() == nb_atoms);
+  // the low bits select the bucket: most of them should differ
+  REQUIRE(low_bits.size() > nb_atoms * 8 / 10);
+  REQUIRE(context.nb_hash_collisions() == 0);
+
+  // all lengths take a different path
+  std::set<uint64_t> byte_hashes;
+  std::string s;
+  for (size_t length = 0; length < 64; ++length) {
+    byte_hashes.insert(hashing::bytes(s.data(), s.size(), 0));
+    s.push_back('x');
+  }
+  REQUIRE(byte_hashes.size() == 64);
+}
+
+TEST_CASE("Collect unreferenced nodes", "[logic][hashtable]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto nb_nodes = context.nb_nodes();
+  auto kept = context.make_next(context.make_eventually(a));
+  {
+    auto b = context.make_atom("b");
+    context.make_until({context.make_always(b), context.make_next(a)});
+  }
+  auto nb_ids = context.nb_ids();
+  // the until, G(b), b, X(a) and its symbol "b"
+  REQUIRE(context.collect_garbage() == 5);
+  REQUIRE(context.nb_nodes() == nb_nodes + 2);
+  REQUIRE(context.collect_garbage() == 0);
+
+  // kept nodes are still interned, and ids are not reused
+  REQUIRE(context.make_next(context.make_eventually(a)) == kept);
+  auto b = context.make_atom("b");
+  REQUIRE(b->id() >= nb_ids);
+}
+
+TEST_CASE("Collect a deep formula in one sweep", "[logic][hashtable]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto nb_nodes = context.nb_nodes();
+  {
+    // X X ... X a, with a shared subformula
+    ltlf_ptr formula = a;
+    for (size_t i = 0; i < 100000; ++i) {
+      formula = context.make_next(formula);
+    }
+    context.make_and({formula, context.make_next(a)});
+  }
+  REQUIRE(context.collect_garbage() == 100001);
+  REQUIRE(context.nb_nodes() == nb_nodes);
+  REQUIRE(context.collect_garbage() == 0);
+}
+
+TEST_CASE("Shared pointers of interned nodes", "[logic][hashtable]") {
+  ltlf_ptr next;
+  {
+    auto context = Context();
+    auto a = context.make_atom("a");
+    next = context.make_next(a);
+    // the owner is the pointer of the table
+    REQUIRE(next->owner() != nullptr);
+    REQUIRE(*next->owner() == next);
+    auto use_count = next.use_count();
+    std::shared_ptr<const LTLfNext> typed =
+        shared_from(static_cast<const LTLfNext &>(*next));
+    REQUIRE(typed == next);
+    REQUIRE(next.use_count() == use_count + 1);
+
+    // nodes that are not interned fall back to shared_from_this()
+    auto atom = std::make_shared<const LTLfAtom>(context, "b");
+    REQUIRE(atom->owner() == nullptr);
+    REQUIRE(shared_from(*atom) == atom);
+  }
+  // the node outlives its context, and is detached from the table
+  REQUIRE(next->owner() == nullptr);
+  REQUIRE(shared_from(*next) == next);
+}
+
+TEST_CASE("Concurrent interning in thread-safe context",
+          "[logic][hashtable]") {
+  auto context = Context();
+  context.set_thread_safe(true);
+  REQUIRE(context.is_thread_safe());
+  const size_t nb_threads = 4;
+  const size_t nb_atoms = 50;
+  std::vector<vec_ptr> results(nb_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nb_threads; ++t) {
+    threads.emplace_back([&context, &results, t, nb_atoms]() {
+      for (size_t i = 0; i < nb_atoms; ++i) {
+        auto a = context.make_atom("a" + std::to_string(i));
+        auto b = context.make_atom("b" + std::to_string(i));
+        results[t].push_back(
+            context.make_and({context.make_eventually(a), b}));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 1; t < nb_threads; ++t) {
+    for (size_t i = 0; i < nb_atoms; ++i) {
+      REQUIRE(results[t][i] == results[0][i]);
+    }
+  }
+  context.set_thread_safe(false);
+  REQUIRE(!context.is_thread_safe());
+}
 } // namespace Test
 } // namespace logic
 } // namespace nike
\ No newline at end of file
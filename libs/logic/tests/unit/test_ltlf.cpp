@@ -281,6 +281,40 @@ TEST_CASE("disjunction simplification with end, not accepts-empty",
   REQUIRE(std::static_pointer_cast<const LTLfAnd>(expected)->args.size() == 2);
 }
 
+TEST_CASE("long conjunctions and disjunctions", "[logic][ltlf]") {
+  auto context = Context();
+  const int n = 5000;
+  vec_ptr atoms;
+  // in reverse order of creation, with duplicates
+  for (int i = n - 1; i >= 0; --i) {
+    atoms.push_back(context.make_atom("p" + std::to_string(i)));
+    atoms.push_back(context.make_atom("p" + std::to_string(i / 2)));
+  }
+
+  auto conjunction = context.make_and(atoms);
+  REQUIRE(is_a<LTLfAnd>(*conjunction));
+  const auto &args = std::static_pointer_cast<const LTLfAnd>(conjunction)->args;
+  REQUIRE(args.size() == n);
+  REQUIRE(std::is_sorted(args.begin(), args.end(), utils::Deref::Less()));
+  // the same node as built pairwise, or from nested chains
+  auto pairwise = atoms[0];
+  for (size_t i = 1; i < 200; ++i) {
+    pairwise = context.make_and({pairwise, atoms[i]});
+  }
+  auto prefix = vec_ptr(atoms.begin(), atoms.begin() + 200);
+  REQUIRE(pairwise == context.make_and(prefix));
+  auto rest = vec_ptr(atoms.begin() + 200, atoms.end());
+  REQUIRE(context.make_and({pairwise, context.make_and(rest)}) == conjunction);
+
+  atoms.push_back(context.make_end());
+  auto disjunction = context.make_or(atoms);
+  REQUIRE(is_a<LTLfOr>(*disjunction));
+  REQUIRE(std::static_pointer_cast<const LTLfOr>(disjunction)->args.size() ==
+          n + 1);
+  atoms.push_back(context.make_tt());
+  REQUIRE(context.make_or(atoms) == context.make_tt());
+}
+
 TEST_CASE("implication", "[logic][ltlf]") {
   auto context = Context();
 
@@ -448,6 +482,31 @@ TEST_CASE("last", "[logic][ltlf]") {
   REQUIRE(*actual_last == *expected_last);
 }
 
+TEST_CASE("comparison of interned formulas", "[logic][ltlf]") {
+  auto context = Context();
+  auto b = context.make_atom("b");
+  auto a = context.make_atom("a");
+  auto next_b = context.make_next(b);
+  auto next_a = context.make_next(a);
+
+  // same type: creation order
+  REQUIRE(*b < *a);
+  REQUIRE(*next_b < *next_a);
+  REQUIRE(next_a->compare(*next_a) == 0);
+  // different types: type order
+  REQUIRE(*a < *next_b);
+
+  SECTION("copies are compared structurally") {
+    auto other_context = Context();
+    auto other_next_tt = other_context.make_next(other_context.make_tt());
+    REQUIRE(*other_next_tt == *context.make_next(context.make_tt()));
+    REQUIRE(*other_next_tt != *next_b);
+    auto detached = std::make_shared<const LTLfNext>(context, a);
+    REQUIRE(*detached == *next_a);
+    REQUIRE(detached->compare(*next_a) == 0);
+  }
+}
+
 } // namespace Test
 } // namespace logic
 } // namespace nike
\ No newline at end of file
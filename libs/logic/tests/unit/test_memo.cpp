@@ -0,0 +1,106 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/duality.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/memo.hpp>
+#include <nike/logic/nnf.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("memo table", "[logic][memo]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto not_a = context.make_prop_not(a);
+  MemoTable table;
+  ltlf_ptr result;
+
+  REQUIRE(!table.find(*a, 0, result));
+  table.insert(*a, 0, not_a);
+  REQUIRE(table.find(*a, 0, result));
+  REQUIRE(result == not_a);
+  // the tag is part of the key
+  REQUIRE(!table.find(*a, 1, result));
+  REQUIRE(table.size() == 1);
+  REQUIRE(table.nb_hits() == 1);
+  REQUIRE(table.nb_misses() == 2);
+  REQUIRE(table.hit_rate() == Approx(1.0 / 3));
+
+  SECTION("bounded size") {
+    table.set_capacity(3);
+    REQUIRE(table.capacity() == 4);
+    REQUIRE(table.size() == 0);
+    for (int i = 0; i < 100; ++i) {
+      auto atom = context.make_atom("p" + std::to_string(i));
+      table.insert(*atom, 0, atom);
+    }
+    REQUIRE(table.size() <= 4);
+  }
+  SECTION("disabled") {
+    table.set_capacity(0);
+    table.insert(*b, 0, b);
+    REQUIRE(!table.find(*b, 0, result));
+    REQUIRE(table.size() == 0);
+  }
+  SECTION("cleared") {
+    table.clear();
+    table.reset_counts();
+    REQUIRE(!table.find(*a, 0, result));
+    REQUIRE(table.nb_misses() == 1);
+  }
+}
+
+TEST_CASE("negation normal form memoized in the context", "[logic][memo]") {
+  auto context = Context();
+  auto &table = context.memo_table(Transformation::nnf);
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto formula = context.make_not(context.make_until(
+      {a, context.make_not(context.make_and({a, b}))}));
+
+  auto expected = to_nnf(*formula);
+  REQUIRE(table.size() > 0);
+  auto nb_misses = table.nb_misses();
+  REQUIRE(to_nnf(*formula) == expected);
+  // one lookup for the whole formula
+  REQUIRE(table.nb_hits() == 1);
+  REQUIRE(table.nb_misses() == nb_misses);
+  // the negation shares the table, with the other polarity
+  REQUIRE(apply_negation(*formula) == to_nnf(*context.make_not(formula)));
+
+  SECTION("kept across garbage collections") {
+    formula = nullptr;
+    context.collect_garbage();
+    auto size = table.size();
+    REQUIRE(size > 0);
+    auto other = context.make_next(context.make_not(b));
+    REQUIRE(to_nnf(*other) == context.make_next(context.make_prop_not(b)));
+    REQUIRE(table.size() > size);
+  }
+  SECTION("emptied when the simplification is switched") {
+    context.set_simplification(true);
+    REQUIRE(table.size() == 0);
+  }
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,82 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/node_map.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("Interned nodes have dense ids", "[logic][node_map]") {
+  auto context = Context();
+  auto initial_ids = context.nb_ids();
+  auto a = context.make_atom("a");
+  auto not_a = context.make_not(a);
+  REQUIRE(a->has_id());
+  REQUIRE(not_a->id() == a->id() + 1);
+  REQUIRE(context.make_not(a)->id() == not_a->id());
+  REQUIRE(context.nb_ids() == not_a->id() + 1);
+  REQUIRE(a->id() >= initial_ids);
+
+  auto detached = std::make_shared<const LTLfAtom>(context, "b");
+  REQUIRE(!detached->has_id());
+}
+
+TEST_CASE("Node map", "[logic][node_map]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto a_and_b = context.make_and({a, b});
+  NodeMap<int> map(context);
+  REQUIRE(map.empty());
+  REQUIRE(map.find(*a) == nullptr);
+  map[*a] = 1;
+  map.insert_or_assign(*a_and_b, 2);
+  REQUIRE(map.size() == 2);
+  REQUIRE(*map.find(*a) == 1);
+  REQUIRE(map.contains(*a_and_b));
+  REQUIRE(!map.contains(*b));
+  REQUIRE(map[*b] == 0);
+  REQUIRE(map.size() == 3);
+  REQUIRE(map.erase(*a));
+  REQUIRE(!map.erase(*a));
+  REQUIRE(map.size() == 2);
+
+  auto detached = std::make_shared<const LTLfAtom>(context, "c");
+  REQUIRE(map.find(*detached) == nullptr);
+  REQUIRE_THROWS_AS(map[*detached], std::invalid_argument);
+}
+
+TEST_CASE("Node set", "[logic][node_map]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  NodeSet set(context);
+  REQUIRE(set.insert(*a));
+  REQUIRE(!set.insert(*a));
+  REQUIRE(set.contains(*a));
+  REQUIRE(!set.contains(*b));
+  REQUIRE(set.size() == 1);
+  REQUIRE(set.erase(*a));
+  REQUIRE(set.empty());
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
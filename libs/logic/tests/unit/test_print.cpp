@@ -0,0 +1,105 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/print.hpp>
+#include <sstream>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("streaming printer", "[logic][print]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto until = context.make_until({a, context.make_prop_not(b)});
+  auto formula = context.make_and(
+      {context.make_next(until), context.make_weak_next(until),
+       context.make_release({context.make_tt(), context.make_ff()}),
+       context.make_implies({context.make_prop_true(), b}),
+       context.make_equivalent({a, context.make_prop_false()}),
+       context.make_xor({a, b}), context.make_not(context.make_always(a)),
+       context.make_eventually(b), context.make_or({a, b})});
+
+  SECTION("same notation as the visitor") {
+    auto expected = PrintVisitor().apply(*formula);
+    REQUIRE(to_string(*formula) == expected);
+    std::ostringstream stream;
+    print(stream, *formula);
+    REQUIRE(stream.str() == expected);
+    std::string buffer = "f = ";
+    print(buffer, *formula);
+    REQUIRE(buffer == "f = " + expected);
+  }
+  SECTION("bounded size") {
+    PrintOptions options;
+    options.max_size = 10;
+    auto expected = PrintVisitor().apply(*formula).substr(0, 10) + "...";
+    REQUIRE(to_string(*formula, options) == expected);
+    options.max_size = 1000;
+    REQUIRE(to_string(*formula, options) == to_string(*formula));
+  }
+}
+
+TEST_CASE("shared subformulas are printed once", "[logic][print]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto until = context.make_until({a, b});
+  auto next = context.make_next(until);
+  auto formula = context.make_implies(
+      {context.make_until({until, next}), context.make_always(next)});
+  PrintOptions options;
+  options.share_subformulas = true;
+  REQUIRE(to_string(*formula, options) ==
+          "let s0 = (a) U (b), s1 = X[!](s0) in "
+          "((s0) U (s1)) -> (G(s1))");
+
+  SECTION("without sharing, the literals are printed in place") {
+    auto tree = context.make_and({a, context.make_next(a)});
+    REQUIRE(to_string(*tree, options) == to_string(*tree));
+  }
+  SECTION("a tree of 2^64 paths in linear size") {
+    auto dag = a;
+    for (int i = 0; i < 64; ++i) {
+      dag = context.make_until({dag, context.make_next(dag)});
+    }
+    REQUIRE(to_string(*dag, options).size() < 64 * 64);
+  }
+}
+
+TEST_CASE("printing a deep formula", "[logic][print]") {
+  auto context = Context();
+  auto formula = context.make_atom("a");
+  const size_t depth = 1000000;
+  for (size_t i = 0; i < depth; ++i) {
+    formula = context.make_weak_next(formula);
+  }
+  auto result = to_string(*formula);
+  REQUIRE(result.size() == 3 * depth + 1);
+  REQUIRE(result.substr(0, 6) == "X(X(X(");
+
+  PrintOptions options;
+  options.max_size = 8;
+  REQUIRE(to_string(*formula, options) == "X(X(X(X(...");
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
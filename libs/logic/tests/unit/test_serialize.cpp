@@ -0,0 +1,162 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <filesystem>
+#include <nike/logic/copy.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/serialize.hpp>
+#include <random>
+#include <sstream>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+namespace {
+vec_ptr round_trip(Context &context, const vec_ptr &roots) {
+  std::stringstream stream;
+  write_dag(stream, roots);
+  auto data = stream.str();
+  return read_dag(context, data.data(), data.size());
+}
+} // namespace
+
+TEST_CASE("round trip of a formula DAG", "[logic][serialize]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto not_a = context.make_prop_not(a);
+  auto until = context.make_until({a, context.make_or({b, not_a})});
+  auto formula = context.make_and(
+      {context.make_always(until), context.make_next(until),
+       context.make_weak_next(context.make_eventually(b)),
+       context.make_release({context.make_tt(), context.make_not(a)}),
+       context.make_xor({a, b}), context.make_implies({b, a}),
+       context.make_equivalent({not_a, context.make_prop_true()})});
+  auto other = context.make_eventually(until);
+
+  auto target = Context();
+  auto roots = round_trip(target, {formula, other, formula});
+  REQUIRE(roots.size() == 3);
+  REQUIRE(&roots[0]->ctx() == &target);
+  // the nodes are interned as if built by the factories
+  REQUIRE(copy_ltlf_formula(target, *formula) == roots[0]);
+  REQUIRE(copy_ltlf_formula(target, *other) == roots[1]);
+  REQUIRE(roots[2] == roots[0]);
+
+  SECTION("into the same context") {
+    auto same = round_trip(context, {formula, other});
+    REQUIRE(same[0] == formula);
+    REQUIRE(same[1] == other);
+  }
+}
+
+TEST_CASE("shared subformulas are written once", "[logic][serialize]") {
+  auto context = Context();
+  auto formula = context.make_atom("a");
+  for (int i = 0; i < 64; ++i) {
+    // a tree with 2^64 paths, but a DAG of 64 nodes
+    formula = context.make_until({formula, context.make_next(formula)});
+  }
+  std::stringstream stream;
+  write_dag(stream, {formula});
+  REQUIRE(stream.str().size() < 64 * 2 * 6 * sizeof(uint32_t));
+
+  auto target = Context();
+  auto data = stream.str();
+  auto roots = read_dag(target, data.data(), data.size());
+  REQUIRE(copy_ltlf_formula(target, *formula) == roots[0]);
+}
+
+TEST_CASE("round trip of a deep formula", "[logic][serialize]") {
+  auto context = Context();
+  auto formula = context.make_atom("a");
+  for (int i = 0; i < 100000; ++i) {
+    formula = context.make_next(formula);
+  }
+  auto target = Context();
+  auto roots = round_trip(target, {formula});
+  REQUIRE(target.nb_nodes() >= 100000);
+  REQUIRE(copy_ltlf_formula(context, *roots[0]) == formula);
+}
+
+TEST_CASE("the simplification is suspended while reading",
+          "[logic][serialize]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto formula = context.make_eventually(context.make_eventually(a));
+  auto target = Context();
+  target.set_simplification(true);
+  auto roots = round_trip(target, {formula});
+  REQUIRE(is_a<LTLfEventually>(
+      *static_cast<const LTLfEventually &>(*roots[0]).arg));
+  REQUIRE(target.is_simplifying());
+  REQUIRE(target.simplification_stats().total() == 0);
+}
+
+TEST_CASE("round trip through a mapped file", "[logic][serialize]") {
+  auto context = Context();
+  auto formula = context.make_always(context.make_or(
+      {context.make_atom("request"), context.make_atom("grant")}));
+  // a unique name, so that concurrent runs do not share the file
+  auto name =
+      "nike_test_serialize_" + std::to_string(std::random_device()()) + ".dag";
+  auto filename = (std::filesystem::temp_directory_path() / name).string();
+  write_dag_to_file(filename, {formula});
+  auto target = Context();
+  auto roots = read_dag_from_file(target, filename);
+  std::filesystem::remove(filename);
+  REQUIRE(copy_ltlf_formula(target, *formula) == roots[0]);
+  REQUIRE_THROWS_AS(read_dag_from_file(target, filename), std::runtime_error);
+}
+
+TEST_CASE("malformed formula DAGs", "[logic][serialize]") {
+  auto context = Context();
+  auto formula = context.make_next(context.make_atom("a"));
+  std::stringstream stream;
+  write_dag(stream, {formula});
+  auto data = stream.str();
+  auto target = Context();
+
+  SECTION("truncated") {
+    REQUIRE_THROWS_AS(read_dag(target, data.data(), data.size() - 4),
+                      std::runtime_error);
+  }
+  SECTION("bad magic") {
+    data[0] = 'X';
+    REQUIRE_THROWS_AS(read_dag(target, data.data(), data.size()),
+                      std::runtime_error);
+  }
+  SECTION("unsupported version") {
+    data[8] = static_cast<char>(dag_format_version + 1);
+    REQUIRE_THROWS_AS(read_dag(target, data.data(), data.size()),
+                      std::runtime_error);
+  }
+  SECTION("counts larger than the data") {
+    // the number of nodes
+    for (size_t i = 16; i < 20; ++i) {
+      data[i] = '\xff';
+    }
+    REQUIRE_THROWS_AS(read_dag(target, data.data(), data.size()),
+                      std::runtime_error);
+  }
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/simplify.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+TEST_CASE("simplification is off by default", "[logic][simplify]") {
+  auto context = Context();
+  REQUIRE(!context.is_simplifying());
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto absorbed = context.make_and({a, context.make_or({a, b})});
+  REQUIRE(absorbed != a);
+  REQUIRE(context.simplification_stats().total() == 0);
+
+  // the pass applies the rules anyway
+  REQUIRE(simplify(*absorbed) == a);
+  REQUIRE(context.simplification_stats().count(
+              SimplificationRule::absorption) == 1);
+}
+
+TEST_CASE("rewrite rules in the factories", "[logic][simplify]") {
+  auto context = Context();
+  context.set_simplification(true);
+  auto &stats = context.simplification_stats();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto not_a = context.make_prop_not(a);
+  auto tt = context.make_tt();
+  auto ff = context.make_ff();
+
+  SECTION("absorption") {
+    REQUIRE(context.make_and({a, context.make_or({a, b})}) == a);
+    REQUIRE(context.make_or({a, context.make_and({a, b})}) == a);
+    REQUIRE(stats.count(SimplificationRule::absorption) == 2);
+  }
+  SECTION("complementary literals") {
+    REQUIRE(context.make_and({a, b, not_a}) == ff);
+    REQUIRE(context.make_or({a, not_a}) == context.make_prop_true());
+    REQUIRE(context.make_or({a, b, not_a}) ==
+            context.make_or({b, context.make_prop_true()}));
+    REQUIRE(stats.count(SimplificationRule::complementary_literals) == 3);
+  }
+  SECTION("idempotent temporal operators") {
+    auto eventually_a = context.make_eventually(a);
+    REQUIRE(context.make_eventually(eventually_a) == eventually_a);
+    auto always_a = context.make_always(a);
+    REQUIRE(context.make_always(always_a) == always_a);
+    // the next operators are not idempotent
+    auto next_a = context.make_next(a);
+    REQUIRE(context.make_next(next_a) != next_a);
+    REQUIRE(stats.count(SimplificationRule::idempotent_temporal) == 2);
+  }
+  SECTION("temporal operators of constants") {
+    REQUIRE(context.make_eventually(ff) == ff);
+    REQUIRE(context.make_always(tt) == tt);
+    REQUIRE(context.make_next(ff) == ff);
+    REQUIRE(context.make_weak_next(tt) == tt);
+    // X tt requires a next instant; F tt, G ff and X[!] ff are end markers
+    REQUIRE(context.make_next(tt) != tt);
+    REQUIRE(context.make_eventually(tt) == context.make_not_end());
+    REQUIRE(context.make_always(ff) == context.make_end());
+    REQUIRE(context.make_weak_next(ff) == context.make_last());
+    REQUIRE(stats.count(SimplificationRule::temporal_constant) == 4);
+  }
+  SECTION("next distribution is left to the pass") {
+    // it would build temporal subformulas the formula did not have
+    auto next_a = context.make_next(a);
+    auto next_b = context.make_next(b);
+    auto conjunction = context.make_and({next_a, next_b});
+    REQUIRE(is_a<LTLfAnd>(*conjunction));
+    REQUIRE(stats.count(SimplificationRule::next_distribution) == 0);
+    REQUIRE(simplify(*conjunction) ==
+            context.make_next(context.make_and({a, b})));
+    REQUIRE(simplify(*context.make_or({next_a, next_b, a})) ==
+            context.make_or({a, context.make_next(context.make_or({a, b}))}));
+    auto weak_next_a = context.make_weak_next(a);
+    auto weak_next_b = context.make_weak_next(b);
+    REQUIRE(simplify(*context.make_and({weak_next_a, weak_next_b, next_a})) ==
+            context.make_and(
+                {next_a, context.make_weak_next(context.make_and({a, b}))}));
+    REQUIRE(stats.count(SimplificationRule::next_distribution) == 3);
+  }
+
+  stats.reset();
+  REQUIRE(stats.total() == 0);
+}
+
+TEST_CASE("simplification of a whole formula", "[logic][simplify]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  // G G (X a & X (a | b)) | F ff
+  auto conjunction = context.make_and(
+      {context.make_next(a), context.make_next(context.make_or({a, b}))});
+  auto formula = context.make_or(
+      {context.make_always(context.make_always(conjunction)),
+       context.make_eventually(context.make_ff())});
+
+  // X a & X(a | b) = X(a & (a | b)) = X a
+  auto expected = context.make_always(context.make_next(a));
+  REQUIRE(simplify(*formula) == expected);
+  REQUIRE(context.simplification_stats().total() == 4);
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
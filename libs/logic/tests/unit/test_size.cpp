@@ -134,6 +134,32 @@ TEST_CASE("last size", "[logic][ltlf][size]") {
   REQUIRE(size(*last_formula) == 2);
 }
 
+TEST_CASE("size of a shared DAG", "[logic][ltlf][size]") {
+  auto context = Context();
+  ltlf_ptr formula = context.make_atom("a");
+  size_t expected = 1;
+  for (int i = 0; i < 40; ++i) {
+    formula = context.make_or(
+        vec_ptr{context.make_next(formula), context.make_weak_next(formula)});
+    expected = 3 + 2 * expected;
+  }
+  // counted as a tree, computed once per node
+  REQUIRE(size(*formula) == expected);
+
+  SizeVisitor visitor;
+  REQUIRE(visitor.apply(*formula) == expected);
+  auto nb_cached = visitor.nb_cached();
+  REQUIRE(nb_cached == 1 + 3 * 40);
+  REQUIRE(visitor.apply(*context.make_next(formula)) == expected + 1);
+  REQUIRE(visitor.nb_cached() == nb_cached + 1);
+
+  for (int i = 0; i < 30; ++i) {
+    formula = context.make_or(
+        vec_ptr{context.make_next(formula), context.make_weak_next(formula)});
+  }
+  REQUIRE(size(*formula) == SIZE_MAX);
+}
+
 } // namespace Test
 } // namespace logic
 } // namespace nike
\ No newline at end of file
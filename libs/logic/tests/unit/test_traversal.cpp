@@ -0,0 +1,81 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/atom_set.hpp>
+#include <nike/logic/atom_visitor.hpp>
+#include <nike/logic/copy.hpp>
+#include <nike/logic/duality.hpp>
+#include <nike/logic/ltlf.hpp>
+#include <nike/logic/nnf.hpp>
+#include <nike/logic/size.hpp>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+namespace {
+const size_t deep = 1000000;
+
+/// !(X !(X ... !a)), with depth Not and depth Next
+ltlf_ptr deep_chain(Context &context, size_t depth) {
+  ltlf_ptr formula = context.make_atom("a");
+  for (size_t i = 0; i < depth; ++i) {
+    formula = context.make_not(context.make_next(formula));
+  }
+  return formula;
+}
+} // namespace
+
+TEST_CASE("passes on a deep formula", "[logic][ltlf][traversal]") {
+  auto context = Context();
+  auto formula = deep_chain(context, deep);
+
+  auto nnf = to_nnf(*formula);
+  // the negations alternate between Next and WeakNext
+  const LTLfFormula *current = nnf.get();
+  for (size_t i = 0; i < deep; ++i) {
+    REQUIRE(current->type_code() ==
+            (i % 2 == 0 ? TypeID::t_LTLfWeakNext : TypeID::t_LTLfNext));
+    current = static_cast<const LTLfUnaryOp *>(current)->arg.get();
+  }
+  REQUIRE(current->type_code() == TypeID::t_LTLfAtom);
+  REQUIRE(size(*nnf) == deep + 1);
+  REQUIRE(copy_ltlf_formula(*nnf) == nnf);
+  auto negation = apply_negation(*nnf);
+  REQUIRE(negation->type_code() == TypeID::t_LTLfNext);
+  REQUIRE(to_nnf(*negation) == negation);
+
+  REQUIRE(find_atoms(*formula).size() == 1);
+  REQUIRE(find_atom_set(*formula).size() == 1);
+}
+
+TEST_CASE("traversal after an exception", "[logic][ltlf][traversal]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto formula = context.make_and(
+      vec_ptr{context.make_next(a), context.make_not(context.make_atom("b"))});
+
+  SizeVisitor visitor;
+  REQUIRE_THROWS(visitor.apply(*formula));
+  // the stacks are left clean: the visitor can be applied again
+  REQUIRE(visitor.apply(*context.make_next(a)) == 2);
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -0,0 +1,74 @@
+/*
+ * This file is part of Nike.
+ *
+ * Nike is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Nike is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch.hpp>
+#include <nike/logic/type_switch.hpp>
+#include <type_traits>
+
+namespace nike {
+namespace logic {
+namespace Test {
+
+namespace {
+/// arity of the connective, LTLf formulas only
+class ArityVisitor : public TypeSwitchVisitor<ArityVisitor, size_t> {
+public:
+  template <typename T> size_t visit(const T &formula) {
+    if constexpr (std::is_base_of<LTLfBinaryOp, T>::value) {
+      return formula.args.size();
+    } else if constexpr (std::is_base_of<LTLfUnaryOp, T>::value) {
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+};
+} // namespace
+
+TEST_CASE("Dispatch on the type code", "[logic][type_switch]") {
+  auto context = Context();
+  auto a = context.make_atom("a");
+  auto b = context.make_atom("b");
+  auto c = context.make_atom("c");
+
+  auto visitor = ArityVisitor{};
+  REQUIRE(visitor.apply(*a) == 0);
+  REQUIRE(visitor.apply(*context.make_tt()) == 0);
+  REQUIRE(visitor.apply(*context.make_next(a)) == 1);
+  REQUIRE(visitor.apply(*context.make_until({a, b})) == 2);
+  REQUIRE(visitor.apply(*context.make_and({a, b, c})) == 3);
+
+  auto is_literal = [](const auto &formula) {
+    using T = std::decay_t<decltype(formula)>;
+    return std::is_same<T, PLLiteral>::value;
+  };
+  auto literal = context.make_literal(context.make_string_symbol("a"), true);
+  auto other = context.make_literal(context.make_string_symbol("b"), false);
+  REQUIRE(dispatch(*literal, is_literal));
+  REQUIRE(!dispatch(*context.make_prop_and({literal, other}), is_literal));
+}
+
+TEST_CASE("Type code of detached nodes", "[logic][type_switch]") {
+  auto context = Context();
+  auto detached = std::make_shared<const LTLfAtom>(context, "a");
+  REQUIRE(detached->type_code() == TypeID::t_LTLfAtom);
+  REQUIRE(context.make_atom("a")->type_code() == TypeID::t_LTLfAtom);
+}
+
+} // namespace Test
+} // namespace logic
+} // namespace nike
@@ -75,6 +75,9 @@ public:
                               const logic::ltlf_ptr &rhs) const;
   logic::ltlf_ptr add_LTLfOr(const logic::ltlf_ptr &lhs,
                              const logic::ltlf_ptr &rhs) const;
+  /// the conjunction or disjunction of a chain of operands, built at once
+  logic::ltlf_ptr add_LTLfAnd(const logic::vec_ptr &args) const;
+  logic::ltlf_ptr add_LTLfOr(const logic::vec_ptr &args) const;
   logic::ltlf_ptr add_LTLfEquivalent(const logic::ltlf_ptr &lhs,
                                      const logic::ltlf_ptr &rhs) const;
   logic::ltlf_ptr add_LTLfImplies(const logic::ltlf_ptr &lhs,
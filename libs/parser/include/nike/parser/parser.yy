@@ -52,6 +52,7 @@ namespace nike::parser::ltlf {
 %define api.value.type {struct nike::parser::ltlf::LTLf_YYSTYPE}
 
 %type<formula> input ltlf_formula
+%type<formulas> conjunction disjunction
 %type<symbol_name> SYMBOL
 
 %token                  LPAR
@@ -69,7 +70,9 @@ namespace nike::parser::ltlf {
 %right                  EQUIVALENCE
 %right                  IMPLICATION
 %right                  XOR
+%left                   DISJUNCTION
 %left                   OR
+%left                   CONJUNCTION
 %left                   AND
 %left                   UNTIL
 %left                   RELEASE
@@ -92,8 +95,8 @@ input: ltlf_formula
 ltlf_formula: ltlf_formula EQUIVALENCE ltlf_formula                                     { $$ = d.add_LTLfEquivalent($1, $3); }
             | ltlf_formula IMPLICATION ltlf_formula                                     { $$ = d.add_LTLfImplies($1, $3); }
             | ltlf_formula XOR ltlf_formula                                             { $$ = d.add_LTLfXor($1, $3); }
-            | ltlf_formula OR ltlf_formula                                              { $$ = d.add_LTLfOr($1, $3); }
-            | ltlf_formula AND ltlf_formula                                             { $$ = d.add_LTLfAnd($1, $3); }
+            | disjunction %prec DISJUNCTION                                             { $$ = d.add_LTLfOr(*$1); }
+            | conjunction %prec CONJUNCTION                                             { $$ = d.add_LTLfAnd(*$1); }
             | ltlf_formula RELEASE ltlf_formula                                         { $$ = d.add_LTLfRelease($1, $3); }
             | ltlf_formula UNTIL ltlf_formula                                           { $$ = d.add_LTLfUntil($1, $3); }
             | ALWAYS ltlf_formula                                                       { $$ = d.add_LTLfAlways($2); }
@@ -112,6 +115,15 @@ ltlf_formula: ltlf_formula EQUIVALENCE ltlf_formula
 
 ltlf_formula: LPAR ltlf_formula RPAR                                                    { $$ = $2; };
 
+/* chains of conjunctions and disjunctions are built at once, not pairwise */
+conjunction: ltlf_formula AND ltlf_formula                                              { $$ = std::make_shared<logic::vec_ptr>(logic::vec_ptr{$1, $3}); }
+           | conjunction AND ltlf_formula                                               { $$ = $1; $$->push_back($3); }
+           ;
+
+disjunction: ltlf_formula OR ltlf_formula                                               { $$ = std::make_shared<logic::vec_ptr>(logic::vec_ptr{$1, $3}); }
+           | disjunction OR ltlf_formula                                                { $$ = $1; $$->push_back($3); }
+           ;
+
 %%
 
 void nike::parser::ltlf::LTLfParser::error(const location_type &l, const std::string &err_message) {
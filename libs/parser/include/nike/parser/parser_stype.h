@@ -16,7 +16,9 @@
  * along with Nike.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace nike {
 namespace parser {
@@ -24,6 +26,9 @@ namespace ltlf {
 
 struct LTLf_YYSTYPE {
   logic::ltlf_ptr formula;
+  // the operands of a chain of conjunctions or disjunctions, shared so that
+  // the parser does not copy them on each reduction
+  std::shared_ptr<logic::vec_ptr> formulas;
   std::string symbol_name;
 
   // Constructor
@@ -17,6 +17,7 @@
 
 #include <cassert>
 #include <fstream>
+#include <stdexcept>
 
 #include <nike/logic/ltlf.hpp>
 #include <nike/parser/driver.hpp>
@@ -36,7 +37,7 @@ void LTLfDriver::parse(const char *const filename) {
   assert(filename != nullptr);
   std::ifstream in_file(filename);
   if (!in_file.good()) {
-    exit(EXIT_FAILURE);
+    throw std::runtime_error("cannot open file " + std::string(filename));
   }
   parse_helper(in_file);
 }
@@ -67,8 +68,7 @@ void LTLfDriver::parse_helper(std::istream &stream) {
   }
   const int accept(0);
   if (parser->parse() != accept) {
-    std::cerr << "Parse failed!\n";
-    exit(EXIT_FAILURE);
+    throw std::runtime_error("parse failed");
   }
 }
 
@@ -110,6 +110,14 @@ logic::ltlf_ptr LTLfDriver::add_LTLfOr(const logic::ltlf_ptr &lhs,
   return context->make_or(logic::vec_ptr{lhs, rhs});
 }
 
+logic::ltlf_ptr LTLfDriver::add_LTLfAnd(const logic::vec_ptr &args) const {
+  return context->make_and(args);
+}
+
+logic::ltlf_ptr LTLfDriver::add_LTLfOr(const logic::vec_ptr &args) const {
+  return context->make_or(args);
+}
+
 logic::ltlf_ptr LTLfDriver::add_LTLfImplies(const logic::ltlf_ptr &lhs,
                                             const logic::ltlf_ptr &rhs) const {
   return context->make_implies(logic::vec_ptr{lhs, rhs});
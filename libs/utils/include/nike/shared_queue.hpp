@@ -30,6 +30,8 @@ public:
 
   T &front();
   void pop_front();
+  bool try_pop_front(T &item);
+  void wait_pop_front(T &item);
 
   void push_back(const T &item);
   void push_back(T &&item);
@@ -63,6 +65,25 @@ template <typename T> void SharedQueue<T>::pop_front() {
   queue_.pop_front();
 }
 
+template <typename T> bool SharedQueue<T>::try_pop_front(T &item) {
+  std::unique_lock<std::mutex> mlock(mutex_);
+  if (queue_.empty()) {
+    return false;
+  }
+  item = std::move(queue_.front());
+  queue_.pop_front();
+  return true;
+}
+
+template <typename T> void SharedQueue<T>::wait_pop_front(T &item) {
+  std::unique_lock<std::mutex> mlock(mutex_);
+  while (queue_.empty()) {
+    cond_.wait(mlock);
+  }
+  item = std::move(queue_.front());
+  queue_.pop_front();
+}
+
 template <typename T> void SharedQueue<T>::push_back(const T &item) {
   std::unique_lock<std::mutex> mlock(mutex_);
   queue_.push_back(item);
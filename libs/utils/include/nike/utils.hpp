@@ -17,11 +17,15 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cuddObj.hh>
+#include <exception>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace nike {
@@ -129,7 +133,7 @@ template <typename T, typename Equal = std::equal_to<T>,
           typename Less = std::less<T>>
 std::vector<T> setify(std::vector<T> vec) {
   if (!std::is_sorted(vec.begin(), vec.end(), Less())) {
-    std::sort(vec.begin(), vec.end());
+    std::sort(vec.begin(), vec.end(), Less());
   }
   auto last = std::unique(vec.begin(), vec.end(), Equal());
   vec.erase(last, vec.end());
@@ -152,7 +156,8 @@ from_index_map_to_vector(const std::map<T, size_t, C> &from_element_to_id) {
 }
 
 template <typename T, typename Comparator>
-int binary_search_find_index(std::vector<T> v, T data, Comparator compare) {
+int binary_search_find_index(const std::vector<T> &v, const T &data,
+                             Comparator compare) {
   auto it = std::lower_bound(v.begin(), v.end(), data, compare);
   if (it == v.end() || *it != data) {
     return -1;
@@ -186,6 +191,47 @@ template <class T> inline int ordered_compare(const T &A, const T &B) {
   return 0;
 }
 
+/**
+ * \brief Call f(i) for every i in [0, n), on up to nb_threads threads.
+ *
+ * Indices are handed out dynamically, so uneven work items are balanced.
+ * The calling thread takes part in the work. If some call throws, the
+ * remaining indices are skipped and the first exception is rethrown.
+ */
+template <typename Function>
+void parallel_for(size_t n, size_t nb_threads, Function f) {
+  nb_threads = std::max<size_t>(1, std::min(nb_threads, n));
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    size_t i;
+    while ((i = next++) < n) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = n;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(nb_threads - 1);
+  for (size_t t = 1; t < nb_threads; ++t) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto &t : threads) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 void dump_bdd(CUDD::Cudd &manager, const std::vector<CUDD::BDD> &nodes,
               std::vector<std::string> &inames,
               std::vector<std::string> &onames, FILE *fp);